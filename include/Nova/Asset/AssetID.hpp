@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Nova/Misc/Hash.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace Nova
+{
+    // Asset name hashed with FNV-1a. "player"_asset is hashed at compile time, names only known at runtime go through
+    // the string_view constructor. The AssetManager refuses to register a name whose ID is already taken by another.
+    struct AssetID
+    {
+        uint64_t Hash = 0;
+
+        constexpr AssetID() = default;
+        constexpr explicit AssetID(uint64_t hash) : Hash(hash) {}
+        constexpr explicit AssetID(std::string_view name) : Hash(HashFNV1a(name)) {}
+
+        constexpr bool operator==(const AssetID& other) const noexcept = default;
+    };
+
+    // the ID is a hash already
+    struct AssetIDHash
+    {
+        size_t operator()(AssetID id) const noexcept
+        {
+            return (size_t) id.Hash;
+        }
+    };
+
+    inline namespace Literals
+    {
+        consteval AssetID operator""_asset(const char* name, size_t length)
+        {
+            return AssetID(std::string_view(name, length));
+        }
+    } // namespace Literals
+} // namespace Nova
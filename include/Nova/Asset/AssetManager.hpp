@@ -1,13 +1,20 @@
 #pragma once
 
 #include "Nova/Asset/Assets.hpp"
-#include "Nova/Misc/StringHash.hpp"
+#include "Nova/Asset/AssetPak.hpp"
 
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <filesystem>
 #include <unordered_map>
+#include <vector>
 
 namespace Nova
 {
@@ -22,25 +29,221 @@ namespace Nova
         AssetManager& operator=(AssetManager&&) = delete;
 
         void Shutdown();
+
+        // Files under root are read from the pak before falling back to the disk, for every loader.
+        // LoadFromDirectory mounts <directory>.novapak by itself when it exists, and lists the assets from it.
+        bool MountPak(const std::filesystem::path& pakPath, const std::filesystem::path& root);
+
         void LoadFromDirectory(const std::filesystem::path& path);
+        void LoadFromDirectoryAsync(const std::filesystem::path& path, AssetPriority priority = AssetPriority::Normal);
 
         void LoadTexture(const std::string_view& name, const std::filesystem::path& path);
         void LoadShader(const std::string_view& name, const std::filesystem::path& fragmentPath);
         void LoadSound(const std::string_view& name, const std::filesystem::path& path);
         void LoadMusic(const std::string_view& name, const std::filesystem::path& path);
 
+        // Async loads return right away, file I/O and decoding run on the job system workers and the GL/audio side
+        // is finished on the main thread by Update, textures are then streamed by the TextureUploader. Until then
+        // the handle behaves like its placeholder (or like an empty handle without one).
+        // Loading an already loaded name returns the existing handle.
+        TextureAsset LoadTextureAsync(const std::string_view& name, const std::filesystem::path& path,
+                                      AssetPriority priority = AssetPriority::Normal, TextureAsset placeholder = {});
+        ShaderAsset LoadShaderAsync(const std::string_view& name, const std::filesystem::path& fragmentPath,
+                                    AssetPriority priority = AssetPriority::Normal, ShaderAsset placeholder = {});
+        SoundAsset LoadSoundAsync(const std::string_view& name, const std::filesystem::path& path,
+                                  AssetPriority priority = AssetPriority::Normal, SoundAsset placeholder = {});
+        MusicAsset LoadMusicAsync(const std::string_view& name, const std::filesystem::path& path,
+                                  AssetPriority priority = AssetPriority::Normal, MusicAsset placeholder = {});
+
+        // Finishes decoded async loads on the main thread, stopping once budgetMs is spent. Called by App every frame.
+        void Update(float budgetMs = 2.0f);
+
+        // loads that haven't finished yet, for loading screens
+        uint32_t GetPendingLoadCount() const;
+
+        // Cancels the async loads no worker has started yet, so they're skipped without reading their file, and
+        // dropped on the next Update like any cancelled load. Called by App before the job system stops.
+        void CancelPendingLoads();
+
+        // Main thread only, evicted assets are reloaded synchronously from their file.
         TextureAsset GetTexture(const std::string_view& name);
         ShaderAsset GetShader(const std::string_view& name);
         SoundAsset GetSound(const std::string_view& name);
         MusicAsset GetMusic(const std::string_view& name);
 
+        TextureAsset GetTexture(AssetID id);
+        ShaderAsset GetShader(AssetID id);
+        SoundAsset GetSound(AssetID id);
+        MusicAsset GetMusic(AssetID id);
+
+        // Refs skip the ID lookup, meant to be resolved once and kept around (an invalid ref when id isn't loaded).
+        // The returned handle is owned by the AssetManager and invalidated by the next load of the same type.
+        TextureRef GetTextureRef(AssetID id) const;
+        ShaderRef GetShaderRef(AssetID id) const;
+        SoundRef GetSoundRef(AssetID id) const;
+        MusicRef GetMusicRef(AssetID id) const;
+
+        const TextureAsset& GetTexture(TextureRef ref);
+        const ShaderAsset& GetShader(ShaderRef ref);
+        const SoundAsset& GetSound(SoundRef ref);
+        const MusicAsset& GetMusic(MusicRef ref);
+
+        // Lock-free lookups safe from any thread, they see the assets as of the last Load or Update on the main
+        // thread. Evicted assets aren't reloaded (the handle is empty) and the lookup doesn't count as a use.
+        TextureAsset FindTexture(const std::string_view& name) const;
+        ShaderAsset FindShader(const std::string_view& name) const;
+        SoundAsset FindSound(const std::string_view& name) const;
+        MusicAsset FindMusic(const std::string_view& name) const;
+
+        TextureAsset FindTexture(AssetID id) const;
+        ShaderAsset FindShader(AssetID id) const;
+        SoundAsset FindSound(AssetID id) const;
+        MusicAsset FindMusic(AssetID id) const;
+
+        // When the resident assets of a type go over its memory budget, Update evicts the least recently used ones
+        // that aren't pinned nor referenced outside the AssetManager, the next Get reloads them.
+        // A budget of 0 (the default) never evicts.
+        void SetMemoryBudget(AssetType type, uint64_t bytes);
+        uint64_t GetMemoryBudget(AssetType type) const;
+        uint64_t GetMemoryUsage(AssetType type) const;
+
+        void SetPinned(AssetType type, const std::string_view& name, bool pinned = true);
+        AssetResidency GetResidency(AssetType type, const std::string_view& name) const;
+
     private:
+        using LoadCompletion = std::function<void(bool success)>;
+
+        struct AsyncLoad
+        {
+            AssetPriority Priority = AssetPriority::Normal;
+            uint64_t Order = 0;
+            bool Decoded = false;
+            uint64_t ContentHash = 0;
+            std::filesystem::path Path;
+            std::shared_ptr<AssetLoadStatus> Status;
+            std::function<bool(AssetBytes&)> Decode;    // worker thread
+            std::function<void(LoadCompletion)> Finish; // main thread, completes now or on a later frame
+            std::function<void(bool success, uint64_t contentHash)> Resolve; // main thread, records or drops the asset
+            // main thread, before Finish, shares a loaded asset of the same content instead when there's one
+            std::function<bool(uint64_t contentHash)> Share;
+        };
+
+        template<typename T>
+        struct AssetEntry
+        {
+            std::string Name;      // empty for free slots
+            AssetHandle<T> Handle; // empty when evicted or aliased
+            std::filesystem::path Path;
+            uint32_t Generation = 0;
+            uint32_t Alias = INVALID_ASSET_INDEX; // entry with the same file content, which holds the asset
+            uint64_t ContentHash = 0;
+            AssetResidency Residency;
+        };
+
+        // what other threads see of an entry, aliases are resolved
+        template<typename T>
+        struct AssetSnapshotEntry
+        {
+            std::string Name;
+            std::weak_ptr<T> Asset; // doesn't keep the asset from being evicted
+            std::shared_ptr<T> Placeholder;
+            std::shared_ptr<AssetLoadStatus> Status;
+        };
+
+        // immutable once published, replaced as a whole and freed through Epoch
+        template<typename T>
+        struct AssetSnapshot
+        {
+            std::vector<AssetSnapshotEntry<T>> Entries;
+            std::unordered_map<AssetID, uint32_t, AssetIDHash> Indices;
+        };
+
+        // Entries of a type in a flat array indexed by refs, the map is only used to turn IDs into indices.
+        // Released slots are reused with a bumped generation.
+        template<typename T>
+        struct AssetTable
+        {
+            std::vector<AssetEntry<T>> Entries;
+            std::vector<uint32_t> FreeIndices;
+            std::unordered_map<AssetID, uint32_t, AssetIDHash> Indices;
+
+            bool Dirty = false; // changed since the last snapshot
+            std::atomic<const AssetSnapshot<T>*> Snapshot = nullptr;
+        };
+
+        struct MountedPak
+        {
+            std::filesystem::path Root;
+            std::shared_ptr<const AssetPak> Pak;
+        };
+
+        std::shared_ptr<const AssetPak> MountDirectoryPak(const std::filesystem::path& directory);
+        bool ReadAsset(const std::filesystem::path& path, AssetBytes& bytes) const;
+
+        // INVALID_ASSET_INDEX when the name or its ID is taken
+        template<typename T>
+        uint32_t RegisterAsset(AssetTable<T>& table, const std::string_view& name);
+
         template<typename T>
-        using AssetContainer = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
+        void ReleaseAsset(AssetTable<T>& table, uint32_t index);
+
+        template<typename T>
+        void LoadAsset(AssetTable<T>& table, uint32_t index, const std::filesystem::path& path);
+
+        template<typename T>
+        const AssetHandle<T>& ResolveAsset(AssetTable<T>& table, uint32_t index);
+
+        template<typename T>
+        AssetHandle<T> GetAsset(AssetTable<T>& table, AssetID id, const std::string_view& name = {});
+
+        template<typename T>
+        const AssetHandle<T>& GetAsset(AssetTable<T>& table, AssetRef<T> ref);
+
+        template<typename T>
+        static AssetRef<T> GetAssetRef(const AssetTable<T>& table, AssetID id);
+
+        template<typename T>
+        static AssetHandle<T> FindAsset(const AssetTable<T>& table, AssetID id, const std::string_view& name = {});
+
+        template<typename T>
+        static void PublishTable(AssetTable<T>& table);
+
+        template<typename T>
+        static void ClearTable(AssetTable<T>& table);
+
+        void PublishTables();
+
+        template<typename T>
+        AssetHandle<T> BeginAsyncLoad(AssetTable<T>& table, const std::string_view& name,
+                                      const std::filesystem::path& path, AssetPriority priority,
+                                      AssetHandle<T> placeholder, std::function<bool(AssetBytes&)> decode,
+                                      std::function<void(const std::shared_ptr<T>&, LoadCompletion)> finish);
+
+        template<typename T>
+        void UpdateResidency(AssetTable<T>& table, AssetType type);
+
+        template<typename Self, typename Fn>
+        static decltype(auto) VisitTable(Self& self, AssetType type, Fn&& fn);
+
+        void RunNextLoad();
+        void CompleteLoad(const std::shared_ptr<AsyncLoad>& load, bool success);
+
+    private:
+        AssetTable<Texture> m_Textures;
+        AssetTable<Shader> m_Shaders;
+        AssetTable<Sound> m_Sounds;
+        AssetTable<Music> m_Musics;
+
+        mutable std::mutex m_PakMutex;
+        std::vector<MountedPak> m_Paks;
+
+        uint64_t m_Frame = 0;
+        std::array<uint64_t, 4> m_MemoryBudgets = {};
 
-        AssetContainer<TextureAsset> m_Textures;
-        AssetContainer<ShaderAsset> m_Shaders;
-        AssetContainer<SoundAsset> m_Sounds;
-        AssetContainer<MusicAsset> m_Musics;
+        mutable std::mutex m_LoadMutex;
+        uint64_t m_LoadCounter = 0;
+        uint32_t m_InFlightLoads = 0;
+        std::vector<std::shared_ptr<AsyncLoad>> m_QueuedLoads; // heap, highest priority first
+        std::deque<std::shared_ptr<AsyncLoad>> m_DecodedLoads;
     };
 } // namespace Nova
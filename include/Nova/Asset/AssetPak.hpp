@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Nova/Misc/MappedFile.hpp"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// .novapak archives pack the files of an asset directory into a single file that is read through one mapping.
+// A file is an AssetPakHeader, EntryCount AssetPakEntry sorted by NameHash, the name table and the data of each
+// entry (16 byte aligned). Names are paths relative to the packed directory, with '/' separators.
+// Entries are stored as is or LZ4 compressed (see nova_pak).
+namespace Nova
+{
+    static constexpr std::array<char, 4> ASSET_PAK_MAGIC = {'N', 'P', 'A', 'K'};
+    static constexpr uint32_t ASSET_PAK_VERSION = 1;
+
+    enum class AssetPakCompression : uint8_t
+    {
+        None,
+        LZ4
+    };
+
+    struct AssetPakHeader
+    {
+        std::array<char, 4> Magic;
+        uint32_t Version;
+        uint32_t EntryCount;
+        uint32_t NamesSize;
+    };
+
+    struct AssetPakEntry
+    {
+        uint64_t NameHash; // HashFNV1a of the name
+        uint64_t Offset;   // from the start of the file
+        uint64_t StoredSize;
+        uint64_t Size;
+        uint32_t NameOffset; // into the name table
+        uint16_t NameLength;
+        AssetPakCompression Compression;
+        uint8_t Reserved;
+    };
+
+    class AssetPak
+    {
+    public:
+        AssetPak() = default;
+
+        AssetPak(const AssetPak&) = delete;
+        AssetPak& operator=(const AssetPak&) = delete;
+
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        bool IsOpen() const noexcept
+        {
+            return m_File.IsOpen();
+        }
+
+        std::span<const AssetPakEntry> GetEntries() const noexcept
+        {
+            return m_Entries;
+        }
+
+        // binary search on the name hash, nullptr if the pak has no such file
+        const AssetPakEntry* Find(std::string_view name) const;
+
+        std::string_view GetName(const AssetPakEntry& entry) const;
+
+        // Uncompressed entries are returned straight from the mapping, compressed ones are decompressed into storage.
+        // Returns an empty span if the entry is corrupted.
+        std::span<const uint8_t> Read(const AssetPakEntry& entry, std::vector<uint8_t>& storage) const;
+
+    private:
+        MappedFile m_File;
+        std::span<const AssetPakEntry> m_Entries;
+        std::string_view m_Names;
+    };
+
+    // Bytes of an asset file, read from a mounted pak or mapped from disk. Moving it keeps Data valid.
+    struct AssetBytes
+    {
+        std::span<const uint8_t> Data;
+
+        std::shared_ptr<const AssetPak> Pak; // keeps the mapping of zero-copy entries alive
+        std::vector<uint8_t> Storage;        // decompressed entries
+        MappedFile File;                     // loose files
+    };
+} // namespace Nova
@@ -4,11 +4,71 @@
 #include "Nova/Renderer/Shader.hpp"
 #include "Nova/Audio/Sound.hpp"
 #include "Nova/Audio/Music.hpp"
+#include "Nova/Asset/AssetID.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
 namespace Nova
 {
+    enum class AssetState : uint8_t
+    {
+        Loading,
+        Ready,
+        Failed,
+        Cancelled
+    };
+
+    enum class AssetPriority : uint8_t
+    {
+        Low,
+        Normal,
+        High,
+        Critical
+    };
+
+    enum class AssetType : uint8_t
+    {
+        Texture,
+        Shader,
+        Sound,
+        Music
+    };
+
+    struct AssetResidency
+    {
+        uint64_t MemorySize = 0; // estimated GPU or audio memory
+        uint64_t LastUsedFrame = 0;
+        bool Pinned = false;
+        bool Resident = false;
+    };
+
+    static constexpr uint32_t INVALID_ASSET_INDEX = UINT32_MAX;
+
+    // Slot in the AssetManager table of T, resolved with a single indexed load. The generation tells apart the asset
+    // the ref was taken for from a later one reusing its slot, stale refs resolve to an empty handle.
+    template<typename T>
+    struct AssetRef
+    {
+        uint32_t Index = INVALID_ASSET_INDEX;
+        uint32_t Generation = 0;
+
+        bool IsValid() const noexcept
+        {
+            return Index != INVALID_ASSET_INDEX;
+        }
+
+        bool operator==(const AssetRef& other) const noexcept = default;
+    };
+
+    // shared by every copy of a handle returned by an async load
+    struct AssetLoadStatus
+    {
+        std::atomic<AssetState> State = AssetState::Loading;
+        std::shared_ptr<void> Shared; // loaded asset with the same content, set before the state is Ready
+    };
+
     template<typename T>
     class AssetHandle
     {
@@ -16,20 +76,66 @@ namespace Nova
         AssetHandle() = default;
         AssetHandle(std::shared_ptr<T> asset) : Asset(asset) {}
 
+        AssetState GetState() const noexcept
+        {
+            if (Status)
+                return Status->State.load(std::memory_order_acquire);
+
+            return Asset ? AssetState::Ready : AssetState::Failed;
+        }
+
+        bool IsReady() const noexcept
+        {
+            return GetState() == AssetState::Ready;
+        }
+
+        bool IsLoading() const noexcept
+        {
+            return GetState() == AssetState::Loading;
+        }
+
+        // Stops a pending async load, the asset is dropped from the AssetManager on its next Update.
+        // Returns false if the load already finished.
+        bool Cancel() const noexcept
+        {
+            AssetState expected = AssetState::Loading;
+            return Status && Status->State.compare_exchange_strong(expected, AssetState::Cancelled);
+        }
+
+        // the asset once it's ready, the placeholder (if any) until then
+        std::shared_ptr<T> Get() const
+        {
+            if (!IsReady())
+                return Placeholder;
+
+            return (Status && Status->Shared) ? std::static_pointer_cast<T>(Status->Shared) : Asset;
+        }
+
         // clang-format off
-        operator bool() const { return (bool) Asset; }
-        operator std::shared_ptr<T>() const { return Asset; }
+        operator bool() const { return GetPointer() != nullptr; }
+        operator std::shared_ptr<T>() const { return Get(); }
 
-        T* operator->() const { return Asset.get(); }
+        T* operator->() const { return GetPointer(); }
 
-        T& operator*() const { return *Asset; }
+        T& operator*() const { return *GetPointer(); }
 
         bool operator==(const AssetHandle& other) const noexcept = default;
-        bool operator==(std::nullptr_t) const noexcept { return Asset == nullptr; }
+        bool operator==(std::nullptr_t) const noexcept { return GetPointer() == nullptr; }
         // clang-format on
 
+    private:
+        T* GetPointer() const noexcept
+        {
+            if (!IsReady())
+                return Placeholder.get();
+
+            return (Status && Status->Shared) ? static_cast<T*>(Status->Shared.get()) : Asset.get();
+        }
+
     private:
         std::shared_ptr<T> Asset;
+        std::shared_ptr<T> Placeholder;
+        std::shared_ptr<AssetLoadStatus> Status;
 
         friend class AssetManager;
     };
@@ -38,4 +144,9 @@ namespace Nova
     using ShaderAsset = AssetHandle<Shader>;
     using SoundAsset = AssetHandle<Sound>;
     using MusicAsset = AssetHandle<Music>;
+
+    using TextureRef = AssetRef<Texture>;
+    using ShaderRef = AssetRef<Shader>;
+    using SoundRef = AssetRef<Sound>;
+    using MusicRef = AssetRef<Music>;
 } // namespace Nova
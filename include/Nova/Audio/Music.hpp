@@ -1,7 +1,10 @@
 #pragma once
 
 #include <raudio.h>
+#include <cstdint>
 #include <filesystem>
+#include <string>
+#include <vector>
 
 namespace Nova
 {
@@ -17,6 +20,8 @@ namespace Nova
         Music& operator=(Music&& music) = delete;
 
         bool Init(const std::filesystem::path& path);
+        // streams from the encoded file in memory, fileType is the extension (".ogg", ".mp3", ...)
+        bool Init(std::vector<uint8_t> fileData, const std::string& fileType);
         void Shutdown() const;
 
         void Play() const;
@@ -35,7 +40,11 @@ namespace Nova
 
         bool IsPlaying() const;
 
+        // bytes of the encoded file kept in memory, the decoder buffers are not counted
+        uint64_t GetMemorySize() const;
+
     private:
         ::Music m_Music = {};
+        std::vector<uint8_t> m_FileData; // the decoder reads from it while streaming
     };
 } // namespace Nova
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <raudio.h>
+#include <cstdint>
 #include <filesystem>
 
 namespace Nova
@@ -17,6 +18,8 @@ namespace Nova
         Sound& operator=(Sound&& sound) = delete;
 
         bool Init(const std::filesystem::path& path);
+        // copies the samples, the wave can be unloaded afterwards
+        bool Init(const ::Wave& wave);
         void Shutdown() const;
 
         void Play() const;
@@ -30,6 +33,9 @@ namespace Nova
 
         bool IsPlaying() const;
 
+        // bytes of the decoded samples
+        uint64_t GetMemorySize() const;
+
     private:
         ::Sound m_Sound = {};
     };
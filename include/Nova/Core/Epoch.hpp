@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+// Epoch based reclamation for data that is read from any thread without locks and replaced by a single writer.
+// Readers wrap their accesses in a ReadGuard, the writer publishes a new version, retires the old one and frees it
+// with Collect once no reader that could've seen it is still inside a guard.
+namespace Nova::Epoch
+{
+    // each reading thread claims a slot on its first ReadGuard, from blocks of READER_BLOCK_SIZE that are added as
+    // more threads read at the same time
+    static constexpr uint32_t READER_BLOCK_SIZE = 64;
+
+    class ReadGuard
+    {
+    public:
+        ReadGuard();
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    };
+
+    // to be called right after the object was unpublished, free runs later on the thread calling Collect
+    void Retire(std::function<void()> free);
+
+    // runs the frees of the retired objects no reader can still see
+    void Collect();
+} // namespace Nova::Epoch
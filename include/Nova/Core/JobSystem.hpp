@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace Nova::JobSystem
+{
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(uint32_t begin, uint32_t end)>;
+
+    // totals since Init
+    struct WorkerStats
+    {
+        uint64_t Jobs = 0;
+        uint64_t Steals = 0; // jobs taken from the queue of another thread
+        double BusyTime = 0.0; // seconds spent running jobs
+    };
+
+    // workerCount == 0 picks one worker per hardware thread, minus the main thread
+    void Init(uint32_t workerCount = 0);
+    void Shutdown();
+
+    uint32_t GetWorkerCount();
+    WorkerStats GetWorkerStats(uint32_t worker);
+
+    // Runs the job on a worker thread (or right away if the job system isn't running). Every worker has its own
+    // queue, jobs submitted from a worker go to its queue and idle workers steal from the others.
+    void Submit(Job job);
+
+    // Splits [0, count) into ranges of at most grainSize items and runs them on the workers.
+    // The calling thread works on the ranges too, and the function returns once all of them are done.
+    void ParallelFor(uint32_t count, uint32_t grainSize, const RangeJob& job);
+} // namespace Nova::JobSystem
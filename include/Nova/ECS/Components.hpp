@@ -1,10 +1,18 @@
 #pragma once
 
 #include "Nova/Misc/Color.hpp"
+#include "Nova/Physics/PhysicsWorld.hpp"
+#include "Nova/Physics/SpatialHash.hpp"
 #include "Nova/Renderer/Texture.hpp"
 #include "Nova/Renderer/Sprite.hpp"
+#include "Nova/Renderer/SpriteSheet.hpp"
+#include "Nova/Renderer/ParticleEmitter.hpp"
+#include "Nova/Renderer/Renderer.hpp"
 
 #include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <entt/entity/entity.hpp>
+#include <entt/entity/fwd.hpp>
 
 namespace Nova
 {
@@ -15,6 +23,30 @@ namespace Nova
         float Rotation;
     };
 
+    // Transform of an entity with a parent (see Entity::SetParent), relative to the position and rotation of the
+    // parent. Scale isn't inherited, since it's the size of the quad.
+    struct LocalTransform
+    {
+        glm::vec2 Position;
+        glm::vec2 Scale;
+        float Rotation;
+    };
+
+    // Node of the transform hierarchy, managed by Entity::SetParent and the TransformSystem. The QuadTransform of
+    // children is computed from their LocalTransform and the world transform of their parent. Adding or patching
+    // (Entity::PatchComponent, registry.patch/replace) a LocalTransform, or the QuadTransform of a root, updates the
+    // subtree; writes through a view have to call Scene::GetTransformSystem().MarkDirty from the main thread.
+    struct HierarchyComponent
+    {
+        entt::entity Parent = entt::null; // null for roots
+        entt::entity Root = entt::null; // of the tree, the node itself for roots
+        uint32_t Depth = 0;
+        uint32_t SubtreeSize = 1; // nodes of the tree of a root, right after it in the storage
+        QuadTransform World = {}; // cached world transform
+        bool Dirty = true;
+        bool Changed = false; // World changed in the last update, so the children follow
+    };
+
     using ColorComponent = Color;
 
     struct TextureComponent
@@ -23,5 +55,61 @@ namespace Nova
         ColorComponent Color = Nova::White;
     };
 
+    // Keeps the vertices of the quads drawn from the ColorComponent and TextureComponent of the entity, for entities
+    // that rarely change. Adding or patching (Entity::PatchComponent, registry.patch/replace) the QuadTransform, color
+    // or texture rebuilds them on the next draw, writes through a view have to set Dirty.
+    struct RenderCacheComponent
+    {
+        Renderer::CachedQuad ColorQuad;
+        Renderer::CachedQuad TextureQuad;
+        bool Dirty = true;
+    };
+
     using SpriteComponent = Sprite;
+
+    // lighter alternative to SpriteComponent, with the frames and clips in a shared SpriteSheet
+    using SpriteInstanceComponent = SpriteInstance;
+
+    // animated by the renderer, SpriteSystem doesn't touch it
+    using GPUSpriteAnimationComponent = GPUSpriteAnimation;
+
+    // Throttles the animation of an entity with a QuadTransform and a sprite. Sprites outside the viewport stop
+    // advancing and catch up on the skipped time once they're visible again, visible ones advance every Interval
+    // frames with the time in between.
+    struct AnimationLODComponent
+    {
+        uint32_t Interval = 1; // raise for distant or low priority entities
+        bool PauseOffscreen = true;
+        float PendingTime = 0.0f; // not yet applied to the sprite
+    };
+
+    using ParticleEmitterComponent = ParticleEmitter;
+
+    // Puts an entity with a QuadTransform in the spatial index of its scene (Scene::GetSpatialIndex), with the user
+    // data of the results being the entity. The SpatialSystem moves it at the end of every frame, indexing the quad as
+    // drawn (see GetQuadSize).
+    struct SpatialComponent
+    {
+        SpatialProxy Proxy = INVALID_SPATIAL_PROXY;
+        glm::vec4 Bounds = {0.0f, 0.0f, 0.0f, 0.0f}; // min and max of the quad when it was last moved
+    };
+
+    // Makes an entity with a QuadTransform a rigid body of the physics world of its scene (Scene::GetPhysicsWorld). The
+    // body starts where the quad is, as a box of its drawn size (GetQuadSize) when Config has no shape, once that size
+    // is known (textures have to be loaded first). The PhysicsSystem writes its position and rotation back into the
+    // quad every frame. Changing the QuadTransform teleports the body, the shape stays the same. Meant for roots of the
+    // transform hierarchy, children have their QuadTransform overwritten.
+    struct RigidBodyComponent
+    {
+        PhysicsBodyConfig Config; // the transform and user data are taken from the entity
+        PhysicsBodyID Body = INVALID_PHYSICS_BODY;
+        QuadTransform Synced = {}; // last one the body and the quad agreed on
+    };
+
+    // Size in pixels of the quad drawn for the entity: Scale multiplies the frame size of sprites and the texture size
+    // of textured quads, and is the size itself for colored ones. Zero while the texture isn't there.
+    glm::vec2 GetQuadSize(const entt::registry& registry, entt::entity entity, const QuadTransform& transform);
+
+    // min and max of a quad of size drawn with transform, which rotates around its top left corner
+    glm::vec4 GetQuadBounds(const QuadTransform& transform, const glm::vec2& size);
 } // namespace Nova
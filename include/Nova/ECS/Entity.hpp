@@ -38,6 +38,19 @@ namespace Nova
             return m_ParentScene->m_Registry.get<Component>(m_Entity);
         }
 
+        // calls fn(component) for each fn and notifies the on_update listeners (see RenderCacheComponent)
+        template<typename Component, typename... Fn>
+        Component& PatchComponent(Fn&&... fn)
+        {
+            return m_ParentScene->m_Registry.patch<Component>(m_Entity, std::forward<Fn>(fn)...);
+        }
+
+        // Moves the entity in the transform hierarchy (see HierarchyComponent), keeping its QuadTransform.
+        // Returns false if parent is a descendant of this entity, or one of them has no QuadTransform.
+        bool SetParent(const Entity& parent);
+        void RemoveParent();
+        Entity GetParent() const;
+
         template<typename Component>
         void RemoveComponent()
         {
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Nova/ECS/System.hpp"
+#include "Nova/ECS/Components.hpp"
+
+namespace Nova
+{
+    class ParticleSystem : public ParallelSystem<Read<QuadTransform>, Write<ParticleEmitterComponent>>
+    {
+    public:
+        using ParallelSystem::ParallelSystem;
+
+        virtual ~ParticleSystem() = default;
+        virtual void Update(float deltaTime) override;
+    };
+} // namespace Nova
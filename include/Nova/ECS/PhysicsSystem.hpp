@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Nova/ECS/System.hpp"
+#include "Nova/Physics/PhysicsWorld.hpp"
+
+#include <entt/entity/registry.hpp>
+
+namespace Nova
+{
+    // Simulates the entities with a QuadTransform and a RigidBodyComponent in a PhysicsWorld. Bodies are created from
+    // the quads, stepped at the fixed time step of the world whatever the frame time, and their interpolated
+    // transforms are written back into the quads. Runs after the other systems, before the TransformSystem, on the
+    // main thread.
+    class PhysicsSystem : public System
+    {
+    public:
+        using System::System;
+
+        virtual ~PhysicsSystem() = default;
+        virtual void Update(float deltaTime) override;
+
+        // listens to the entities leaving the world, called by the scene
+        void Connect();
+
+        PhysicsWorld& GetWorld() noexcept
+        {
+            return m_World;
+        }
+
+    private:
+        void OnRemoved(entt::registry& registry, entt::entity entity);
+
+    private:
+        PhysicsWorld m_World;
+    };
+} // namespace Nova
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Nova/ECS/System.hpp"
+#include "Nova/Physics/SpatialHash.hpp"
+
+#include <entt/entity/registry.hpp>
+
+namespace Nova
+{
+    // Keeps the SpatialHash of the scene in sync with the QuadTransform of the entities with a SpatialComponent. Only
+    // the entities whose bounds changed are moved in the index. Runs last, on the main thread, so the systems of the
+    // next frame can query the index from any thread.
+    class SpatialSystem : public System
+    {
+    public:
+        using System::System;
+
+        virtual ~SpatialSystem() = default;
+        virtual void Update(float deltaTime) override;
+
+        // listens to the entities leaving the index, called by the scene
+        void Connect();
+
+        // rebuilds the index with the new cell size on the next update
+        void SetCellSize(float cellSize);
+
+        const SpatialHash& GetIndex() const noexcept
+        {
+            return m_Index;
+        }
+
+    private:
+        void OnRemoved(entt::registry& registry, entt::entity entity);
+
+    private:
+        SpatialHash m_Index;
+    };
+} // namespace Nova
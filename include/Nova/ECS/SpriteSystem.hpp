@@ -1,15 +1,31 @@
 #pragma once
 
 #include "Nova/ECS/System.hpp"
+#include "Nova/ECS/Components.hpp"
+
+#include <cstdint>
+#include <vector>
 
 namespace Nova
 {
-    class SpriteSystem : public System
+    class SpriteSystem : public ParallelSystem<Read<QuadTransform>, Write<SpriteComponent, SpriteInstanceComponent,
+                                                                          AnimationLODComponent>>
     {
     public:
-        using System::System;
+        using ParallelSystem::ParallelSystem;
 
         virtual ~SpriteSystem() = default;
         virtual void Update(float deltaTime) override;
+
+    private:
+        // fills the delta times of the sprites with an AnimationLODComponent, returns how many were held back
+        uint32_t UpdateLOD(float deltaTime);
+
+    private:
+        uint32_t m_FrameIndex = 0;
+
+        // by index in the component storages, empty when no entity has an AnimationLODComponent
+        std::vector<float> m_SpriteDeltaTimes;
+        std::vector<float> m_InstanceDeltaTimes;
     };
 } // namespace Nova
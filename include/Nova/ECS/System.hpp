@@ -1,18 +1,94 @@
 #pragma once
 
+#include <vector>
+#include <entt/entity/registry.hpp>
+
 namespace Nova
 {
     class Scene;
 
+    struct ComponentAccess
+    {
+        entt::id_type Type = 0;
+        bool Write = false;
+        void (*Assure)(entt::registry& registry) = nullptr; // creates the storage before systems run in parallel
+    };
+
+    // Components a system reads and writes. Systems that don't declare it run alone, in the order they were added.
+    struct SystemAccess
+    {
+        bool Declared = false;
+        std::vector<ComponentAccess> Components;
+
+        template<typename Component>
+        void Add(bool write)
+        {
+            Components.push_back({
+                .Type = entt::type_hash<Component>::value(),
+                .Write = write,
+                .Assure = [](entt::registry& registry) { registry.storage<Component>(); },
+            });
+        }
+
+        bool Allows(entt::id_type type, bool write) const noexcept;
+        bool ConflictsWith(const SystemAccess& other) const noexcept;
+    };
+
     class System
     {
     public:
-        System(Scene* parentScene);
+        System(Scene* parentScene, SystemAccess access = {});
         virtual ~System() = default;
 
         virtual void Update(float deltaTime) = 0;
 
+        const SystemAccess& GetAccess() const noexcept
+        {
+            return m_Access;
+        }
+
     protected:
         Scene* m_ParentScene = nullptr;
+
+    private:
+        SystemAccess m_Access;
+    };
+
+    template<typename... Components>
+    struct Read
+    {
+    };
+
+    template<typename... Components>
+    struct Write
+    {
+    };
+
+    template<typename ReadList, typename WriteList = Write<>>
+    class ParallelSystem;
+
+    // System that declares the components it reads and writes, so the scene can run it on the job system alongside
+    // the systems it doesn't conflict with. Systems that conflict still run in the order they were added. In debug
+    // builds, Scene::GetEntitiesWith and Scene::GetStorage assert on components the system didn't declare.
+    // It must not create or destroy entities, nor add or remove components.
+    template<typename... Reads, typename... Writes>
+    class ParallelSystem<Read<Reads...>, Write<Writes...>> : public System
+    {
+    public:
+        ParallelSystem(Scene* parentScene) : System(parentScene, MakeAccess()) {}
+
+        virtual ~ParallelSystem() = default;
+
+    private:
+        static SystemAccess MakeAccess()
+        {
+            SystemAccess access;
+            access.Declared = true;
+
+            (access.Add<Reads>(false), ...);
+            (access.Add<Writes>(true), ...);
+
+            return access;
+        }
     };
 } // namespace Nova
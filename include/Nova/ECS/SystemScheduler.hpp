@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Nova/ECS/System.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <entt/entity/registry.hpp>
+
+namespace Nova
+{
+    // Runs the systems of a scene in stages: a system goes in the stage after the last earlier system it conflicts
+    // with, and the systems of a stage run at the same time on the job system. Since systems that touch the same
+    // components always run in the order they were added, the results don't depend on the number of workers.
+    class SystemScheduler
+    {
+    public:
+        void Add(System* system);
+        void Run(entt::registry& registry, float deltaTime);
+
+        uint32_t GetStageCount() const noexcept
+        {
+            return (uint32_t) m_Stages.size();
+        }
+
+        // debug checks against the access declared by the system running on this thread, if any
+        template<typename Component>
+        static void CheckAccess()
+        {
+            CheckAccess(entt::type_hash<std::remove_const_t<Component>>::value(), !std::is_const_v<Component>,
+                        entt::type_name<std::remove_const_t<Component>>::value());
+        }
+
+        static void CheckAccess(entt::id_type type, bool write, std::string_view name);
+        static void CheckRegistryAccess();
+
+        // access of the system running on this thread, null outside of systems
+        static const SystemAccess* GetRunningAccess();
+
+        // Checks against access on this thread until destroyed, for the jobs a system sends to other threads: they
+        // capture GetRunningAccess() where they're submitted and open a scope with it where they run.
+        class AccessScope
+        {
+        public:
+            explicit AccessScope(const SystemAccess* access);
+            ~AccessScope();
+
+            AccessScope(const AccessScope&) = delete;
+            AccessScope& operator=(const AccessScope&) = delete;
+
+        private:
+            const SystemAccess* m_Previous;
+        };
+
+    private:
+        void Build(entt::registry& registry);
+
+    private:
+        std::vector<System*> m_Systems;
+        std::vector<std::vector<System*>> m_Stages;
+        bool m_Dirty = true;
+    };
+} // namespace Nova
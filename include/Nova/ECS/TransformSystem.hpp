@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Nova/ECS/System.hpp"
+
+#include <vector>
+#include <entt/entity/registry.hpp>
+
+namespace Nova
+{
+    // Computes the world transforms of the transform hierarchy. Nodes are kept sorted by tree and then by depth, so
+    // every tree is a run of the storage with parents before children. Only the trees with changes are walked, and
+    // only their dirty nodes and the subtrees of those are recomputed. Runs after the other systems, on the main
+    // thread.
+    class TransformSystem : public System
+    {
+    public:
+        using System::System;
+
+        virtual ~TransformSystem() = default;
+        virtual void Update(float deltaTime) override;
+
+        // listens to the changes of the transforms, called by the scene
+        void Connect();
+
+        // parent == entt::null detaches child, which keeps its current QuadTransform. Returns false on cycles.
+        bool SetParent(entt::entity child, entt::entity parent);
+        void MarkDirty(entt::entity entity);
+
+    private:
+        void OnTransformChanged(entt::registry& registry, entt::entity entity);
+        void OnRootChanged(entt::registry& registry, entt::entity entity);
+        void OnNodeCreated(entt::registry& registry, entt::entity entity);
+        void OnNodeDestroyed(entt::registry& registry, entt::entity entity);
+        void Sort(entt::registry& registry);
+        void Flush(entt::registry& registry);
+
+    private:
+        std::vector<entt::entity> m_DirtyRoots; // any node of the tree while unsorted
+        bool m_Unsorted = false;
+    };
+} // namespace Nova
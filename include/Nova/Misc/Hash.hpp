@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace Nova
+{
+    static constexpr uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ull;
+    static constexpr uint64_t FNV1A_PRIME = 1099511628211ull;
+
+    // 64-bit FNV-1a, used for asset names and file contents
+    constexpr uint64_t HashFNV1a(std::string_view str) noexcept
+    {
+        uint64_t hash = FNV1A_OFFSET_BASIS;
+
+        for (char c : str)
+            hash = (hash ^ (uint8_t) c) * FNV1A_PRIME;
+
+        return hash;
+    }
+
+    constexpr uint64_t HashFNV1a(std::span<const uint8_t> bytes) noexcept
+    {
+        uint64_t hash = FNV1A_OFFSET_BASIS;
+
+        for (uint8_t byte : bytes)
+            hash = (hash ^ byte) * FNV1A_PRIME;
+
+        return hash;
+    }
+} // namespace Nova
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// LZ4 block format (no frame header), compatible with the reference implementation's LZ4_decompress_safe.
+// The compressor is a simple greedy one, fast but not aiming for the best ratio.
+namespace Nova::LZ4
+{
+    constexpr size_t GetMaxCompressedSize(size_t size) noexcept
+    {
+        return size + size / 255 + 16;
+    }
+
+    // returns the compressed size, dst must hold at least GetMaxCompressedSize(src.size()) bytes
+    size_t Compress(std::span<const uint8_t> src, std::span<uint8_t> dst);
+
+    // dst must be exactly the uncompressed size, returns false on malformed input
+    bool Decompress(std::span<const uint8_t> src, std::span<uint8_t> dst);
+} // namespace Nova::LZ4
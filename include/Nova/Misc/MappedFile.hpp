@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <filesystem>
+
+namespace Nova
+{
+    // Read-only memory mapping of a whole file, the pages are loaded by the OS on first access
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        virtual ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        bool IsOpen() const noexcept
+        {
+            return m_Data != nullptr;
+        }
+
+        const uint8_t* GetData() const noexcept
+        {
+            return m_Data;
+        }
+
+        size_t GetSize() const noexcept
+        {
+            return m_Size;
+        }
+
+        std::span<const uint8_t> GetSpan() const noexcept
+        {
+            return {m_Data, m_Size};
+        }
+
+    private:
+        const uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+
+#ifdef _WIN32
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+#endif
+    };
+} // namespace Nova
@@ -9,6 +9,12 @@ namespace Nova::Metrics
     float GetFPS();
     uint32_t GetDrawCalls();
     uint32_t GetDrawnObjects();
+    uint32_t GetAnimationUpdates();
+    uint32_t GetSkippedAnimationUpdates();
+    // bytes of quad batch vertices sent to the GPU
+    uint64_t GetVertexBytes();
+    // fraction of the last frame the job system worker spent running jobs
+    float GetWorkerUtilization(uint32_t worker);
 
     void DebugUI();
 
@@ -16,6 +22,9 @@ namespace Nova::Metrics
 
     void IncrementDrawCalls();
     void IncrementDrawnObjects(uint32_t count);
+    void IncrementAnimationUpdates(uint32_t count);
+    void IncrementSkippedAnimationUpdates(uint32_t count);
+    void IncrementVertexBytes(uint64_t bytes);
     void IncrementEntities();
     void DecrementEntities();
 } // namespace Nova::Metrics
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Nova/Physics/PhysicsShape.hpp"
+
+#include <array>
+#include <cstdint>
+#include <glm/vec2.hpp>
+
+namespace Nova
+{
+    struct PhysicsContactPoint
+    {
+        glm::vec2 Position = {0.0f, 0.0f}; // world space, halfway between the shapes
+        float Separation = 0.0f; // negative when the shapes overlap
+        uint32_t ID = 0; // features of the shapes that made the point, the same while they stay in contact
+    };
+
+    struct PhysicsManifold
+    {
+        glm::vec2 Normal = {0.0f, 0.0f}; // from shape a to shape b
+        std::array<PhysicsContactPoint, 2> Points = {};
+        uint32_t PointCount = 0;
+    };
+} // namespace Nova
+
+namespace Nova::Collision
+{
+    // Contact points of two shapes, including the ones of shapes apart by less than speculativeDistance so the solver
+    // can stop them before they overlap. Returns false when there are none.
+    bool ComputeManifold(const PhysicsShape& a, const PhysicsTransform& transformA, const PhysicsShape& b,
+                         const PhysicsTransform& transformB, float speculativeDistance, PhysicsManifold& manifold);
+} // namespace Nova::Collision
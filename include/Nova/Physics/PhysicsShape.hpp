@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace Nova
+{
+    static constexpr uint32_t MAX_POLYGON_VERTICES = 8;
+
+    enum class PhysicsShapeType : uint8_t
+    {
+        Circle,
+        Polygon,
+    };
+
+    // position and rotation of a body, angle in radians
+    struct PhysicsTransform
+    {
+        glm::vec2 Position = {0.0f, 0.0f};
+        float Angle = 0.0f;
+    };
+
+    struct PhysicsMass
+    {
+        float Mass = 0.0f;
+        float Inertia = 0.0f; // around the centroid
+    };
+
+    // Collision shape of a body, centered on the body position. Boxes are polygons, which stay axis aligned on bodies
+    // with a fixed rotation.
+    struct PhysicsShape
+    {
+        PhysicsShapeType Type = PhysicsShapeType::Polygon;
+        float Radius = 0.0f; // circles
+        uint32_t VertexCount = 0;
+        std::array<glm::vec2, MAX_POLYGON_VERTICES> Vertices = {}; // counter clockwise around the centroid
+        std::array<glm::vec2, MAX_POLYGON_VERTICES> Normals = {}; // outward normal of the edge from each vertex
+
+        static PhysicsShape MakeBox(const glm::vec2& halfExtents);
+        static PhysicsShape MakeCircle(float radius);
+        // convex hull of the points, moved so its centroid is the origin. Empty when the hull has less than 3 or
+        // more than MAX_POLYGON_VERTICES vertices.
+        static PhysicsShape MakePolygon(std::span<const glm::vec2> points);
+
+        bool IsEmpty() const noexcept
+        {
+            return (Type == PhysicsShapeType::Circle) ? Radius <= 0.0f : VertexCount < 3;
+        }
+
+        PhysicsMass ComputeMass(float density) const noexcept;
+
+        // min and max in world space, as x, y, z, w
+        glm::vec4 ComputeBounds(const PhysicsTransform& transform) const noexcept;
+
+        // distance from the centroid to the farthest point of the shape
+        float ComputeExtent() const noexcept;
+    };
+} // namespace Nova
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "Nova/Physics/Collision.hpp"
+#include "Nova/Physics/PhysicsShape.hpp"
+#include "Nova/Physics/SpatialHash.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace Nova
+{
+    using PhysicsBodyID = uint32_t;
+
+    static constexpr PhysicsBodyID INVALID_PHYSICS_BODY = UINT32_MAX;
+
+    enum class PhysicsBodyType : uint8_t
+    {
+        Static,
+        Kinematic, // moved by its velocity only, pushes dynamic bodies
+        Dynamic,
+    };
+
+    struct PhysicsBodyConfig
+    {
+        PhysicsBodyType Type = PhysicsBodyType::Dynamic;
+        PhysicsShape Shape;
+        PhysicsTransform Transform; // position of the centroid of the shape
+        glm::vec2 LinearVelocity = {0.0f, 0.0f};
+        float AngularVelocity = 0.0f; // radians per second
+        float Density = 1.0f; // mass per square unit
+        float Friction = 0.5f;
+        float Restitution = 0.0f;
+        float LinearDamping = 0.0f;
+        float AngularDamping = 0.0f;
+        float GravityScale = 1.0f;
+        bool FixedRotation = false; // with a box shape, an axis aligned box
+        bool AllowSleep = true;
+        uint32_t UserData = 0;
+    };
+
+    // units are pixels and seconds
+    struct PhysicsWorldConfig
+    {
+        glm::vec2 Gravity = {0.0f, 980.0f}; // y points down, like on the screen
+        float TimeStep = 1.0f / 60.0f;
+        uint32_t MaxStepsPerUpdate = 4; // past this the simulation slows down instead of falling further behind
+        uint32_t VelocityIterations = 8;
+        float CellSize = 64.0f; // of the broadphase, about the size of the common bodies
+        float LinearSlop = 0.5f; // overlap left between bodies in contact, so they stay in contact
+        float Baumgarte = 0.2f; // fraction of the remaining overlap resolved by a step
+        float AABBMargin = 4.0f; // bodies move in the broadphase once they leave their bounds grown by this
+        float RestitutionThreshold = 60.0f; // slower impacts don't bounce
+        float SleepVelocity = 8.0f; // of the centroid plus the turning of the farthest point, so slow rolls sleep too
+        float TimeToSleep = 0.5f; // seconds every body of an island has to be still for before it sleeps
+    };
+
+    // of the last step
+    struct PhysicsStats
+    {
+        uint32_t Bodies = 0;
+        uint32_t AwakeBodies = 0;
+        uint32_t Contacts = 0;
+        uint32_t Islands = 0;
+    };
+
+    // Rigid bodies with a single shape each, simulated at a fixed time step by a sequential impulse solver. Bodies
+    // touching each other are grouped into islands, which are solved in parallel on the job system, and islands that
+    // stay still fall asleep until something touches them. The results only depend on the order bodies were created
+    // in, not on the threads.
+    class PhysicsWorld
+    {
+    public:
+        PhysicsWorld(const PhysicsWorldConfig& config = {});
+
+        PhysicsBodyID CreateBody(const PhysicsBodyConfig& config);
+        void DestroyBody(PhysicsBodyID body);
+        void Clear();
+
+        // runs the steps that fit in the time accumulated so far, returns how many
+        uint32_t Update(float deltaTime);
+        void Step();
+
+        PhysicsTransform GetTransform(PhysicsBodyID body) const noexcept
+        {
+            return m_Bodies[body].Transform;
+        }
+
+        // between the last two steps, by the time accumulated since the last one. Drawing bodies there hides the
+        // steps not lining up with the frames.
+        PhysicsTransform GetInterpolatedTransform(PhysicsBodyID body) const noexcept;
+
+        // teleports the body, wakes it up
+        void SetTransform(PhysicsBodyID body, const PhysicsTransform& transform);
+
+        glm::vec2 GetLinearVelocity(PhysicsBodyID body) const noexcept
+        {
+            return m_Bodies[body].LinearVelocity;
+        }
+
+        float GetAngularVelocity(PhysicsBodyID body) const noexcept
+        {
+            return m_Bodies[body].AngularVelocity;
+        }
+
+        void SetLinearVelocity(PhysicsBodyID body, const glm::vec2& velocity);
+        void SetAngularVelocity(PhysicsBodyID body, float velocity);
+
+        // at the centroid, for the next step only
+        void ApplyForce(PhysicsBodyID body, const glm::vec2& force);
+        // at a point in world space, changes the velocity right away
+        void ApplyImpulse(PhysicsBodyID body, const glm::vec2& impulse, const glm::vec2& point);
+
+        bool IsAwake(PhysicsBodyID body) const noexcept
+        {
+            return m_Bodies[body].Awake;
+        }
+
+        void SetAwake(PhysicsBodyID body, bool awake);
+
+        PhysicsBodyType GetType(PhysicsBodyID body) const noexcept
+        {
+            return m_Bodies[body].Type;
+        }
+
+        uint32_t GetUserData(PhysicsBodyID body) const noexcept
+        {
+            return m_Bodies[body].UserData;
+        }
+
+        void SetGravity(const glm::vec2& gravity) noexcept
+        {
+            m_Config.Gravity = gravity;
+        }
+
+        const PhysicsWorldConfig& GetConfig() const noexcept
+        {
+            return m_Config;
+        }
+
+        const PhysicsStats& GetStats() const noexcept
+        {
+            return m_Stats;
+        }
+
+        // bounds of the bodies grown by the AABBMargin, with the body IDs as user data
+        const SpatialHash& GetBroadphase() const noexcept
+        {
+            return m_Broadphase;
+        }
+
+    private:
+        struct Body
+        {
+            PhysicsShape Shape;
+            PhysicsTransform Transform;
+            PhysicsTransform PreviousTransform; // before the last step
+            glm::vec2 LinearVelocity = {0.0f, 0.0f};
+            float AngularVelocity = 0.0f;
+            glm::vec2 Force = {0.0f, 0.0f};
+            float InvMass = 0.0f;
+            float InvInertia = 0.0f;
+            float Friction = 0.5f;
+            float Restitution = 0.0f;
+            float LinearDamping = 0.0f;
+            float AngularDamping = 0.0f;
+            float GravityScale = 1.0f;
+            float SleepTime = 0.0f;
+            float Extent = 0.0f; // of the shape, from the centroid
+            PhysicsBodyType Type = PhysicsBodyType::Static;
+            bool Awake = false;
+            bool AllowSleep = true;
+            bool Alive = false;
+            bool Enlarged = false; // left its broadphase bounds in the last step
+            uint32_t Island = 0; // of the last step
+            SpatialProxy Proxy = INVALID_SPATIAL_PROXY;
+            glm::vec4 Bounds = {0.0f, 0.0f, 0.0f, 0.0f}; // in the broadphase, grown by the margin
+            uint32_t UserData = 0;
+            PhysicsBodyID NextFree = INVALID_PHYSICS_BODY;
+        };
+
+        struct ContactPoint
+        {
+            glm::vec2 AnchorA = {0.0f, 0.0f}; // from the centroids
+            glm::vec2 AnchorB = {0.0f, 0.0f};
+            float Separation = 0.0f;
+            uint32_t ID = 0;
+            float NormalMass = 0.0f;
+            float TangentMass = 0.0f;
+            float TargetVelocity = 0.0f; // normal velocity the solver aims for
+            float NormalImpulse = 0.0f; // accumulated, carried over to the next step
+            float TangentImpulse = 0.0f;
+        };
+
+        struct Contact
+        {
+            uint64_t Key = 0; // both bodies, the lower ID first
+            PhysicsBodyID A = INVALID_PHYSICS_BODY;
+            PhysicsBodyID B = INVALID_PHYSICS_BODY;
+            glm::vec2 Normal = {0.0f, 0.0f}; // from a to b
+            ContactPoint Points[2];
+            uint32_t PointCount = 0;
+            float Friction = 0.0f;
+            float Restitution = 0.0f;
+            float K11 = 0.0f; // normal mass matrix of both points, solved together while it's well conditioned
+            float K12 = 0.0f;
+            float K22 = 0.0f;
+            bool SolveBlock = false;
+        };
+
+        struct Island
+        {
+            uint32_t FirstBody = 0; // into m_IslandBodies
+            uint32_t BodyCount = 0;
+            uint32_t FirstContact = 0; // into m_IslandContacts
+            uint32_t ContactCount = 0;
+            bool Awake = false; // any of its bodies is
+        };
+
+    private:
+        void UpdateContacts();
+        void BuildIslands();
+        void SolveIsland(const Island& island);
+        void UpdateBroadphase();
+
+        void WakeUp(Body& body) noexcept;
+        void WakeOverlapping(const glm::vec4& bounds);
+        void MoveProxy(Body& body);
+
+    private:
+        PhysicsWorldConfig m_Config;
+        SpatialHash m_Broadphase;
+        float m_Accumulator = 0.0f;
+        PhysicsStats m_Stats;
+
+        std::vector<Body> m_Bodies;
+        PhysicsBodyID m_FirstFree = INVALID_PHYSICS_BODY;
+        std::vector<PhysicsBodyID> m_Destroyed; // freed after the next step, so no contact refers to them anymore
+
+        std::vector<SpatialPair> m_Pairs;
+        std::vector<Contact> m_Contacts; // sorted by key, the ones of sleeping bodies are kept as they were
+        std::vector<Contact> m_NewContacts;
+
+        std::vector<Island> m_Islands;
+        std::vector<uint32_t> m_IslandRoots; // union find over the bodies, the lowest ID of a set is its root
+        std::vector<uint32_t> m_IslandBodies;
+        std::vector<uint32_t> m_IslandContacts;
+    };
+} // namespace Nova
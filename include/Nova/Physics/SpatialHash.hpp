@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace Nova
+{
+    using SpatialProxy = uint32_t;
+
+    static constexpr SpatialProxy INVALID_SPATIAL_PROXY = UINT32_MAX;
+
+    struct SpatialPair
+    {
+        uint32_t A = 0; // user data of the two proxies
+        uint32_t B = 0;
+    };
+
+    struct SpatialRaycastHit
+    {
+        uint32_t UserData = 0;
+        float Distance = 0.0f; // from the origin, along the normalized direction
+    };
+
+    // Broadphase over axis aligned boxes, bucketed in a uniform grid of square cells which are only allocated once
+    // something enters them. Each box is registered in every cell it overlaps, so the cell size should be about the
+    // size of the common boxes. Moving a box inside the same cells only rewrites its bounds. Queries are const and can
+    // run on several threads at once, as long as nothing is inserted, moved or removed meanwhile.
+    class SpatialHash
+    {
+    public:
+        SpatialHash(float cellSize = 64.0f);
+
+        SpatialProxy Insert(const glm::vec2& min, const glm::vec2& max, uint32_t userData);
+        void Move(SpatialProxy proxy, const glm::vec2& min, const glm::vec2& max);
+        void Remove(SpatialProxy proxy);
+        void Clear();
+
+        // appends the user data of the boxes overlapping the query, each box once
+        void QueryAABB(const glm::vec2& min, const glm::vec2& max, std::vector<uint32_t>& result) const;
+        void QueryCircle(const glm::vec2& center, float radius, std::vector<uint32_t>& result) const;
+
+        // closest box hit within maxDistance, boxes containing the origin are hit at distance 0
+        bool Raycast(const glm::vec2& origin, const glm::vec2& direction, float maxDistance,
+                     SpatialRaycastHit& hit) const;
+
+        // appends every pair of overlapping boxes once, in the same order for the same contents. The cells are split
+        // across the job system.
+        void FindPairs(std::vector<SpatialPair>& pairs) const;
+
+        uint32_t GetUserData(SpatialProxy proxy) const noexcept
+        {
+            return m_Proxies[proxy].UserData;
+        }
+
+        float GetCellSize() const noexcept
+        {
+            return m_CellSize;
+        }
+
+        // cells holding at least a box
+        uint32_t GetCellCount() const noexcept
+        {
+            return (uint32_t) m_Cells.size() - m_EmptyCells;
+        }
+
+    private:
+        // bounds are stored as min x, min y, -max x, -max y: box a overlaps box b when every lane of a is less than or
+        // equal to the same lane of b with its halves swapped and negated, a single SIMD comparison
+        struct alignas(16) CellEntry
+        {
+            float Bounds[4];
+            SpatialProxy Proxy;
+            uint32_t UserData;
+            int32_t FirstCellX; // lowest cell of the box, overlaps are only reported from one of its cells
+            int32_t FirstCellY;
+        };
+
+        struct Cell
+        {
+            int32_t X = 0;
+            int32_t Y = 0;
+            std::vector<CellEntry> Entries;
+        };
+
+        struct Proxy
+        {
+            glm::ivec4 Cells = {0, 0, -1, -1}; // min x, min y, max x, max y, empty for free proxies
+            uint32_t UserData = 0;
+            uint32_t NextFree = INVALID_SPATIAL_PROXY;
+        };
+
+    private:
+        glm::ivec4 GetCellRange(const glm::vec2& min, const glm::vec2& max) const noexcept;
+        const Cell* FindCell(int32_t x, int32_t y) const;
+        Cell& GetOrAddCell(int32_t x, int32_t y);
+        uint32_t FindSlot(uint64_t key) const noexcept;
+        void Rehash(uint32_t slotCount);
+        void Compact();
+
+        void AddToCells(SpatialProxy proxy, const CellEntry& entry);
+        void RemoveFromCells(SpatialProxy proxy);
+
+        // calls fn(entry) for the entries of the cells in range, reporting each box once
+        template<typename Fn>
+        void ForEachInRange(const glm::ivec4& range, const Fn& fn) const;
+
+    private:
+        float m_CellSize = 64.0f;
+        float m_InvCellSize = 1.0f / 64.0f;
+
+        std::vector<Proxy> m_Proxies;
+        SpatialProxy m_FirstFree = INVALID_SPATIAL_PROXY;
+
+        // Empty cells are kept, boxes often come back to them, until they're half of the cells. They're found with
+        // an open addressing table of packed cell coordinates, which never removes keys, only rebuilds.
+        std::vector<Cell> m_Cells;
+        uint32_t m_EmptyCells = 0;
+        std::vector<uint64_t> m_SlotKeys;
+        std::vector<uint32_t> m_SlotCells;
+        uint32_t m_SlotShift = 64;
+    };
+} // namespace Nova
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Layout of cooked .ntex textures, shared by Texture and the nova_cook tool.
+// A file is a CookedTextureHeader, followed by MipCount CookedTextureMip entries and the pixel data of each mip.
+// Uncompressed rows are padded to 4 bytes, so mips can be uploaded straight from the file with the default
+// unpack alignment.
+namespace Nova
+{
+    static constexpr std::array<char, 4> COOKED_TEXTURE_MAGIC = {'N', 'T', 'E', 'X'};
+    static constexpr uint32_t COOKED_TEXTURE_VERSION = 1;
+    static constexpr uint32_t COOKED_TEXTURE_MAX_MIPS = 16;
+
+    enum class CookedTextureFormat : uint8_t
+    {
+        R8,
+        RG8,
+        RGBA8,
+        BC1, // S3TC DXT1, RGB with 1-bit alpha
+        BC3, // S3TC DXT5, RGBA
+        BC4, // RGTC1, single channel
+        BC5  // RGTC2, two channels
+    };
+
+    // clang-format off
+    enum CookedTextureFlags_ : uint8_t
+    {
+        CookedTextureFlags_None             = 0,
+        CookedTextureFlags_Premultiplied    = 1 << 0,
+        CookedTextureFlags_Nearest          = 1 << 1
+    };
+    // clang-format on
+
+    struct CookedTextureHeader
+    {
+        std::array<char, 4> Magic;
+        uint32_t Version;
+        uint32_t Width;
+        uint32_t Height;
+        CookedTextureFormat Format;
+        uint8_t Flags;
+        uint16_t MipCount;
+    };
+
+    struct CookedTextureMip
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint64_t Offset; // from the start of the file
+        uint64_t Size;
+    };
+
+    constexpr bool IsCompressedFormat(CookedTextureFormat format) noexcept
+    {
+        return format >= CookedTextureFormat::BC1;
+    }
+
+    constexpr uint32_t GetFormatChannels(CookedTextureFormat format) noexcept
+    {
+        switch (format)
+        {
+        case CookedTextureFormat::R8:
+        case CookedTextureFormat::BC4:
+            return 1;
+        case CookedTextureFormat::RG8:
+        case CookedTextureFormat::BC5:
+            return 2;
+        default:
+            return 4;
+        }
+    }
+
+    constexpr uint64_t GetCookedRowPitch(CookedTextureFormat format, uint32_t width) noexcept
+    {
+        if (IsCompressedFormat(format))
+        {
+            const bool halfBlocks = format == CookedTextureFormat::BC1 || format == CookedTextureFormat::BC4;
+            const uint64_t blockBytes = halfBlocks ? 8 : 16;
+            return ((width + 3) / 4) * blockBytes;
+        }
+
+        return ((uint64_t) width * GetFormatChannels(format) + 3) & ~uint64_t(3);
+    }
+
+    // bytes of a mip, for compressed formats a "row" is a row of 4x4 blocks
+    constexpr uint64_t GetCookedMipSize(CookedTextureFormat format, uint32_t width, uint32_t height) noexcept
+    {
+        const uint64_t rows = IsCompressedFormat(format) ? (height + 3) / 4 : height;
+        return GetCookedRowPitch(format, width) * rows;
+    }
+
+    constexpr uint32_t GetFullMipCount(uint32_t width, uint32_t height) noexcept
+    {
+        uint32_t count = 1;
+
+        for (uint32_t size = std::max(width, height); size > 1 && count < COOKED_TEXTURE_MAX_MIPS; size /= 2)
+            ++count;
+
+        return count;
+    }
+} // namespace Nova
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Nova/Asset/Assets.hpp"
+#include "Nova/Misc/Color.hpp"
+#include "Nova/Renderer/Shader.hpp"
+#include "Nova/Renderer/Texture.hpp"
+
+#include <array>
+#include <cstdint>
+#include <glm/fwd.hpp>
+#include <glm/vec2.hpp>
+
+namespace Nova
+{
+    struct GPUParticleEmitterConfig
+    {
+        TextureAsset Texture;
+        uint32_t MaxParticles = 100000;
+        float LifetimeMin = 1.0f;
+        float LifetimeMax = 1.0f;
+        glm::vec2 SpawnArea = {0.0f, 0.0f}; // size of the rectangle centered on the emitter
+        glm::vec2 VelocityMin = {-50.0f, -50.0f};
+        glm::vec2 VelocityMax = {50.0f, 50.0f};
+        glm::vec2 Acceleration = {0.0f, 0.0f};
+        float StartSize = 8.0f;
+        float EndSize = 0.0f;
+        Color StartColor = Nova::White;
+        Color EndColor = Nova::Blank;
+        uint32_t PaletteRow = 0; // for indexed textures
+    };
+
+    // Particles are simulated in a vertex shader, ping-ponging between two buffers with transform feedback,
+    // and drawn with instancing straight from the simulation output. Dead particles respawn while the emitter
+    // is emitting, so the emission rate is MaxParticles / average lifetime.
+    // Use Renderer::DrawParticles to draw it.
+    class GPUParticleEmitter
+    {
+    public:
+        GPUParticleEmitter() = default;
+        virtual ~GPUParticleEmitter();
+
+        GPUParticleEmitter(const GPUParticleEmitter&) = delete;
+        GPUParticleEmitter(GPUParticleEmitter&&) = delete;
+        GPUParticleEmitter& operator=(const GPUParticleEmitter&) = delete;
+        GPUParticleEmitter& operator=(GPUParticleEmitter&&) = delete;
+
+        bool Init(const GPUParticleEmitterConfig& config);
+        void Shutdown();
+
+        void Update(float deltaTime, const glm::vec2& position);
+        // fallbackTexture is used when the config has no texture
+        void Draw(const glm::mat4& projection, const Texture& fallbackTexture) const;
+
+        bool IsInitialized() const noexcept
+        {
+            return m_Buffers[0] != 0;
+        }
+
+        uint32_t GetMaxParticles() const noexcept
+        {
+            return m_Config.MaxParticles;
+        }
+
+    public:
+        bool Emitting = true;
+
+    private:
+        uint32_t m_Current = 0;
+        float m_Time = 0.0f;
+        GPUParticleEmitterConfig m_Config;
+
+        std::array<uint32_t, 2> m_Buffers = {0, 0};
+        std::array<uint32_t, 2> m_UpdateVAs = {0, 0};
+        std::array<uint32_t, 2> m_DrawVAs = {0, 0};
+        uint32_t m_CornerBuffer = 0;
+
+        mutable Shader m_UpdateShader;
+        mutable Shader m_DrawShader;
+    };
+} // namespace Nova
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Decoders for the images stb_image is slow on or doesn't know: QOI, uncompressed TGA and binary PGM/PPM.
+// They don't touch GL state, and big images are converted by several job system workers at once.
+namespace Nova::ImageCodecs
+{
+    enum class ImageFormat : uint8_t
+    {
+        QOI,
+        TGA,
+        PNM
+    };
+
+    struct ImageInfo
+    {
+        ImageFormat Format = ImageFormat::QOI;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t Channels = 0;       // of the decoded pixels, 1 or 4 (RGB is expanded to RGBA)
+        uint32_t SourceChannels = 0; // as stored in the file
+        size_t DataOffset = 0;
+        bool BottomUp = false;
+        bool BGR = false;
+    };
+
+    // False when bytes is none of the formats above, or a variant of them that isn't handled (RLE or color mapped
+    // TGA, 16-bit PNM...), which is then left to stb_image.
+    bool GetInfo(std::span<const uint8_t> bytes, ImageInfo& info);
+
+    // Decodes an image GetInfo accepted, rows are pitch bytes apart.
+    bool Decode(std::span<const uint8_t> bytes, const ImageInfo& info, uint8_t* pixels, size_t pitch);
+
+    std::vector<uint8_t> EncodeQOI(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels);
+
+    // Copies rows converting them to dstChannels (same as srcChannels, or 4 when expanding RGB), optionally swapping
+    // red and blue and flipping the image vertically. Split in bands of rows over the job system for big images.
+    void ConvertRows(const uint8_t* src, size_t srcPitch, uint32_t srcChannels, uint8_t* dst, size_t dstPitch,
+                     uint32_t dstChannels, uint32_t width, uint32_t height, bool swapRB = false, bool flip = false);
+} // namespace Nova::ImageCodecs
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Nova/Asset/Assets.hpp"
+#include "Nova/Misc/Color.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/vec2.hpp>
+
+namespace Nova
+{
+    struct ParticleEmitterConfig
+    {
+        TextureAsset Texture;
+        uint32_t MaxParticles = 1000;
+        float EmissionRate = 100.0f; // particles per second
+        float LifetimeMin = 1.0f;
+        float LifetimeMax = 1.0f;
+        glm::vec2 SpawnArea = {0.0f, 0.0f}; // size of the rectangle centered on the emitter
+        glm::vec2 VelocityMin = {-50.0f, -50.0f};
+        glm::vec2 VelocityMax = {50.0f, 50.0f};
+        glm::vec2 Acceleration = {0.0f, 0.0f};
+        float StartSize = 8.0f;
+        float EndSize = 0.0f;
+        Color StartColor = Nova::White;
+        Color EndColor = Nova::Blank;
+    };
+
+    // Particle state is kept as structure-of-arrays so the update runs as a SIMD kernel split across the
+    // job system workers, and the renderer can turn it into quads in bulk.
+    // Size and color are linear ramps from their start to their end value over each particle's lifetime.
+    class ParticleEmitter
+    {
+    public:
+        ParticleEmitter() = default;
+        ParticleEmitter(const ParticleEmitterConfig& config);
+
+        void Update(float deltaTime, const glm::vec2& position);
+        void Emit(uint32_t count, const glm::vec2& position);
+        void Clear() noexcept;
+
+        const ParticleEmitterConfig& GetConfig() const noexcept
+        {
+            return m_Config;
+        }
+
+        uint32_t GetParticleCount() const noexcept
+        {
+            return m_Count;
+        }
+
+        // clang-format off
+        std::span<const float> GetPositionsX() const noexcept { return {m_PosX.data(), m_Count}; }
+        std::span<const float> GetPositionsY() const noexcept { return {m_PosY.data(), m_Count}; }
+        std::span<const float> GetAges() const noexcept { return {m_Age.data(), m_Count}; }
+        std::span<const float> GetInvLifetimes() const noexcept { return {m_InvLifetime.data(), m_Count}; }
+        // clang-format on
+
+    public:
+        bool Emitting = true;
+
+    private:
+        float RandomFloat(float min, float max) noexcept;
+        void KillDeadParticles() noexcept;
+
+    private:
+        uint32_t m_Count = 0;
+        uint32_t m_RandomState = 0x9E3779B9u;
+        float m_EmissionAccumulator = 0.0f;
+        ParticleEmitterConfig m_Config;
+
+        std::vector<float> m_PosX;
+        std::vector<float> m_PosY;
+        std::vector<float> m_VelX;
+        std::vector<float> m_VelY;
+        std::vector<float> m_Age;
+        std::vector<float> m_InvLifetime;
+    };
+} // namespace Nova
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Nova/Misc/Color.hpp"
+#include "Nova/Renderer/Texture.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <filesystem>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace Nova::RenderCapture
+{
+    // Records every Renderer call of the next frameCount frames into a binary file.
+    // Recording starts at the next Renderer::BeginFrame and stops by itself once all frames are written.
+    bool Begin(const std::filesystem::path& path, uint32_t frameCount);
+    void End();
+    bool IsCapturing();
+
+    // called by the Renderer
+    void RecordBeginFrame();
+    void RecordEndFrame();
+    void RecordClear(const Color& color);
+    void RecordProjection(int width, int height);
+    void RecordQuad(const Texture* texture, const glm::vec2& position, const glm::vec2& scale, const Color& color,
+                    float rotation, const glm::vec2& origin, const glm::vec4& sourceRect);
+    void RecordShape(const glm::vec2& position, const glm::vec2& size, float cornerRadius, const Color& color,
+                     float rotation, float outlineThickness);
+} // namespace Nova::RenderCapture
+
+namespace Nova
+{
+    // Plays back a capture written by RenderCapture against the Renderer, without any scene code running.
+    // Recorded textures are recreated as blank textures with the same size and filter.
+    class RenderReplay
+    {
+    public:
+        RenderReplay() = default;
+
+        RenderReplay(const RenderReplay&) = delete;
+        RenderReplay& operator=(const RenderReplay&) = delete;
+
+        bool Load(const std::filesystem::path& path);
+        void PlayFrame(uint32_t index) const;
+
+        uint32_t GetFrameCount() const noexcept
+        {
+            return (uint32_t) m_FrameOffsets.size();
+        }
+
+        int GetWidth() const noexcept
+        {
+            return m_Width;
+        }
+
+        int GetHeight() const noexcept
+        {
+            return m_Height;
+        }
+
+    private:
+        int m_Width = 0;
+        int m_Height = 0;
+        std::vector<uint8_t> m_Stream;
+        std::vector<size_t> m_FrameOffsets;
+        std::vector<std::shared_ptr<Texture>> m_Textures;
+    };
+} // namespace Nova
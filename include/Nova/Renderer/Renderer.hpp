@@ -3,23 +3,78 @@
 #include "Nova/Misc/Color.hpp"
 #include "Nova/Renderer/Texture.hpp"
 #include "Nova/Renderer/Sprite.hpp"
+#include "Nova/Renderer/SpriteSheet.hpp"
+#include "Nova/Renderer/ParticleEmitter.hpp"
+#include "Nova/Renderer/GPUParticleEmitter.hpp"
+#include "Nova/Renderer/VirtualTexture.hpp"
 
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
+#include <array>
+#include <cstdint>
 #include <memory>
 
 namespace Nova::Renderer
 {
+    enum QuadFlags : uint16_t
+    {
+        QuadFlags_None = 0,
+        QuadFlags_Shape = 1 << 0,    // signed distance field shape, see DrawRoundedRect
+        QuadFlags_Animated = 1 << 1, // frames picked by the vertex shader, see GPUSpriteAnimation
+        QuadFlags_Loop = 1 << 2,     // of animated quads
+    };
+
+    // Vertex of the quad batch. Everything after Color is the same for the 4 vertices of a quad, packed so plain
+    // sprites don't pay for what shapes and GPU animations need. What Params holds depends on Flags.
+    struct QuadVertex
+    {
+        glm::vec2 Position;
+        glm::vec2 TexCoords; // the corner of the quad (0 or 1) for shapes
+        Nova::Color Color;
+        glm::vec4 Params;    // shapes: half width, half height, corner radius, outline thickness
+                             // animated: start time, frame time, cell size in uv
+        uint16_t TexIndex;
+        uint16_t Flags;      // QuadFlags
+        uint16_t PaletteRow; // palette of indexed textures
+        uint16_t FrameCount; // of the clip of animated quads, like the columns of the sheet and the first cell
+        uint16_t Columns;
+        uint16_t FirstCell;
+    };
+
+    static_assert(sizeof(QuadVertex) == 48, "QuadVertex has to match the vertex layout of the quad batch");
+
+    // Quad with its world space vertices built once by BuildQuad, drawing it is then a copy into the batch.
+    // The other fields are what it was built from, for RenderCapture.
+    struct CachedQuad
+    {
+        std::shared_ptr<Nova::Texture> Texture;
+        std::array<QuadVertex, 4> Vertices = {};
+
+        glm::vec2 Position = {0.0f, 0.0f};
+        glm::vec2 Scale = {0.0f, 0.0f};
+        Nova::Color Color = Nova::White;
+        float Rotation = 0.0f;
+        glm::vec2 Origin = {0.0f, 0.0f};
+        glm::vec4 SourceRect = glm::vec4(0.0f);
+    };
+
     void UpdateProjection(int width, int height);
+    glm::ivec2 GetViewportSize();
     void EnableMultisampling();
     void DisableMultisampling();
 
     void Init(int width, int height);
     void Shutdown();
 
+    // seconds on the clock GPU sprite animations run on, the same for the whole frame
+    float GetTime();
+
     void BeginFrame();
     void EndFrame();
 
+    // Sends the quads batched so far to the GPU, for code that draws with its own shaders
+    void Flush();
+
     void ClearScreen(const Color& color);
 
     void DrawQuad(const glm::vec2& position, const glm::vec2& scale, const Color& color, float rotation = 0.0f,
@@ -34,12 +89,52 @@ namespace Nova::Renderer
     void DrawQuad(std::shared_ptr<Texture> texture, const glm::vec4& sourceRect, const glm::vec2& position,
                   const Color& color, float rotation, const glm::vec2& origin);
 
+    // paletteRow picks the palette of indexed textures (see Texture::SetPalette), and is ignored by the others
     void DrawQuad(std::shared_ptr<Texture> texture, const glm::vec2& position, const glm::vec2& scale,
-                  const Color& color, float rotation, const glm::vec2& origin, const glm::vec4& sourceRect);
+                  const Color& color, float rotation, const glm::vec2& origin, const glm::vec4& sourceRect,
+                  uint32_t paletteRow = 0);
+
+    // Same parameters as DrawQuad, but the quad is built into quad instead of being drawn
+    void BuildQuad(CachedQuad& quad, const glm::vec2& position, const glm::vec2& scale, const Color& color,
+                   float rotation = 0.0f, const glm::vec2& origin = {0.0f, 0.0f});
+
+    void BuildQuad(CachedQuad& quad, std::shared_ptr<Texture> texture, const glm::vec2& position,
+                   const glm::vec2& scale, const Color& color, float rotation, const glm::vec2& origin,
+                   const glm::vec4& sourceRect, uint32_t paletteRow = 0);
+
+    // quads that were never built are skipped
+    void DrawQuad(const CachedQuad& quad);
+
+    // Draws a virtual texture as an axis aligned quad of size texture.GetSize() * scale, flushing the quad batch first
+    // so the draw order is kept. Only the visible part of the quad has its tiles streamed in.
+    void DrawQuad(VirtualTexture& texture, const glm::vec2& position, const glm::vec2& scale = {1.0f, 1.0f},
+                  const Color& color = Nova::White);
 
     void DrawSprite(const Sprite& sprite, const glm::vec2& position, float rotation = 0.0f,
                     const glm::vec2& origin = {0.0f, 0.0f});
 
     void DrawSprite(const Sprite& sprite, const glm::vec2& position, const glm::vec2& scale, float rotation = 0.0f,
                     const glm::vec2& origin = {0.0f, 0.0f});
+
+    // instances without a sheet are skipped
+    void DrawSprite(const SpriteInstance& sprite, const glm::vec2& position, const glm::vec2& scale,
+                    float rotation = 0.0f, const glm::vec2& origin = {0.0f, 0.0f});
+
+    // the frame is picked by the vertex shader from GetTime, see GPUSpriteAnimation
+    void DrawSprite(const GPUSpriteAnimation& sprite, const glm::vec2& position, const glm::vec2& scale,
+                    float rotation = 0.0f, const glm::vec2& origin = {0.0f, 0.0f});
+
+    // Shapes are drawn as signed distance fields in the quad batch, so they don't break batches with sprites.
+    // Outlines grow inwards from the shape edge, a thickness of 0 fills the shape.
+    void DrawCircle(const glm::vec2& center, float radius, const Color& color);
+    void DrawRing(const glm::vec2& center, float radius, float thickness, const Color& color);
+    void DrawLine(const glm::vec2& start, const glm::vec2& end, float thickness, const Color& color);
+    void DrawRoundedRect(const glm::vec2& position, const glm::vec2& size, float cornerRadius, const Color& color,
+                         float rotation = 0.0f, float outlineThickness = 0.0f);
+
+    // Submits all live particles of the emitter to the quad batch in bulk
+    void DrawParticles(const ParticleEmitter& emitter);
+
+    // Draws a GPU simulated emitter, flushing the quad batch first so the draw order is kept
+    void DrawParticles(const GPUParticleEmitter& emitter);
 } // namespace Nova::Renderer
@@ -3,6 +3,8 @@
 #include "Nova/Misc/StringHash.hpp"
 
 #include <cstdint>
+#include <initializer_list>
+#include <string>
 #include <string_view>
 #include <filesystem>
 #include <unordered_map>
@@ -19,6 +21,8 @@ namespace Nova
         bool InitFromFile(const std::filesystem::path& fragmentPath);
         bool InitFromFiles(const std::filesystem::path& vertexPath, const std::filesystem::path& fragmentPath);
         bool Init(const std::string_view& vertexSource, const std::string_view& fragmentSource);
+        // vertex-only program whose outputs are captured (interleaved) with transform feedback
+        bool InitTransformFeedback(const std::string_view& vertexSource, std::initializer_list<const char*> varyings);
         void Shutdown();
 
         Shader(const Shader&) = delete;
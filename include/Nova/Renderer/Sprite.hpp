@@ -78,9 +78,10 @@ namespace Nova
 
     public:
         bool FlipX = false;
+        uint32_t PaletteRow = 0; // for indexed textures
 
     private:
-        void CalculateCurrentPosition() noexcept;
+        void CalculateCurrentPosition(const std::vector<uint32_t>& currentFrames) noexcept;
 
     private:
         bool m_Loop = true;
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Nova/Asset/Assets.hpp"
+#include "Nova/Misc/StringHash.hpp"
+#include "Nova/Renderer/Sprite.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace Nova
+{
+    using SpriteClipID = uint32_t;
+
+    static constexpr SpriteClipID INVALID_SPRITE_CLIP = UINT32_MAX;
+
+    struct SpriteClip
+    {
+        uint32_t FirstFrame = 0; // into the frames of every clip of the sheet
+        uint32_t FrameCount = 0;
+        float FrameTime = 1.0f;
+        bool Loop = true;
+        bool Consecutive = true; // frames are consecutive cells, which GPU animation requires
+    };
+
+    class SpriteSheet;
+
+    // Sprite animated by the quad vertex shader from the Renderer::GetTime clock, so it costs nothing on the CPU
+    // between draws. The clip has to be made of consecutive cells, other clips are animated on the CPU when drawn.
+    struct GPUSpriteAnimation
+    {
+        const SpriteSheet* Sheet = nullptr;
+        SpriteClipID Clip = INVALID_SPRITE_CLIP;
+        float StartTime = 0.0f; // Renderer::GetTime() when the clip started
+        uint32_t PaletteRow = 0;
+        bool FlipX = false;
+    };
+
+    // Per entity state of an animated sprite, the frames and clips live in the shared sheet,
+    // which has to outlive the instance.
+    struct SpriteInstance
+    {
+        const SpriteSheet* Sheet = nullptr;
+        SpriteClipID Clip = INVALID_SPRITE_CLIP;
+        uint32_t Frame = 0; // index into the frames of the clip
+        float Timer = 0.0f;
+        uint32_t PaletteRow = 0; // for indexed textures
+        bool FlipX = false;
+    };
+
+    // Frames and animation clips of a sprite texture, shared by every SpriteInstance that uses it. The source rect of
+    // every cell is computed once, and clips are looked up by name only when setting up, then referred to by ID.
+    // Add the clips before the sheet is shared, it isn't meant to change afterwards.
+    class SpriteSheet
+    {
+    public:
+        SpriteSheet() = default;
+        SpriteSheet(const SpriteConfig& config);
+
+        // frames are cell indices, row by row. frameTime defaults to the AnimationTick of the config.
+        SpriteClipID AddClip(const std::string_view& name, std::span<const uint32_t> frames, bool loop = true,
+                             float frameTime = 0.0f);
+        // frameCount consecutive cells from firstCell
+        SpriteClipID AddClip(const std::string_view& name, uint32_t firstCell, uint32_t frameCount, bool loop = true,
+                             float frameTime = 0.0f);
+
+        SpriteClipID FindClip(const std::string_view& name) const;
+
+        // switches instance to clip, from its first frame unless it's already playing it and restart is false
+        void Play(SpriteInstance& instance, SpriteClipID clip, bool restart = false) const noexcept;
+        void Update(SpriteInstance& instance, float deltaTime) const noexcept;
+
+        // Update over contiguous instances of any sheets, as a SIMD kernel on the timers. Runs on the calling thread,
+        // big arrays are meant to be split across the job system by the caller (see SpriteSystem).
+        static void UpdateInstances(SpriteInstance* instances, uint32_t count, float deltaTime) noexcept;
+        // same, with a delta time per instance (see AnimationLODComponent)
+        static void UpdateInstances(SpriteInstance* instances, const float* deltaTimes, uint32_t count) noexcept;
+
+        // source rect in texels of the frame instance is showing, the first cell when it plays no clip
+        const glm::vec4& GetSourceRect(const SpriteInstance& instance) const noexcept;
+
+        const TextureAsset& GetTexture() const noexcept
+        {
+            return m_Texture;
+        }
+
+        glm::vec2 GetFrameSize() const noexcept
+        {
+            return m_FrameSize;
+        }
+
+        uint32_t GetColumnCount() const noexcept
+        {
+            return m_Columns;
+        }
+
+        const glm::vec4& GetCellRect(uint32_t cell) const noexcept
+        {
+            return m_CellRects[cell];
+        }
+
+        // cell of frame of a clip
+        uint32_t GetClipCell(SpriteClipID clip, uint32_t frame) const noexcept
+        {
+            return m_ClipFrames[m_Clips[clip].FirstFrame + frame];
+        }
+
+        uint32_t GetClipCount() const noexcept
+        {
+            return (uint32_t) m_Clips.size();
+        }
+
+        const SpriteClip& GetClip(SpriteClipID clip) const noexcept
+        {
+            return m_Clips[clip];
+        }
+
+    private:
+        static void AdvanceInstances(SpriteInstance* instances, const float* deltaTimes, float deltaTime,
+                                     uint32_t count) noexcept;
+
+    private:
+        TextureAsset m_Texture;
+        glm::vec2 m_FrameSize = {0.0f, 0.0f};
+        float m_FrameTime = 1.0f;
+        uint32_t m_Columns = 1;
+
+        std::vector<glm::vec4> m_CellRects;
+        std::vector<uint32_t> m_ClipFrames;
+        std::vector<SpriteClip> m_Clips;
+        std::unordered_map<std::string, SpriteClipID, StringHash, std::equal_to<>> m_ClipIDs;
+    };
+} // namespace Nova
@@ -1,18 +1,55 @@
 #pragma once
 
 #include "Nova/Misc/Color.hpp"
+#include "Nova/Misc/MappedFile.hpp"
+#include "Nova/Renderer/CookedTexture.hpp"
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+#include <glm/vec4.hpp>
 
 namespace Nova
 {
+    // colors in a row of a palette texture
+    static constexpr uint32_t PALETTE_SIZE = 256;
+
     enum class TextureFilter : uint8_t
     {
         Nearest,
         Linear
     };
 
+    // CPU side of a texture. Decoding touches no GL state, so it can run on any thread, the result is then
+    // uploaded with Texture::Init on the GL thread.
+    struct TextureData
+    {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        CookedTextureFormat Format = CookedTextureFormat::RGBA8;
+        uint8_t Flags = CookedTextureFlags_None;
+        std::vector<CookedTextureMip> Mips;
+
+        MappedFile File;                 // kept open for cooked textures, which are uploaded straight from the mapping
+        std::span<const uint8_t> Source; // mip data of cooked textures
+        std::vector<uint8_t> Pixels;     // decoded images, with rows padded to 4 bytes
+
+        bool Decode(const std::filesystem::path& path);
+        // decodes a file already in memory, path is only used for its extension and for logging.
+        // Cooked textures keep pointing into bytes, which must outlive the TextureData.
+        bool Decode(std::span<const uint8_t> bytes, const std::filesystem::path& path);
+        const uint8_t* GetMipData(uint32_t level) const;
+
+        // BC1/BC3 expanded to RGBA8, for drivers without S3TC
+        TextureData DecompressS3TC() const;
+
+        // Turns RGBA8 pixels into R8 indices into palette, appending the colors it doesn't have yet.
+        // Fails, leaving everything untouched, when the palette would go over PALETTE_SIZE colors.
+        bool Palettize(std::vector<Color>& palette);
+    };
+
     class Texture
     {
     public:
@@ -24,10 +61,51 @@ namespace Nova
         Texture& operator=(const Texture&) = delete;
         Texture& operator=(Texture&&) noexcept = delete;
 
+        // .ntex files are cooked textures (see CookedTexture.hpp) and are uploaded straight from a file mapping,
+        // QOI, uncompressed TGA and binary PNM go through ImageCodecs and anything else is decoded with stb_image
         bool Init(const std::filesystem::path& path);
         bool Init(uint32_t width, uint32_t height, const Color* data);
+        bool Init(const TextureData& data);
         void Shutdown();
 
+        // Creates the texture and allocates every mip of data without uploading any pixels, which are then sent
+        // with UploadRows (see TextureUploader). Formats the driver doesn't support must be converted beforehand.
+        bool InitStorage(const TextureData& data);
+
+        // Uploads rows [firstRow, firstRow + rowCount) of a mip, for compressed formats rows are rows of 4x4 blocks.
+        // pixels is an offset into the bound pixel unpack buffer when there is one.
+        void UploadRows(uint32_t level, uint32_t firstRow, uint32_t rowCount, const void* pixels);
+
+        // Uploads a rect (x, y, width, height) of mip 0, uncompressed formats only. Rows of pixels are rowLength
+        // texels apart (the rect width when 0) and have no padding. pixels is an offset into the bound pixel unpack
+        // buffer when there is one. The other mips are left as they are, see GenerateMips.
+        void UploadRegion(const glm::uvec4& rect, const void* pixels, uint32_t rowLength = 0);
+        // rebuilds every mip from mip 0 on the GPU
+        void GenerateMips();
+
+        // Replaces a rect (x, y, width, height) of the texture right away, pixels are tightly packed rows in the
+        // texture format. Uncompressed formats only.
+        void Update(const glm::uvec4& rect, const void* pixels);
+
+        // Like Update, but the pixels go to a CPU copy of the texture (read back on the first write) and writes are
+        // coalesced into one upload of their bounding rect. Pending writes are uploaded by FlushWrites, which the
+        // Renderer calls when the texture is drawn, or through the staging buffers with TextureUploader::EnqueueWrites.
+        void Write(const glm::uvec4& rect, const void* pixels);
+        void FlushWrites();
+
+        // Copies the bounding rect of the pending writes into pixels as tightly packed rows and returns it, for
+        // uploading them later. Until EndQueuedWrites is called, newer writes and updates stay pending instead of
+        // being uploaded, so the older queued pixels can't land on top of them.
+        glm::uvec4 TakeWrites(std::vector<uint8_t>& pixels);
+        void EndQueuedWrites();
+
+        bool HasPendingWrites() const
+        {
+            return m_DirtyRect.z != 0;
+        }
+
+        static bool IsFormatSupported(CookedTextureFormat format);
+
         void SetFilter(TextureFilter filter);
         void Bind(uint32_t slot) const;
         void Unbind() const;
@@ -52,14 +130,48 @@ namespace Nova
             return m_Filter;
         }
 
-    private:
-        bool Init(int format, const void* data);
+        uint32_t GetMipCount() const
+        {
+            return m_MipCount;
+        }
+
+        // estimated GPU memory of every mip
+        uint64_t GetMemorySize() const;
+
+        // premultiplied textures are converted back to straight alpha by the quad shader after filtering
+        bool IsPremultiplied() const
+        {
+            return m_Premultiplied;
+        }
+
+        // Makes an R8 texture indexed: the quad shader reads its texels as indices into a row of palette, a
+        // PALETTE_SIZE wide RGBA8 texture with one palette per row that is picked per draw. Filtering is switched to
+        // nearest, indices can't be interpolated. Shared by every texture drawn with the same set of palettes.
+        void SetPalette(std::shared_ptr<Texture> palette);
+
+        const std::shared_ptr<Texture>& GetPalette() const
+        {
+            return m_Palette;
+        }
+
+        bool IsIndexed() const
+        {
+            return m_Palette != nullptr;
+        }
 
     private:
         uint32_t m_ID = 0;
         int m_Width = 0;
         int m_Height = 0;
         int m_Channels = 0;
+        CookedTextureFormat m_Format = CookedTextureFormat::RGBA8;
+        uint32_t m_MipCount = 1;
+        bool m_Premultiplied = false;
         TextureFilter m_Filter = TextureFilter::Linear;
+        std::shared_ptr<Texture> m_Palette;
+
+        std::vector<uint8_t> m_WriteBuffer; // CPU copy of mip 0 for Write
+        glm::uvec4 m_DirtyRect = {0, 0, 0, 0};
+        uint32_t m_QueuedWrites = 0;
     };
 } // namespace Nova
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Nova/Renderer/Texture.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Streams texture pixels to the GPU over several frames. Pixels are copied into a ring of pixel unpack buffers and
+// uploaded in bands of rows, at most FrameBudget bytes per frame, so a big texture doesn't stall a single frame.
+// A staging buffer is reused only once the GPU is done reading it (checked with a fence, never waited on).
+namespace Nova::TextureUploader
+{
+    using UploadCallback = std::function<void(bool success)>;
+
+    static constexpr uint32_t DEFAULT_FRAME_BUDGET = 4 << 20;
+    static constexpr uint32_t DEFAULT_STAGING_BUFFER_SIZE = 1 << 20;
+    static constexpr uint32_t DEFAULT_STAGING_BUFFER_COUNT = 4;
+
+    void Init(uint32_t frameBudget = DEFAULT_FRAME_BUDGET, uint32_t stagingBufferSize = DEFAULT_STAGING_BUFFER_SIZE,
+              uint32_t stagingBufferCount = DEFAULT_STAGING_BUFFER_COUNT);
+
+    // pending uploads are dropped without calling their callbacks
+    void Shutdown();
+
+    void SetFrameBudget(uint32_t bytes);
+    uint32_t GetFrameBudget();
+
+    // Allocates the texture right away and queues its pixels, onDone is called on the main thread once every mip is
+    // uploaded (or with false if the texture couldn't be created). data is kept alive until then.
+    // Without Init the upload happens immediately.
+    void Enqueue(std::shared_ptr<Texture> texture, std::shared_ptr<const TextureData> data,
+                 UploadCallback onDone = {});
+
+    // Sends the pending writes of texture (see Texture::Write) through the staging buffers, ahead of the queued
+    // textures. onDone is called once they are all uploaded. Without Init the writes are flushed immediately.
+    void EnqueueWrites(std::shared_ptr<Texture> texture, UploadCallback onDone = {});
+
+    // Uploads row bands of the queued textures until the frame budget is spent. Called by the Renderer every frame.
+    void Update();
+
+    uint32_t GetPendingUploadCount();
+} // namespace Nova::TextureUploader
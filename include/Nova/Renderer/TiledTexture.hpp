@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Layout of .nvt tiled textures, shared by VirtualTexture and the nova_tile tool.
+// A file is a TiledTextureHeader, followed by LevelCount TiledTextureLevel entries and then every tile of every
+// level, all the same size. Level 0 is the full image and each level halves the previous one, down to a level that
+// fits in a single tile. Tiles are RGBA8 squares of TileSize texels plus a TILED_TEXTURE_BORDER texel border copied
+// from the neighbouring tiles (or clamped at the image edges), so they can be filtered on their own.
+namespace Nova
+{
+    static constexpr std::array<char, 4> TILED_TEXTURE_MAGIC = {'N', 'V', 'T', 'X'};
+    static constexpr uint32_t TILED_TEXTURE_VERSION = 1;
+    static constexpr uint32_t TILED_TEXTURE_MAX_LEVELS = 16;
+    static constexpr uint32_t TILED_TEXTURE_BORDER = 1;
+
+    struct TiledTextureHeader
+    {
+        std::array<char, 4> Magic;
+        uint32_t Version;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t TileSize;
+        uint32_t LevelCount;
+    };
+
+    struct TiledTextureLevel
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t TilesX;
+        uint32_t TilesY;
+        uint32_t FirstTile; // index of the top left tile of the level, tiles are stored row by row
+    };
+
+    constexpr uint32_t GetTiledTextureTileBytes(uint32_t tileSize) noexcept
+    {
+        const uint32_t side = tileSize + 2 * TILED_TEXTURE_BORDER;
+        return side * side * 4;
+    }
+
+    constexpr uint64_t GetTiledTextureTileOffset(uint32_t levelCount, uint32_t tileSize, uint32_t tile) noexcept
+    {
+        return sizeof(TiledTextureHeader) + (uint64_t) levelCount * sizeof(TiledTextureLevel) +
+               (uint64_t) tile * GetTiledTextureTileBytes(tileSize);
+    }
+} // namespace Nova
@@ -17,7 +17,11 @@ namespace Nova
         Int2,
         Int3,
         Int4,
-        Bool
+        Bool,
+        // packed types are read as unsigned integers by the shader, or as floats in [0, 1] when normalized
+        UByte4,
+        UShort2,
+        UShort4
     };
 
     struct VertexBufferElement
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Nova/Misc/Color.hpp"
+#include "Nova/Renderer/Shader.hpp"
+#include "Nova/Renderer/TiledTexture.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <glm/fwd.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+namespace Nova
+{
+    struct VirtualTextureConfig
+    {
+        uint32_t CacheTiles = 16;     // per side of the physical cache, clamped to GL_MAX_TEXTURE_SIZE
+        uint32_t UploadsPerFrame = 8; // tiles copied into the cache per Update
+        uint32_t MaxPendingLoads = 32;
+    };
+
+    struct VirtualTextureStreamState;
+
+    // Texture of any size backed by a .nvt file (see TiledTexture.hpp, made with nova_tile). Only the tiles visible
+    // in the draws of the previous frame are read from the file, on the job system, and copied into a fixed size
+    // cache texture, evicting the least recently used ones. An indirection texture with one texel per level 0 tile
+    // points the shader at the finest resident tile covering it, so missing tiles show a coarser level meanwhile.
+    // Call Update once per frame and draw it with Renderer::DrawQuad.
+    class VirtualTexture
+    {
+    public:
+        VirtualTexture() = default;
+        virtual ~VirtualTexture();
+
+        VirtualTexture(const VirtualTexture&) = delete;
+        VirtualTexture(VirtualTexture&&) = delete;
+        VirtualTexture& operator=(const VirtualTexture&) = delete;
+        VirtualTexture& operator=(VirtualTexture&&) = delete;
+
+        bool Init(const std::filesystem::path& path, const VirtualTextureConfig& config = {});
+        void Shutdown();
+
+        // streams in the tiles requested by the last frame draws and uploads the ones that finished loading
+        void Update();
+        // Draws the texture as an axis aligned quad of size GetSize() * scale and requests the tiles it needs.
+        // The mip level is picked from scale, the finest one among the draws of a frame is used for all of them.
+        void Draw(const glm::mat4& projection, const glm::vec2& position, const glm::vec2& scale, const Color& color);
+
+        bool IsInitialized() const noexcept
+        {
+            return m_CacheTexture != 0;
+        }
+
+        glm::vec2 GetSize() const noexcept
+        {
+            return {(float) m_Width, (float) m_Height};
+        }
+
+        uint32_t GetLevelCount() const noexcept
+        {
+            return (uint32_t) m_Levels.size();
+        }
+
+        uint32_t GetResidentTileCount() const noexcept
+        {
+            return m_ResidentTiles;
+        }
+
+    private:
+        struct TileState
+        {
+            int32_t Slot = -1;
+            bool Pending = false;
+        };
+
+        struct CacheSlot
+        {
+            uint32_t Tile = UINT32_MAX;
+            uint64_t LastUsed = 0;
+        };
+
+        void RequestTiles(const glm::vec4& rect);
+        void UploadTile(uint32_t tile, int32_t slot, const uint8_t* pixels);
+        int32_t FindFreeSlot() const;
+        void EvictSlot(int32_t slot);
+        uint32_t GetTileLevel(uint32_t tile) const;
+        void RefreshFootprint(uint32_t tile);
+        void RefreshEntry(uint32_t x, uint32_t y);
+
+    private:
+        VirtualTextureConfig m_Config;
+        uint32_t m_Width = 0;
+        uint32_t m_Height = 0;
+        uint32_t m_TileSize = 0;
+        std::vector<TiledTextureLevel> m_Levels;
+
+        std::shared_ptr<VirtualTextureStreamState> m_Stream;
+        std::vector<TileState> m_Tiles;
+        std::vector<CacheSlot> m_Slots;
+        uint32_t m_CacheTiles = 0;
+        uint32_t m_ResidentTiles = 0;
+        uint32_t m_PendingLoads = 0;
+        uint64_t m_Frame = 0;
+
+        // level used by the shader, and the finest one asked for by the draws since the last Update
+        uint32_t m_Level = 0;
+        uint32_t m_RequestedLevel = UINT32_MAX;
+        std::vector<glm::vec4> m_VisibleRects;
+
+        std::vector<uint8_t> m_Indirection;
+        bool m_IndirectionDirty = false;
+
+        uint32_t m_CacheTexture = 0;
+        uint32_t m_IndirectionTexture = 0;
+        uint32_t m_VertexArray = 0;
+        uint32_t m_CornerBuffer = 0;
+        Shader m_Shader;
+    };
+} // namespace Nova
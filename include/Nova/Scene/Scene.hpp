@@ -1,11 +1,18 @@
 #pragma once
 
+#include "Nova/Core/JobSystem.hpp"
 #include "Nova/Misc/Easings.hpp"
 #include "Nova/ECS/RendererSystem.hpp"
 #include "Nova/ECS/SpriteSystem.hpp"
+#include "Nova/ECS/ParticleSystem.hpp"
+#include "Nova/ECS/TransformSystem.hpp"
+#include "Nova/ECS/SpatialSystem.hpp"
+#include "Nova/ECS/PhysicsSystem.hpp"
+#include "Nova/ECS/SystemScheduler.hpp"
 
 #include <vector>
 #include <memory>
+#include <utility>
 #include <entt/entity/registry.hpp>
 
 namespace Nova
@@ -34,6 +41,7 @@ namespace Nova
         void AddSystem(Args&&... args)
         {
             m_Systems.emplace_back(std::make_unique<SystemT>(this, std::forward<Args>(args)...));
+            m_Scheduler.Add(m_Systems.back().get());
         }
 
         template<typename SystemT, typename... Args>
@@ -49,17 +57,108 @@ namespace Nova
         template<typename... Components>
         auto GetEntitiesWith()
         {
+#ifdef NOVA_DEBUG
+            (SystemScheduler::CheckAccess<Components>(), ...);
+#endif
             return m_Registry.view<Components...>();
         }
 
         template<typename... Components>
         auto GetEntitiesWith() const
         {
+#ifdef NOVA_DEBUG
+            (SystemScheduler::CheckAccess<Components>(), ...);
+#endif
             return m_Registry.view<Components...>();
         }
 
+        // same, skipping the entities with any of the Excluded components
+        template<typename... Components, typename... Excluded>
+        auto GetEntitiesWith(entt::exclude_t<Excluded...> exclude)
+        {
+#ifdef NOVA_DEBUG
+            (SystemScheduler::CheckAccess<Components>(), ...);
+            (SystemScheduler::CheckAccess<const Excluded>(), ...);
+#endif
+            return m_Registry.view<Components...>(exclude);
+        }
+
+        // Calls fn(components...) for every entity with the components, like GetEntitiesWith<Components...>().each(fn),
+        // with the entities split across the job system in chunks of grainSize. The chunks run at the same time, so fn
+        // must only touch the components of its entity.
+        template<typename... Components, typename Fn>
+        void ParallelEach(const Fn& fn, uint32_t grainSize = 1024)
+        {
+            auto view = GetEntitiesWith<Components...>();
+            const auto* leading = view.handle();
+
+            if (!leading)
+                return;
+
+            const entt::entity* entities = leading->data();
+#ifdef NOVA_DEBUG
+            const SystemAccess* access = SystemScheduler::GetRunningAccess();
+#endif
+
+            JobSystem::ParallelFor((uint32_t) leading->size(), grainSize, [&](uint32_t begin, uint32_t end) {
+#ifdef NOVA_DEBUG
+                // the chunks running on workers are checked against the access of the calling system too
+                SystemScheduler::AccessScope scope(access);
+#endif
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    if (view.contains(entities[i]))
+                        fn(view.template get<Components>(entities[i])...);
+                }
+            });
+        }
+
+        // contiguous storage of a component, const for read only access
+        template<typename Component>
+        auto& GetStorage()
+        {
+#ifdef NOVA_DEBUG
+            SystemScheduler::CheckAccess<Component>();
+#endif
+            if constexpr (std::is_const_v<Component>)
+                return std::as_const(m_Registry.storage<std::remove_const_t<Component>>());
+            else
+                return m_Registry.storage<Component>();
+        }
+
+        TransformSystem& GetTransformSystem()
+        {
+            return m_TransformSystem;
+        }
+
+        SpatialSystem& GetSpatialSystem()
+        {
+            return m_SpatialSystem;
+        }
+
+        PhysicsSystem& GetPhysicsSystem()
+        {
+            return m_PhysicsSystem;
+        }
+
+        // bodies of the entities with a RigidBodyComponent, the user data of the bodies is the entity
+        PhysicsWorld& GetPhysicsWorld()
+        {
+            return m_PhysicsSystem.GetWorld();
+        }
+
+        // Entities with a SpatialComponent, where they were at the end of the last frame. The user data of the results
+        // is the entity, entt::entity{userData}.
+        const SpatialHash& GetSpatialIndex() const
+        {
+            return m_SpatialSystem.GetIndex();
+        }
+
         entt::registry& GetRegistry()
         {
+#ifdef NOVA_DEBUG
+            SystemScheduler::CheckRegistryAccess();
+#endif
             return m_Registry;
         }
 
@@ -77,8 +176,13 @@ namespace Nova
 
     private:
         SpriteSystem m_SpriteSystem;
+        ParticleSystem m_ParticleSystem;
+        TransformSystem m_TransformSystem;
+        SpatialSystem m_SpatialSystem;
+        PhysicsSystem m_PhysicsSystem;
         std::unique_ptr<RendererSystem> m_RendererSystem;
         std::vector<std::unique_ptr<System>> m_Systems;
+        SystemScheduler m_Scheduler;
         std::vector<Easing> m_Easings;
         entt::registry m_Registry;
 
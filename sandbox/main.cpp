@@ -38,8 +38,10 @@
 using Direction = float;
 
 // This class defines a simple movement system that moves entities based on their direction
-// making them bounce between the top and bottom of the screen
-class MovementSystem : public Nova::System
+// making them bounce between the top and bottom of the screen.
+// It declares the components it writes (and reads, none here), so the scene can run it
+// on the job system alongside other systems that don't touch them
+class MovementSystem : public Nova::ParallelSystem<Nova::Read<>, Nova::Write<Nova::QuadTransform, Direction>>
 {
 public:
     // This is the base speed of the movement
@@ -48,20 +50,20 @@ public:
     // Inherit the constructor from the base class
     // This allows us to use the base class constructor
     // so you don't need to write it yourself
-    using Nova::System::System;
+    using ParallelSystem::ParallelSystem;
 
     // This function gets called every frame
     // Here we move the entities based on their direction
     void Update(float deltaTime) override
     {
-        // First, we get all the entities with the QuadTransform and Direction components
-        auto entities = m_ParentScene->GetEntitiesWith<Nova::QuadTransform, Direction>();
-
-        // Then, we get a reference to the window (we need it to get the window height)
+        // First, we get a reference to the window (we need it to get the window height)
         const auto& window = Nova::App::Get().GetWindow();
 
-        // Finally, we process each entity (the parameters are the components of the entity)
-        entities.each([deltaTime, &window](Nova::QuadTransform& transform, Direction& direction) {
+        // Then, we process each entity with the QuadTransform and Direction components (the parameters are the
+        // components of the entity). ParallelEach splits them across the cores, GetEntitiesWith<...>().each(...)
+        // would process them one after the other
+        m_ParentScene->ParallelEach<Nova::QuadTransform, Direction>([deltaTime, &window](Nova::QuadTransform& transform,
+                                                                                         Direction& direction) {
             // Check if the entity has reached the top or bottom of the screen
             // If it has, reverse the direction
 
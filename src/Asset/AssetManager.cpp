@@ -1,27 +1,47 @@
 #include "Nova/Asset/AssetManager.hpp"
+#include "Nova/Core/Epoch.hpp"
+#include "Nova/Core/JobSystem.hpp"
+#include "Nova/Renderer/TextureUploader.hpp"
 #include "Nova/Misc/Assert.hpp"
 #include "Nova/Misc/Logger.hpp"
+#include "Nova/Misc/Hash.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <type_traits>
 
 namespace Nova
 {
     static AssetManager* s_Instance = nullptr;
 
-    AssetManager::AssetManager()
+    // Calls onTexture and onShader with the name and path of every file in the textures/ and shaders/ subdirectories.
+    // When the directory was packed, the files are listed from the pak index instead.
+    template<typename TextureFn, typename ShaderFn>
+    static void ForEachDirectoryAsset(const std::filesystem::path& path, const AssetPak* pak, TextureFn&& onTexture,
+                                      ShaderFn&& onShader)
     {
-        NOVA_ASSERT(!s_Instance, "AssetManager already created!");
-        s_Instance = this;
-    }
+        if (pak)
+        {
+            for (const AssetPakEntry& entry : pak->GetEntries())
+            {
+                const std::filesystem::path name(pak->GetName(entry));
+                const std::string directory = name.parent_path().generic_string();
 
-    void AssetManager::Shutdown()
-    {
-        m_Shaders.clear();
-        m_Textures.clear();
-        m_Sounds.clear();
-        m_Musics.clear();
-    }
+                if (directory == "textures")
+                {
+                    if (name.extension() != ".ntex" &&
+                        pak->Find(std::filesystem::path(name).replace_extension(".ntex").generic_string()))
+                        continue;
+
+                    onTexture(name.stem().string(), path / name);
+                }
+                else if (directory == "shaders")
+                    onShader(name.stem().string(), path / name);
+            }
+
+            return;
+        }
 
-    void AssetManager::LoadFromDirectory(const std::filesystem::path& path)
-    {
         if (!std::filesystem::is_directory(path))
         {
             Logger::Warning("{} is not a directory! Skipping...", path.string());
@@ -33,7 +53,13 @@ namespace Nova
             for (const auto& entry : std::filesystem::directory_iterator(path / "textures"))
             {
                 const auto& entryPath = entry.path();
-                LoadTexture(entryPath.stem().string(), entryPath);
+
+                // prefer the cooked version of a texture when there is one
+                if (entryPath.extension() != ".ntex" &&
+                    std::filesystem::exists(std::filesystem::path(entryPath).replace_extension(".ntex")))
+                    continue;
+
+                onTexture(entryPath.stem().string(), entryPath);
             }
         }
 
@@ -42,116 +68,1073 @@ namespace Nova
             for (const auto& entry : std::filesystem::directory_iterator(path / "shaders"))
             {
                 const auto& entryPath = entry.path();
-                LoadShader(entryPath.stem().string(), entryPath);
+                onShader(entryPath.stem().string(), entryPath);
             }
         }
     }
 
-    void AssetManager::LoadTexture(const std::string_view& name, const std::filesystem::path& path)
+    // "assets/" and "assets" are the same root
+    static std::filesystem::path NormalizeRoot(const std::filesystem::path& path)
+    {
+        std::filesystem::path root = path.lexically_normal();
+        return root.has_filename() ? root : root.parent_path();
+    }
+
+    template<typename T>
+    static uint64_t EstimateMemorySize(const T& asset)
     {
-        if (m_Textures.contains(name))
+        // shaders are small enough not to be tracked
+        if constexpr (requires { asset.GetMemorySize(); })
+            return asset.GetMemorySize();
+        else
+            return 0;
+    }
+
+    template<typename T>
+    static constexpr const char* GetAssetKind()
+    {
+        if constexpr (std::is_same_v<T, Texture>)
+            return "Texture";
+        else if constexpr (std::is_same_v<T, Shader>)
+            return "Shader";
+        else if constexpr (std::is_same_v<T, Sound>)
+            return "Sound";
+        else
+            return "Music";
+    }
+
+    template<typename T>
+    static const AssetHandle<T>& GetEmptyHandle()
+    {
+        static const AssetHandle<T> s_Empty;
+        return s_Empty;
+    }
+
+    // Index of the entry holding the asset of id, following aliases. With a name, an entry registered under another
+    // name with the same ID isn't a match.
+    static uint32_t FindIndex(const auto& table, AssetID id, const std::string_view& name = {})
+    {
+        auto it = table.Indices.find(id);
+
+        if (it == std::end(table.Indices))
+            return INVALID_ASSET_INDEX;
+
+        const auto& entry = table.Entries[it->second];
+
+        if (!name.empty() && entry.Name != name)
+            return INVALID_ASSET_INDEX;
+
+        return (entry.Alias != INVALID_ASSET_INDEX) ? entry.Alias : it->second;
+    }
+
+    // index of an entry other than exclude that holds an asset with the same content
+    static uint32_t FindContentOwner(const auto& table, uint64_t hash, uint32_t exclude)
+    {
+        if (hash == 0)
+            return INVALID_ASSET_INDEX;
+
+        for (uint32_t i = 0; i < table.Entries.size(); ++i)
         {
-            Logger::Warning("Texture with name {} already exists! Skipping...", name);
-            return;
+            const auto& entry = table.Entries[i];
+
+            if (entry.ContentHash == hash && entry.Alias == INVALID_ASSET_INDEX && i != exclude)
+                return i;
         }
 
-        Logger::Info("Loading texture {} ({})...", name, path.string());
+        return INVALID_ASSET_INDEX;
+    }
+
+    static bool InitAsset(Texture& texture, std::span<const uint8_t> bytes, const std::filesystem::path& path)
+    {
+        TextureData data;
+        return data.Decode(bytes, path) && texture.Init(data);
+    }
+
+    static bool InitAsset(Shader& shader, std::span<const uint8_t> bytes, const std::filesystem::path&)
+    {
+        return shader.Init("", std::string(std::begin(bytes), std::end(bytes)));
+    }
+
+    static bool DecodeWave(std::span<const uint8_t> bytes, const std::filesystem::path& path, ::Wave& wave)
+    {
+        wave = LoadWaveFromMemory(path.extension().string().c_str(), bytes.data(), (int) bytes.size());
+
+        if (!IsWaveReady(wave))
+        {
+            Logger::Warning("Failed to load sound: {}", path.string());
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool InitAsset(Sound& sound, std::span<const uint8_t> bytes, const std::filesystem::path& path)
+    {
+        ::Wave wave;
+
+        if (!DecodeWave(bytes, path, wave))
+            return false;
+
+        bool ok = sound.Init(wave);
+        UnloadWave(wave);
+
+        return ok;
+    }
+
+    static bool InitAsset(Music& music, std::span<const uint8_t> bytes, const std::filesystem::path& path)
+    {
+        return music.Init(std::vector<uint8_t>(std::begin(bytes), std::end(bytes)), path.extension().string());
+    }
+
+    AssetManager::AssetManager()
+    {
+        NOVA_ASSERT(!s_Instance, "AssetManager already created!");
+        s_Instance = this;
+    }
+
+    void AssetManager::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_LoadMutex);
+
+            for (const auto& load : m_QueuedLoads)
+                load->Status->State.store(AssetState::Cancelled, std::memory_order_release);
+
+            // decoded, but never finished by an Update
+            for (const auto& load : m_DecodedLoads)
+                load->Status->State.store(AssetState::Cancelled, std::memory_order_release);
+
+            m_QueuedLoads.clear();
+            m_DecodedLoads.clear();
+            m_InFlightLoads = 0;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_PakMutex);
+            m_Paks.clear();
+        }
+
+        ClearTable(m_Shaders);
+        ClearTable(m_Textures);
+        ClearTable(m_Sounds);
+        ClearTable(m_Musics);
+
+        Epoch::Collect();
+    }
+
+    bool AssetManager::MountPak(const std::filesystem::path& pakPath, const std::filesystem::path& root)
+    {
+        auto pak = std::make_shared<AssetPak>();
+
+        if (!pak->Open(pakPath))
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_PakMutex);
+        m_Paks.push_back({NormalizeRoot(root), std::move(pak)});
+
+        return true;
+    }
+
+    std::shared_ptr<const AssetPak> AssetManager::MountDirectoryPak(const std::filesystem::path& directory)
+    {
+        const std::filesystem::path root = NormalizeRoot(directory);
+
+        {
+            std::lock_guard<std::mutex> lock(m_PakMutex);
+
+            for (const MountedPak& mounted : m_Paks)
+            {
+                if (mounted.Root == root)
+                    return mounted.Pak;
+            }
+        }
+
+        std::filesystem::path pakPath = root;
+        pakPath += ".novapak";
+
+        if (!std::filesystem::is_regular_file(pakPath) || !MountPak(pakPath, root))
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(m_PakMutex);
+        return m_Paks.back().Pak;
+    }
+
+    bool AssetManager::ReadAsset(const std::filesystem::path& path, AssetBytes& bytes) const
+    {
+        const std::filesystem::path normalized = path.lexically_normal();
+        const AssetPakEntry* entry = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(m_PakMutex);
+
+            for (const MountedPak& mounted : m_Paks)
+            {
+                const std::filesystem::path relative = normalized.lexically_relative(mounted.Root);
 
-        TextureAsset texture(std::make_shared<Texture>());
+                if (relative.empty() || *std::begin(relative) == "..")
+                    continue;
 
-        if (!texture->Init(path))
+                if ((entry = mounted.Pak->Find(relative.generic_string())))
+                {
+                    bytes.Pak = mounted.Pak;
+                    break;
+                }
+            }
+        }
+
+        if (entry)
+        {
+            bytes.Data = bytes.Pak->Read(*entry, bytes.Storage);
+            return !bytes.Data.empty();
+        }
+
+        if (!bytes.File.Open(path))
+            return false;
+
+        bytes.Data = bytes.File.GetSpan();
+        return true;
+    }
+
+    void AssetManager::LoadFromDirectory(const std::filesystem::path& path)
+    {
+        ForEachDirectoryAsset(
+            path, MountDirectoryPak(path).get(),
+            [this](const std::string& name, const std::filesystem::path& file) {
+                LoadTexture(name, file);
+            },
+            [this](const std::string& name, const std::filesystem::path& file) {
+                LoadShader(name, file);
+            });
+    }
+
+    void AssetManager::LoadFromDirectoryAsync(const std::filesystem::path& path, AssetPriority priority)
+    {
+        ForEachDirectoryAsset(
+            path, MountDirectoryPak(path).get(),
+            [this, priority](const std::string& name, const std::filesystem::path& file) {
+                LoadTextureAsync(name, file, priority);
+            },
+            [this, priority](const std::string& name, const std::filesystem::path& file) {
+                LoadShaderAsync(name, file, priority);
+            });
+    }
+
+    void AssetManager::LoadTexture(const std::string_view& name, const std::filesystem::path& path)
+    {
+        const uint32_t index = RegisterAsset(m_Textures, name);
+
+        if (index == INVALID_ASSET_INDEX)
             return;
 
-        m_Textures.emplace(name, texture);
+        Logger::Info("Loading texture {} ({})...", name, path.string());
+
+        LoadAsset(m_Textures, index, path);
+        PublishTables();
     }
 
     void AssetManager::LoadShader(const std::string_view& name, const std::filesystem::path& fragmentPath)
     {
-        if (m_Shaders.contains(name))
-        {
-            Logger::Warning("Shader with name {} already exists! Skipping...", name);
+        const uint32_t index = RegisterAsset(m_Shaders, name);
+
+        if (index == INVALID_ASSET_INDEX)
             return;
-        }
 
         Logger::Info("Loading fragment shader {} ({})...", name, fragmentPath.string());
 
-        ShaderAsset shader(std::make_shared<Shader>());
+        LoadAsset(m_Shaders, index, fragmentPath);
+        PublishTables();
+    }
+
+    void AssetManager::LoadSound(const std::string_view& name, const std::filesystem::path& path)
+    {
+        const uint32_t index = RegisterAsset(m_Sounds, name);
 
-        if (!shader->InitFromFile(fragmentPath))
+        if (index == INVALID_ASSET_INDEX)
             return;
 
-        m_Shaders.emplace(name, shader);
+        Logger::Info("Loading sound {} ({})", name, path.string());
+
+        LoadAsset(m_Sounds, index, path);
+        PublishTables();
     }
 
-    void AssetManager::LoadSound(const std::string_view& name, const std::filesystem::path& path)
+    void AssetManager::LoadMusic(const std::string_view& name, const std::filesystem::path& path)
+    {
+        const uint32_t index = RegisterAsset(m_Musics, name);
+
+        if (index == INVALID_ASSET_INDEX)
+            return;
+
+        Logger::Info("Loading music {} ({})", name, path.string());
+
+        LoadAsset(m_Musics, index, path);
+        PublishTables();
+    }
+
+    // max heap on priority, FIFO between loads with the same priority
+    static constexpr auto CompareLoadPriority = [](const auto& a, const auto& b) {
+        if (a->Priority != b->Priority)
+            return a->Priority < b->Priority;
+
+        return a->Order > b->Order;
+    };
+
+    template<typename T>
+    uint32_t AssetManager::RegisterAsset(AssetTable<T>& table, const std::string_view& name)
     {
-        if (m_Sounds.contains(name))
+        const AssetID id(name);
+
+        if (auto it = table.Indices.find(id); it != std::end(table.Indices))
+        {
+            const std::string& existing = table.Entries[it->second].Name;
+
+            if (existing == name)
+                Logger::Warning("{} with name {} already exists! Skipping...", GetAssetKind<T>(), name);
+            else
+                Logger::Error("{} name {} has the same ID as {} ({:#018x})! Skipping...", GetAssetKind<T>(), name,
+                              existing, id.Hash);
+
+            return INVALID_ASSET_INDEX;
+        }
+
+        uint32_t index;
+
+        if (!table.FreeIndices.empty())
         {
-            Logger::Warning("Sound with name {} already exists! Skipping...", name);
+            index = table.FreeIndices.back();
+            table.FreeIndices.pop_back();
+        }
+        else
+        {
+            index = (uint32_t) table.Entries.size();
+            table.Entries.emplace_back();
+        }
+
+        table.Entries[index].Name = name;
+        table.Indices.emplace(id, index);
+        table.Dirty = true;
+
+        return index;
+    }
+
+    template<typename T>
+    void AssetManager::ReleaseAsset(AssetTable<T>& table, uint32_t index)
+    {
+        AssetEntry<T>& entry = table.Entries[index];
+        table.Indices.erase(AssetID(entry.Name));
+
+        // refs to the slot go stale
+        const uint32_t generation = entry.Generation + 1;
+        entry = AssetEntry<T>();
+        entry.Generation = generation;
+
+        table.FreeIndices.push_back(index);
+        table.Dirty = true;
+    }
+
+    template<typename T>
+    void AssetManager::LoadAsset(AssetTable<T>& table, uint32_t index, const std::filesystem::path& path)
+    {
+        AssetBytes bytes;
+
+        if (!ReadAsset(path, bytes))
+        {
+            ReleaseAsset(table, index);
             return;
         }
 
-        Logger::Info("Loading sound {} ({})", name, path.string());
+        AssetEntry<T>& entry = table.Entries[index];
+        entry.Path = path;
+        entry.ContentHash = HashFNV1a(bytes.Data);
+
+        if (const uint32_t owner = FindContentOwner(table, entry.ContentHash, index); owner != INVALID_ASSET_INDEX)
+        {
+            Logger::Info("{} has the same content as {}, sharing it", entry.Name, table.Entries[owner].Name);
+            entry.Alias = owner;
+            return;
+        }
 
-        SoundAsset sound(std::make_shared<Sound>());
+        auto asset = std::make_shared<T>();
 
-        if (!sound->Init(path))
+        if (!InitAsset(*asset, bytes.Data, path))
+        {
+            ReleaseAsset(table, index);
             return;
+        }
 
-        m_Sounds.emplace(name, sound);
+        entry.Handle = AssetHandle<T>(asset);
+        entry.Residency = {EstimateMemorySize(*asset), m_Frame, false, true};
     }
 
-    void AssetManager::LoadMusic(const std::string_view& name, const std::filesystem::path& path)
+    template<typename T>
+    const AssetHandle<T>& AssetManager::ResolveAsset(AssetTable<T>& table, uint32_t index)
     {
-        if (m_Musics.contains(name))
+        if (table.Entries[index].Alias != INVALID_ASSET_INDEX)
+            index = table.Entries[index].Alias;
+
+        AssetEntry<T>& entry = table.Entries[index];
+
+        if (!entry.Residency.Resident)
         {
-            Logger::Warning("Music with name {} already exists! Skipping...", name);
-            return;
+            Logger::Info("Reloading evicted {} {} ({})...", GetAssetKind<T>(), entry.Name, entry.Path.string());
+
+            AssetBytes bytes;
+            auto asset = std::make_shared<T>();
+
+            if (!ReadAsset(entry.Path, bytes) || !InitAsset(*asset, bytes.Data, entry.Path))
+                return GetEmptyHandle<T>();
+
+            entry.Handle = AssetHandle<T>(asset);
+            entry.Residency.MemorySize = EstimateMemorySize(*asset);
+            entry.Residency.Resident = true;
+
+            table.Dirty = true;
+            PublishTables();
         }
 
-        Logger::Info("Loading music {} ({})", name, path.string());
+        entry.Residency.LastUsedFrame = m_Frame;
+
+        return entry.Handle;
+    }
 
-        MusicAsset music(std::make_shared<Music>());
+    template<typename T>
+    AssetHandle<T> AssetManager::GetAsset(AssetTable<T>& table, AssetID id, const std::string_view& name)
+    {
+        const uint32_t index = FindIndex(table, id, name);
+
+        if (index == INVALID_ASSET_INDEX)
+        {
+            if (name.empty())
+                Logger::Warning("{} with ID {:#018x} does not exist!", GetAssetKind<T>(), id.Hash);
+            else
+                Logger::Warning("{} with name {} does not exist!", GetAssetKind<T>(), name);
+
+            return AssetHandle<T>();
+        }
+
+        return ResolveAsset(table, index);
+    }
+
+    template<typename T>
+    const AssetHandle<T>& AssetManager::GetAsset(AssetTable<T>& table, AssetRef<T> ref)
+    {
+        if (ref.Index >= table.Entries.size() || table.Entries[ref.Index].Generation != ref.Generation)
+            return GetEmptyHandle<T>();
+
+        return ResolveAsset(table, ref.Index);
+    }
+
+    template<typename T>
+    AssetRef<T> AssetManager::GetAssetRef(const AssetTable<T>& table, AssetID id)
+    {
+        auto it = table.Indices.find(id);
+
+        if (it == std::end(table.Indices))
+            return AssetRef<T>();
+
+        return AssetRef<T>{it->second, table.Entries[it->second].Generation};
+    }
+
+    template<typename T>
+    AssetHandle<T> AssetManager::FindAsset(const AssetTable<T>& table, AssetID id, const std::string_view& name)
+    {
+        Epoch::ReadGuard guard;
+
+        const AssetSnapshot<T>* snapshot = table.Snapshot.load();
+
+        if (!snapshot)
+            return AssetHandle<T>();
+
+        auto it = snapshot->Indices.find(id);
+
+        if (it == std::end(snapshot->Indices))
+            return AssetHandle<T>();
+
+        const AssetSnapshotEntry<T>& entry = snapshot->Entries[it->second];
+
+        if (!name.empty() && entry.Name != name)
+            return AssetHandle<T>();
+
+        AssetHandle<T> handle(entry.Asset.lock());
+        handle.Placeholder = entry.Placeholder;
+        handle.Status = entry.Status;
+
+        return handle;
+    }
 
-        if (!music->Init(path))
+    template<typename T>
+    void AssetManager::PublishTable(AssetTable<T>& table)
+    {
+        if (!table.Dirty)
             return;
 
-        m_Musics.emplace(name, music);
+        auto snapshot = std::make_unique<AssetSnapshot<T>>();
+        snapshot->Entries.resize(table.Entries.size());
+        snapshot->Indices = table.Indices;
+
+        for (size_t i = 0; i < table.Entries.size(); ++i)
+        {
+            const AssetEntry<T>& entry = table.Entries[i];
+            const AssetEntry<T>& owner = (entry.Alias != INVALID_ASSET_INDEX) ? table.Entries[entry.Alias] : entry;
+
+            snapshot->Entries[i] = {entry.Name, owner.Handle.Asset, owner.Handle.Placeholder, owner.Handle.Status};
+        }
+
+        table.Dirty = false;
+
+        if (const AssetSnapshot<T>* old = table.Snapshot.exchange(snapshot.release()))
+        {
+            Epoch::Retire([old] {
+                delete old;
+            });
+        }
+    }
+
+    template<typename T>
+    void AssetManager::ClearTable(AssetTable<T>& table)
+    {
+        table.Entries.clear();
+        table.FreeIndices.clear();
+        table.Indices.clear();
+        table.Dirty = false;
+
+        if (const AssetSnapshot<T>* old = table.Snapshot.exchange(nullptr))
+        {
+            Epoch::Retire([old] {
+                delete old;
+            });
+        }
+    }
+
+    void AssetManager::PublishTables()
+    {
+        PublishTable(m_Textures);
+        PublishTable(m_Shaders);
+        PublishTable(m_Sounds);
+        PublishTable(m_Musics);
+
+        Epoch::Collect();
+    }
+
+    template<typename T>
+    AssetHandle<T> AssetManager::BeginAsyncLoad(AssetTable<T>& table, const std::string_view& name,
+                                                const std::filesystem::path& path, AssetPriority priority,
+                                                AssetHandle<T> placeholder, std::function<bool(AssetBytes&)> decode,
+                                                std::function<void(const std::shared_ptr<T>&, LoadCompletion)> finish)
+    {
+        const uint32_t index = RegisterAsset(table, name);
+
+        if (index == INVALID_ASSET_INDEX)
+            return AssetHandle<T>();
+
+        AssetHandle<T> handle(std::make_shared<T>());
+        handle.Placeholder = placeholder.Get();
+        handle.Status = std::make_shared<AssetLoadStatus>();
+
+        AssetEntry<T>& entry = table.Entries[index];
+        entry.Handle = handle;
+        entry.Path = path;
+        entry.Residency.LastUsedFrame = m_Frame;
+        entry.Residency.Resident = true;
+
+        auto load = std::make_shared<AsyncLoad>();
+        load->Priority = priority;
+        load->Path = path;
+        load->Status = handle.Status;
+        load->Decode = std::move(decode);
+        load->Finish = [asset = handle.Asset, finish = std::move(finish)](LoadCompletion done) {
+            finish(asset, std::move(done));
+        };
+        load->Share = [this, &table, index, status = handle.Status](uint64_t hash) {
+            // the table was cleared by Shutdown since
+            if (index >= table.Entries.size() || table.Entries[index].Handle.Status != status)
+                return false;
+
+            const uint32_t owner = FindContentOwner(table, hash, index);
+
+            if (owner == INVALID_ASSET_INDEX)
+                return false;
+
+            const AssetHandle<T>& shared = ResolveAsset(table, owner);
+
+            if (!shared.Asset)
+                return false;
+
+            AssetEntry<T>& entry = table.Entries[index];
+            Logger::Info("{} has the same content as {}, sharing it", entry.Name, table.Entries[owner].Name);
+
+            // handles returned by the load use the shared asset once they're ready, theirs is never finished
+            status->Shared = shared.Asset;
+
+            // the status alone still tells Resolve which load the slot belongs to
+            entry.Handle = AssetHandle<T>();
+            entry.Handle.Status = status;
+            entry.Alias = owner;
+            entry.ContentHash = hash;
+            entry.Residency = {};
+            table.Dirty = true;
+            return true;
+        };
+        load->Resolve = [this, &table, index, status = handle.Status](bool success, uint64_t hash) {
+            // the table was cleared by Shutdown since
+            if (index >= table.Entries.size() || table.Entries[index].Handle.Status != status)
+                return;
+
+            if (!success)
+            {
+                ReleaseAsset(table, index);
+                return;
+            }
+
+            AssetEntry<T>& entry = table.Entries[index];
+
+            // shared before it was finished
+            if (entry.Alias != INVALID_ASSET_INDEX)
+                return;
+
+            // a copy finished while a load of the same content was still in flight keeps its own, counted, copy
+            entry.ContentHash = hash;
+            entry.Residency.MemorySize = EstimateMemorySize(*entry.Handle.Asset);
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(m_LoadMutex);
+
+            load->Order = m_LoadCounter++;
+            ++m_InFlightLoads;
+
+            m_QueuedLoads.push_back(load);
+            std::push_heap(std::begin(m_QueuedLoads), std::end(m_QueuedLoads), CompareLoadPriority);
+        }
+
+        PublishTables();
+
+        // every job takes whatever load has the highest priority when it starts, not the one submitted with it
+        JobSystem::Submit([this] {
+            RunNextLoad();
+        });
+
+        return handle;
+    }
+
+    void AssetManager::RunNextLoad()
+    {
+        std::shared_ptr<AsyncLoad> load;
+
+        {
+            std::lock_guard<std::mutex> lock(m_LoadMutex);
+
+            if (m_QueuedLoads.empty())
+                return;
+
+            std::pop_heap(std::begin(m_QueuedLoads), std::end(m_QueuedLoads), CompareLoadPriority);
+            load = std::move(m_QueuedLoads.back());
+            m_QueuedLoads.pop_back();
+        }
+
+        AssetBytes bytes;
+
+        if (load->Status->State.load(std::memory_order_acquire) != AssetState::Cancelled &&
+            ReadAsset(load->Path, bytes))
+        {
+            load->ContentHash = HashFNV1a(bytes.Data);
+            load->Decoded = load->Decode(bytes);
+        }
+
+        std::lock_guard<std::mutex> lock(m_LoadMutex);
+        m_DecodedLoads.push_back(std::move(load));
+    }
+
+    void AssetManager::Update(float budgetMs)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        ++m_Frame;
+
+        while (true)
+        {
+            std::shared_ptr<AsyncLoad> load;
+
+            {
+                std::lock_guard<std::mutex> lock(m_LoadMutex);
+
+                if (m_DecodedLoads.empty())
+                    break;
+
+                load = std::move(m_DecodedLoads.front());
+                m_DecodedLoads.pop_front();
+            }
+
+            if (load->Status->State.load(std::memory_order_acquire) != AssetState::Loading || !load->Decoded)
+                CompleteLoad(load, false);
+            else if (load->Share(load->ContentHash))
+                CompleteLoad(load, true); // never uploaded, nor counted in the budget
+            else
+            {
+                load->Finish([this, load](bool success) {
+                    CompleteLoad(load, success);
+                });
+            }
+
+            std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (elapsed.count() >= budgetMs)
+                break;
+        }
+
+        UpdateResidency(m_Textures, AssetType::Texture);
+        UpdateResidency(m_Sounds, AssetType::Sound);
+        UpdateResidency(m_Musics, AssetType::Music);
+
+        PublishTables();
+    }
+
+    void AssetManager::CompleteLoad(const std::shared_ptr<AsyncLoad>& load, bool success)
+    {
+        AssetState expected = AssetState::Loading;
+
+        // a cancel can race with the finish, in which case the cancel wins
+        const bool stored =
+            load->Status->State.compare_exchange_strong(expected, success ? AssetState::Ready : AssetState::Failed);
+
+        load->Resolve(stored && success, load->ContentHash);
+
+        std::lock_guard<std::mutex> lock(m_LoadMutex);
+        --m_InFlightLoads;
+    }
+
+    uint32_t AssetManager::GetPendingLoadCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_LoadMutex);
+        return m_InFlightLoads;
+    }
+
+    void AssetManager::CancelPendingLoads()
+    {
+        std::lock_guard<std::mutex> lock(m_LoadMutex);
+
+        // still queued, RunNextLoad hands them to Update without reading them
+        for (const auto& load : m_QueuedLoads)
+        {
+            AssetState expected = AssetState::Loading;
+            load->Status->State.compare_exchange_strong(expected, AssetState::Cancelled);
+        }
+    }
+
+    TextureAsset AssetManager::LoadTextureAsync(const std::string_view& name, const std::filesystem::path& path,
+                                                AssetPriority priority, TextureAsset placeholder)
+    {
+        if (FindIndex(m_Textures, AssetID(name), name) != INVALID_ASSET_INDEX)
+            return GetTexture(name);
+
+        // cooked textures point into the file bytes, so they're kept together until the upload is done
+        struct TextureSource
+        {
+            AssetBytes Bytes;
+            TextureData Data;
+        };
+
+        auto source = std::make_shared<TextureSource>();
+
+        return BeginAsyncLoad<Texture>(
+            m_Textures, name, path, priority, placeholder,
+            [source, path](AssetBytes& bytes) {
+                source->Bytes = std::move(bytes);
+                return source->Data.Decode(source->Bytes.Data, path);
+            },
+            [source](const std::shared_ptr<Texture>& texture, LoadCompletion done) {
+                TextureUploader::Enqueue(texture, std::shared_ptr<const TextureData>(source, &source->Data),
+                                         std::move(done));
+            });
+    }
+
+    ShaderAsset AssetManager::LoadShaderAsync(const std::string_view& name, const std::filesystem::path& fragmentPath,
+                                              AssetPriority priority, ShaderAsset placeholder)
+    {
+        if (FindIndex(m_Shaders, AssetID(name), name) != INVALID_ASSET_INDEX)
+            return GetShader(name);
+
+        auto source = std::make_shared<std::string>();
+
+        return BeginAsyncLoad<Shader>(
+            m_Shaders, name, fragmentPath, priority, placeholder,
+            [source](AssetBytes& bytes) {
+                source->assign(std::begin(bytes.Data), std::end(bytes.Data));
+                return !source->empty();
+            },
+            [source](const std::shared_ptr<Shader>& shader, LoadCompletion done) {
+                done(shader->Init("", *source));
+            });
+    }
+
+    SoundAsset AssetManager::LoadSoundAsync(const std::string_view& name, const std::filesystem::path& path,
+                                            AssetPriority priority, SoundAsset placeholder)
+    {
+        if (FindIndex(m_Sounds, AssetID(name), name) != INVALID_ASSET_INDEX)
+            return GetSound(name);
+
+        // the wave is freed with the load, even if it gets cancelled after decoding
+        std::shared_ptr<::Wave> wave(new ::Wave{}, [](::Wave* wave) {
+            UnloadWave(*wave);
+            delete wave;
+        });
+
+        return BeginAsyncLoad<Sound>(
+            m_Sounds, name, path, priority, placeholder,
+            [wave, path](AssetBytes& bytes) {
+                return DecodeWave(bytes.Data, path, *wave);
+            },
+            [wave](const std::shared_ptr<Sound>& sound, LoadCompletion done) {
+                done(sound->Init(*wave));
+            });
+    }
+
+    MusicAsset AssetManager::LoadMusicAsync(const std::string_view& name, const std::filesystem::path& path,
+                                            AssetPriority priority, MusicAsset placeholder)
+    {
+        if (FindIndex(m_Musics, AssetID(name), name) != INVALID_ASSET_INDEX)
+            return GetMusic(name);
+
+        auto fileData = std::make_shared<std::vector<uint8_t>>();
+
+        return BeginAsyncLoad<Music>(
+            m_Musics, name, path, priority, placeholder,
+            [fileData](AssetBytes& bytes) {
+                fileData->assign(std::begin(bytes.Data), std::end(bytes.Data));
+                return !fileData->empty();
+            },
+            [fileData, path](const std::shared_ptr<Music>& music, LoadCompletion done) {
+                done(music->Init(std::move(*fileData), path.extension().string()));
+            });
     }
 
     TextureAsset AssetManager::GetTexture(const std::string_view& name)
     {
-        if (auto it = m_Textures.find(name); it != std::end(m_Textures))
-            return it->second;
+        return GetAsset(m_Textures, AssetID(name), name);
+    }
+
+    TextureAsset AssetManager::GetTexture(AssetID id)
+    {
+        return GetAsset(m_Textures, id);
+    }
 
-        Logger::Warning("Texture with name {} does not exist!", name);
-        return TextureAsset();
+    TextureRef AssetManager::GetTextureRef(AssetID id) const
+    {
+        return GetAssetRef(m_Textures, id);
+    }
+
+    const TextureAsset& AssetManager::GetTexture(TextureRef ref)
+    {
+        return GetAsset(m_Textures, ref);
     }
 
     ShaderAsset AssetManager::GetShader(const std::string_view& name)
     {
-        if (auto it = m_Shaders.find(name); it != std::end(m_Shaders))
-            return it->second;
+        return GetAsset(m_Shaders, AssetID(name), name);
+    }
+
+    ShaderAsset AssetManager::GetShader(AssetID id)
+    {
+        return GetAsset(m_Shaders, id);
+    }
+
+    ShaderRef AssetManager::GetShaderRef(AssetID id) const
+    {
+        return GetAssetRef(m_Shaders, id);
+    }
 
-        Logger::Warning("Shader with name {} does not exist!", name);
-        return ShaderAsset();
+    const ShaderAsset& AssetManager::GetShader(ShaderRef ref)
+    {
+        return GetAsset(m_Shaders, ref);
     }
 
     SoundAsset AssetManager::GetSound(const std::string_view& name)
     {
-        if (auto it = m_Sounds.find(name); it != std::end(m_Sounds))
-            return it->second;
+        return GetAsset(m_Sounds, AssetID(name), name);
+    }
 
-        Logger::Warning("Sound with name {} does not exist!", name);
-        return SoundAsset();
+    SoundAsset AssetManager::GetSound(AssetID id)
+    {
+        return GetAsset(m_Sounds, id);
+    }
+
+    SoundRef AssetManager::GetSoundRef(AssetID id) const
+    {
+        return GetAssetRef(m_Sounds, id);
+    }
+
+    const SoundAsset& AssetManager::GetSound(SoundRef ref)
+    {
+        return GetAsset(m_Sounds, ref);
     }
 
     MusicAsset AssetManager::GetMusic(const std::string_view& name)
     {
-        if (auto it = m_Musics.find(name); it != std::end(m_Musics))
-            return it->second;
+        return GetAsset(m_Musics, AssetID(name), name);
+    }
+
+    MusicAsset AssetManager::GetMusic(AssetID id)
+    {
+        return GetAsset(m_Musics, id);
+    }
+
+    MusicRef AssetManager::GetMusicRef(AssetID id) const
+    {
+        return GetAssetRef(m_Musics, id);
+    }
+
+    const MusicAsset& AssetManager::GetMusic(MusicRef ref)
+    {
+        return GetAsset(m_Musics, ref);
+    }
+
+    TextureAsset AssetManager::FindTexture(const std::string_view& name) const
+    {
+        return FindAsset(m_Textures, AssetID(name), name);
+    }
+
+    TextureAsset AssetManager::FindTexture(AssetID id) const
+    {
+        return FindAsset(m_Textures, id);
+    }
+
+    ShaderAsset AssetManager::FindShader(const std::string_view& name) const
+    {
+        return FindAsset(m_Shaders, AssetID(name), name);
+    }
+
+    ShaderAsset AssetManager::FindShader(AssetID id) const
+    {
+        return FindAsset(m_Shaders, id);
+    }
+
+    SoundAsset AssetManager::FindSound(const std::string_view& name) const
+    {
+        return FindAsset(m_Sounds, AssetID(name), name);
+    }
 
-        Logger::Warning("Music with name {} does not exist!", name);
-        return MusicAsset();
+    SoundAsset AssetManager::FindSound(AssetID id) const
+    {
+        return FindAsset(m_Sounds, id);
+    }
+
+    MusicAsset AssetManager::FindMusic(const std::string_view& name) const
+    {
+        return FindAsset(m_Musics, AssetID(name), name);
+    }
+
+    MusicAsset AssetManager::FindMusic(AssetID id) const
+    {
+        return FindAsset(m_Musics, id);
+    }
+
+    template<typename T>
+    void AssetManager::UpdateResidency(AssetTable<T>& table, AssetType type)
+    {
+        const uint64_t budget = m_MemoryBudgets[(size_t) type];
+
+        if (budget == 0)
+            return;
+
+        uint64_t usage = 0;
+        std::vector<AssetEntry<T>*> candidates;
+
+        for (AssetEntry<T>& entry : table.Entries)
+        {
+            if (!entry.Residency.Resident)
+                continue;
+
+            usage += entry.Residency.MemorySize;
+
+            // references outside the AssetManager mean the asset is still in use
+            if (entry.Handle.Asset.use_count() > 1)
+                entry.Residency.LastUsedFrame = m_Frame;
+            else if (!entry.Residency.Pinned && entry.Handle.IsReady())
+                candidates.push_back(&entry);
+        }
+
+        if (usage <= budget)
+            return;
+
+        std::sort(std::begin(candidates), std::end(candidates), [](const auto* a, const auto* b) {
+            return a->Residency.LastUsedFrame < b->Residency.LastUsedFrame;
+        });
+
+        for (AssetEntry<T>* entry : candidates)
+        {
+            if (usage <= budget)
+                break;
+
+            Logger::Info("Evicting {} ({} KiB)", entry->Name, entry->Residency.MemorySize / 1024);
+
+            usage -= entry->Residency.MemorySize;
+            entry->Handle = AssetHandle<T>();
+            entry->Residency.Resident = false;
+            table.Dirty = true;
+        }
+    }
+
+    template<typename Self, typename Fn>
+    decltype(auto) AssetManager::VisitTable(Self& self, AssetType type, Fn&& fn)
+    {
+        switch (type)
+        {
+        case AssetType::Texture:
+            return fn(self.m_Textures);
+        case AssetType::Shader:
+            return fn(self.m_Shaders);
+        case AssetType::Sound:
+            return fn(self.m_Sounds);
+        default:
+            return fn(self.m_Musics);
+        }
+    }
+
+    void AssetManager::SetMemoryBudget(AssetType type, uint64_t bytes)
+    {
+        m_MemoryBudgets[(size_t) type] = bytes;
+    }
+
+    uint64_t AssetManager::GetMemoryBudget(AssetType type) const
+    {
+        return m_MemoryBudgets[(size_t) type];
+    }
+
+    uint64_t AssetManager::GetMemoryUsage(AssetType type) const
+    {
+        return VisitTable(*this, type, [](const auto& table) {
+            uint64_t usage = 0;
+
+            for (const auto& entry : table.Entries)
+            {
+                if (entry.Residency.Resident)
+                    usage += entry.Residency.MemorySize;
+            }
+
+            return usage;
+        });
+    }
+
+    void AssetManager::SetPinned(AssetType type, const std::string_view& name, bool pinned)
+    {
+        VisitTable(*this, type, [&](auto& table) {
+            const uint32_t index = FindIndex(table, AssetID(name), name);
+
+            if (index == INVALID_ASSET_INDEX)
+            {
+                Logger::Warning("Can't pin {}, it does not exist!", name);
+                return;
+            }
+
+            table.Entries[index].Residency.Pinned = pinned;
+        });
+    }
+
+    AssetResidency AssetManager::GetResidency(AssetType type, const std::string_view& name) const
+    {
+        return VisitTable(*this, type, [&](const auto& table) {
+            const uint32_t index = FindIndex(table, AssetID(name), name);
+            return (index != INVALID_ASSET_INDEX) ? table.Entries[index].Residency : AssetResidency();
+        });
     }
 } // namespace Nova
@@ -0,0 +1,116 @@
+#include "Nova/Asset/AssetPak.hpp"
+#include "Nova/Misc/Hash.hpp"
+#include "Nova/Misc/LZ4.hpp"
+#include "Nova/Misc/Logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Nova
+{
+    bool AssetPak::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+        if (!m_File.Open(path))
+            return false;
+
+        const std::string pathString = path.string();
+        AssetPakHeader header;
+
+        if (m_File.GetSize() < sizeof(header))
+        {
+            Logger::Warning("Asset pak {} is truncated!", pathString);
+            Close();
+            return false;
+        }
+
+        std::memcpy(&header, m_File.GetData(), sizeof(header));
+
+        if (header.Magic != ASSET_PAK_MAGIC || header.Version != ASSET_PAK_VERSION)
+        {
+            Logger::Warning("{} is not a valid asset pak!", pathString);
+            Close();
+            return false;
+        }
+
+        const uint64_t entriesSize = (uint64_t) header.EntryCount * sizeof(AssetPakEntry);
+
+        if (m_File.GetSize() < sizeof(header) + entriesSize + header.NamesSize)
+        {
+            Logger::Warning("Asset pak {} has an invalid index!", pathString);
+            Close();
+            return false;
+        }
+
+        // the header is 16 bytes and entries are 8 byte aligned, so the index is read in place
+        m_Entries = {reinterpret_cast<const AssetPakEntry*>(m_File.GetData() + sizeof(header)), header.EntryCount};
+        m_Names = {reinterpret_cast<const char*>(m_File.GetData() + sizeof(header) + entriesSize), header.NamesSize};
+
+        for (const AssetPakEntry& entry : m_Entries)
+        {
+            if (entry.Offset > m_File.GetSize() || entry.StoredSize > m_File.GetSize() - entry.Offset ||
+                (uint64_t) entry.NameOffset + entry.NameLength > m_Names.size() ||
+                (entry.Compression == AssetPakCompression::None && entry.StoredSize != entry.Size))
+            {
+                Logger::Warning("Asset pak {} has an invalid entry!", pathString);
+                Close();
+                return false;
+            }
+        }
+
+        Logger::Info("Opened asset pak {} ({} files)", pathString, m_Entries.size());
+
+        return true;
+    }
+
+    void AssetPak::Close()
+    {
+        m_Entries = {};
+        m_Names = {};
+        m_File.Close();
+    }
+
+    const AssetPakEntry* AssetPak::Find(std::string_view name) const
+    {
+        const uint64_t hash = HashFNV1a(name);
+
+        auto it = std::lower_bound(std::begin(m_Entries), std::end(m_Entries), hash,
+                                   [](const AssetPakEntry& entry, uint64_t hash) {
+                                       return entry.NameHash < hash;
+                                   });
+
+        // names are compared too, in case two of them share a hash
+        for (; it != std::end(m_Entries) && it->NameHash == hash; ++it)
+        {
+            if (GetName(*it) == name)
+                return &*it;
+        }
+
+        return nullptr;
+    }
+
+    std::string_view AssetPak::GetName(const AssetPakEntry& entry) const
+    {
+        return m_Names.substr(entry.NameOffset, entry.NameLength);
+    }
+
+    std::span<const uint8_t> AssetPak::Read(const AssetPakEntry& entry, std::vector<uint8_t>& storage) const
+    {
+        std::span<const uint8_t> stored = m_File.GetSpan().subspan(entry.Offset, entry.StoredSize);
+
+        if (entry.Compression == AssetPakCompression::None)
+            return stored;
+
+        storage.resize(entry.Size);
+
+        if (!LZ4::Decompress(stored, storage))
+        {
+            Logger::Warning("Asset pak entry {} is corrupted!", GetName(entry));
+            storage.clear();
+            return {};
+        }
+
+        return storage;
+    }
+} // namespace Nova
@@ -2,6 +2,8 @@
 
 #include "Nova/Misc/Logger.hpp"
 
+#include <utility>
+
 namespace Nova
 {
     Music::~Music()
@@ -23,6 +25,26 @@ namespace Nova
         return true;
     }
 
+    bool Music::Init(std::vector<uint8_t> fileData, const std::string& fileType)
+    {
+        m_FileData = std::move(fileData);
+        m_Music = LoadMusicStreamFromMemory(fileType.c_str(), m_FileData.data(), (int) m_FileData.size());
+
+        if (!IsMusicReady(m_Music))
+        {
+            Logger::Warning("Failed to load {} music from memory", fileType);
+            m_FileData.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    uint64_t Music::GetMemorySize() const
+    {
+        return m_FileData.size();
+    }
+
     void Music::Shutdown() const
     {
         UnloadMusicStream(m_Music);
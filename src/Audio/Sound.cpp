@@ -23,6 +23,24 @@ namespace Nova
         return true;
     }
 
+    bool Sound::Init(const ::Wave& wave)
+    {
+        m_Sound = LoadSoundFromWave(wave);
+
+        if (!IsSoundReady(m_Sound))
+        {
+            Logger::Warning("Failed to create sound from wave data");
+            return false;
+        }
+
+        return true;
+    }
+
+    uint64_t Sound::GetMemorySize() const
+    {
+        return (uint64_t) m_Sound.frameCount * m_Sound.stream.channels * (m_Sound.stream.sampleSize / 8);
+    }
+
     void Sound::Shutdown() const
     {
         UnloadSound(m_Sound);
@@ -1,6 +1,7 @@
 #include "Nova/Core/App.hpp"
 #include "Nova/Core/Window.hpp"
 #include "Nova/Core/Input.hpp"
+#include "Nova/Core/JobSystem.hpp"
 
 #include "Nova/Asset/AssetManager.hpp"
 
@@ -51,6 +52,7 @@ namespace Nova
         Logger::Info("OpenGL vendor: {}", (const char*) glGetString(GL_VENDOR));
         Logger::Info("OpenGL renderer: {}", (const char*) glGetString(GL_RENDERER));
 
+        JobSystem::Init();
         Renderer::Init(m_Window.GetWidth(), m_Window.GetHeight());
 
         if (config.Window.Flags & WindowFlags_EnableMSAAx4)
@@ -66,6 +68,9 @@ namespace Nova
     {
         Logger::Info("Shutting down Nova App...");
 
+        // the workers would still read and decode every queued load before stopping
+        m_AssetManager.CancelPendingLoads();
+        JobSystem::Shutdown();
         ShutdownAudio();
         ShutdownImGui();
         Renderer::Shutdown();
@@ -90,6 +95,7 @@ namespace Nova
             float deltaTime = Metrics::NewFrame();
 
             Input::PollEvents();
+            m_AssetManager.Update();
 
             Renderer::BeginFrame();
             m_SceneManager.ProcessScenes(deltaTime);
@@ -0,0 +1,162 @@
+#include "Nova/Core/Epoch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Nova::Epoch
+{
+#ifdef _MSC_VER
+    // C4324: padded to the cache line on purpose
+    #pragma warning(push)
+    #pragma warning(disable : 4324)
+#endif
+
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<uint64_t> Epoch = 0; // 0 outside of a guard
+        std::atomic<bool> Claimed = false;
+    };
+
+    struct RetiredObject
+    {
+        uint64_t Epoch = 0;
+        std::function<void()> Free;
+    };
+
+    // blocks are only added, never removed, so a claimed slot stays valid until its thread exits
+    struct ReaderBlock
+    {
+        std::array<ReaderSlot, READER_BLOCK_SIZE> Slots;
+        std::atomic<ReaderBlock*> Next = nullptr;
+    };
+
+    struct EpochData
+    {
+        std::atomic<uint64_t> GlobalEpoch = 1;
+        ReaderBlock Readers;
+        std::mutex RetiredMutex;
+        std::vector<RetiredObject> Retired;
+
+        ~EpochData()
+        {
+            for (ReaderBlock* block = Readers.Next.load(); block;)
+                delete std::exchange(block, block->Next.load());
+        }
+    };
+
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+    // the slot of a thread is given back when the thread exits
+    struct ThreadSlot
+    {
+        ReaderSlot* Slot = nullptr;
+        uint32_t Depth = 0;
+
+        ~ThreadSlot()
+        {
+            if (Slot)
+                Slot->Claimed.store(false, std::memory_order_release);
+        }
+    };
+
+    static EpochData s_Data;
+    static thread_local ThreadSlot t_Slot;
+
+    static ReaderSlot& AcquireSlot()
+    {
+        for (ReaderBlock* block = &s_Data.Readers; !t_Slot.Slot;)
+        {
+            for (ReaderSlot& slot : block->Slots)
+            {
+                bool expected = false;
+
+                if (slot.Claimed.compare_exchange_strong(expected, true))
+                {
+                    t_Slot.Slot = &slot;
+                    break;
+                }
+            }
+
+            if (t_Slot.Slot)
+                break;
+
+            // every slot of the block is taken, the thread that adds the next one first wins
+            ReaderBlock* next = block->Next.load();
+
+            if (!next)
+            {
+                auto* added = new ReaderBlock();
+
+                if (block->Next.compare_exchange_strong(next, added))
+                    next = added;
+                else
+                    delete added;
+            }
+
+            block = next;
+        }
+
+        return *t_Slot.Slot;
+    }
+
+    // The reader's store and the loads that follow it are sequentially consistent with the writer's unpublish,
+    // Retire and Collect: a reader Collect didn't see in its slot is bound to load the new version.
+    ReadGuard::ReadGuard()
+    {
+        if (t_Slot.Depth++ == 0)
+            AcquireSlot().Epoch.store(s_Data.GlobalEpoch.load());
+    }
+
+    ReadGuard::~ReadGuard()
+    {
+        if (--t_Slot.Depth == 0)
+            t_Slot.Slot->Epoch.store(0, std::memory_order_release);
+    }
+
+    void Retire(std::function<void()> free)
+    {
+        const uint64_t epoch = s_Data.GlobalEpoch.fetch_add(1);
+
+        std::lock_guard<std::mutex> lock(s_Data.RetiredMutex);
+        s_Data.Retired.push_back({epoch, std::move(free)});
+    }
+
+    void Collect()
+    {
+        uint64_t oldest = UINT64_MAX;
+
+        // a block added after this is only used by readers that can't see what was retired so far
+        for (const ReaderBlock* block = &s_Data.Readers; block; block = block->Next.load())
+        {
+            for (const ReaderSlot& slot : block->Slots)
+            {
+                if (const uint64_t epoch = slot.Epoch.load(); epoch != 0)
+                    oldest = std::min(oldest, epoch);
+            }
+        }
+
+        // readers that entered after an object was retired can't have seen it
+        std::vector<RetiredObject> ready;
+
+        {
+            std::lock_guard<std::mutex> lock(s_Data.RetiredMutex);
+
+            auto it = std::partition(std::begin(s_Data.Retired), std::end(s_Data.Retired),
+                                     [oldest](const RetiredObject& object) {
+                                         return object.Epoch >= oldest;
+                                     });
+
+            ready.assign(std::make_move_iterator(it), std::make_move_iterator(std::end(s_Data.Retired)));
+            s_Data.Retired.erase(it, std::end(s_Data.Retired));
+        }
+
+        for (RetiredObject& object : ready)
+            object.Free();
+    }
+} // namespace Nova::Epoch
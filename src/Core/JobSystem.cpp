@@ -0,0 +1,455 @@
+#include "Nova/Core/JobSystem.hpp"
+#include "Nova/Misc/Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Nova::JobSystem
+{
+#ifdef _MSC_VER
+    // C4324: padded to the cache line on purpose
+    #pragma warning(push)
+    #pragma warning(disable : 4324)
+#endif
+
+    // Chase-Lev deque: the owning thread pushes and pops at the bottom without locking, the other threads steal
+    // from the top with a CAS
+    class WorkQueue
+    {
+    public:
+        static constexpr int64_t CAPACITY = 4096;
+
+        // false when full
+        bool Push(Job* job) noexcept
+        {
+            const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+            const int64_t top = m_Top.load(std::memory_order_acquire);
+
+            if (bottom - top >= CAPACITY)
+                return false;
+
+            m_Jobs[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+            m_Bottom.store(bottom + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        Job* Pop() noexcept
+        {
+            const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+            m_Bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            int64_t top = m_Top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Job* job = m_Jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+
+            // the last job can be stolen at the same time
+            if (top == bottom)
+            {
+                if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed))
+                    job = nullptr;
+
+                m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return job;
+        }
+
+        Job* Steal() noexcept
+        {
+            int64_t top = m_Top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return nullptr;
+
+            Job* job = m_Jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+
+            if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;
+
+            return job;
+        }
+
+    private:
+        alignas(64) std::atomic<int64_t> m_Top = 0;
+        alignas(64) std::atomic<int64_t> m_Bottom = 0;
+        std::array<std::atomic<Job*>, CAPACITY> m_Jobs = {};
+    };
+
+    struct alignas(64) WorkerCounters
+    {
+        std::atomic<uint64_t> Jobs = 0;
+        std::atomic<uint64_t> Steals = 0;
+        std::atomic<uint64_t> BusyNanoseconds = 0;
+    };
+
+#ifdef _MSC_VER
+    #pragma warning(pop)
+#endif
+
+    struct JobSystemData
+    {
+        std::atomic<bool> Running = false;
+        std::vector<std::thread> Workers;
+
+        // one per worker, plus one for the thread that called Init, which only holds ParallelFor helpers
+        std::vector<std::unique_ptr<WorkQueue>> Queues;
+        std::unique_ptr<WorkerCounters[]> Counters;
+
+        // jobs submitted by threads without a queue
+        std::deque<Job*> Injected;
+        std::atomic<uint32_t> InjectedCount = 0; // checked before taking the lock
+        std::mutex InjectedMutex;
+
+        // queued jobs, and workers waiting for one
+        std::atomic<int32_t> Pending = 0;
+        std::atomic<int32_t> Sleeping = 0;
+        std::mutex SleepMutex;
+        std::condition_variable SleepCondition;
+    };
+
+    struct ParallelForState
+    {
+        std::atomic<uint32_t> NextRange = 0;
+        std::atomic<uint32_t> DoneRanges = 0;
+        uint32_t RangeCount = 0;
+        uint32_t Count = 0;
+        uint32_t GrainSize = 0;
+        const RangeJob* Job = nullptr;
+    };
+
+    static JobSystemData s_Data;
+
+    // queue of this thread, -1 for threads without one
+    static thread_local int32_t t_QueueIndex = -1;
+
+    // spins before a worker without jobs goes to sleep
+    static constexpr uint32_t WORKER_SPIN_COUNT = 64;
+
+    static void WakeWorker()
+    {
+        s_Data.Pending.fetch_add(1, std::memory_order_seq_cst);
+
+        if (s_Data.Sleeping.load(std::memory_order_seq_cst) > 0)
+        {
+            // taking the lock orders this with a worker that is about to wait
+            {
+                std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+            }
+
+            s_Data.SleepCondition.notify_one();
+        }
+    }
+
+    static Job* PopInjected()
+    {
+        if (s_Data.InjectedCount.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+
+        std::lock_guard<std::mutex> lock(s_Data.InjectedMutex);
+
+        if (s_Data.Injected.empty())
+            return nullptr;
+
+        Job* job = s_Data.Injected.front();
+        s_Data.Injected.pop_front();
+        s_Data.InjectedCount.fetch_sub(1, std::memory_order_relaxed);
+
+        return job;
+    }
+
+    static Job* StealJob(uint32_t thief)
+    {
+        // xorshift, so thieves don't all go after the same victim
+        static thread_local uint32_t state = 0x9E3779B9u ^ (thief * 0x85EBCA6Bu);
+
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        const uint32_t queueCount = (uint32_t) s_Data.Queues.size();
+
+        for (uint32_t i = 0; i < queueCount; ++i)
+        {
+            const uint32_t victim = (state + i) % queueCount;
+
+            if (victim == thief)
+                continue;
+
+            if (Job* job = s_Data.Queues[victim]->Steal())
+                return job;
+        }
+
+        return nullptr;
+    }
+
+    static void Execute(uint32_t index, Job* job, bool stolen)
+    {
+        std::unique_ptr<Job> owned(job);
+        WorkerCounters& counters = s_Data.Counters[index];
+
+        const auto start = std::chrono::steady_clock::now();
+        (*owned)();
+        const auto busy = std::chrono::steady_clock::now() - start;
+
+        counters.Jobs.fetch_add(1, std::memory_order_relaxed);
+        counters.Steals.fetch_add(stolen ? 1 : 0, std::memory_order_relaxed);
+        counters.BusyNanoseconds.fetch_add(
+            (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count(), std::memory_order_relaxed);
+    }
+
+    // own queue first, then the injected jobs, then the other queues
+    static bool RunOneJob(uint32_t index)
+    {
+        bool stolen = false;
+        Job* job = s_Data.Queues[index]->Pop();
+
+        if (!job)
+            job = PopInjected();
+
+        if (!job)
+        {
+            job = StealJob(index);
+            stolen = (job != nullptr);
+        }
+
+        if (!job)
+            return false;
+
+        s_Data.Pending.fetch_sub(1, std::memory_order_relaxed);
+        Execute(index, job, stolen);
+
+        return true;
+    }
+
+    // only the jobs of this thread, which a ParallelFor waiting on its helpers finds first
+    static bool RunOneLocal(uint32_t index)
+    {
+        Job* job = s_Data.Queues[index]->Pop();
+
+        if (!job)
+            return false;
+
+        s_Data.Pending.fetch_sub(1, std::memory_order_relaxed);
+        Execute(index, job, false);
+
+        return true;
+    }
+
+    static void WorkerLoop(uint32_t index)
+    {
+        t_QueueIndex = (int32_t) index;
+
+        while (true)
+        {
+            bool ran = false;
+
+            for (uint32_t spin = 0; spin < WORKER_SPIN_COUNT && !ran; ++spin)
+            {
+                ran = RunOneJob(index);
+
+                if (!ran)
+                    std::this_thread::yield();
+            }
+
+            if (ran)
+                continue;
+
+            if (!s_Data.Running.load(std::memory_order_acquire) && s_Data.Pending.load() <= 0)
+                return;
+
+            s_Data.Sleeping.fetch_add(1, std::memory_order_seq_cst);
+
+            {
+                std::unique_lock<std::mutex> lock(s_Data.SleepMutex);
+
+                s_Data.SleepCondition.wait(lock, [] {
+                    return !s_Data.Running.load() || s_Data.Pending.load(std::memory_order_seq_cst) > 0;
+                });
+            }
+
+            s_Data.Sleeping.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    // on the queue of this thread when local is set and there's room, otherwise with the injected jobs
+    static void Enqueue(Job* job, bool local)
+    {
+        if (!local || t_QueueIndex < 0 || !s_Data.Queues[t_QueueIndex]->Push(job))
+        {
+            std::lock_guard<std::mutex> lock(s_Data.InjectedMutex);
+            s_Data.Injected.push_back(job);
+            s_Data.InjectedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        WakeWorker();
+    }
+
+    // grabs ranges until there are none left, returns once this thread has nothing more to do
+    static void RunRanges(ParallelForState& state)
+    {
+        while (true)
+        {
+            uint32_t range = state.NextRange.fetch_add(1, std::memory_order_relaxed);
+
+            if (range >= state.RangeCount)
+                return;
+
+            uint32_t begin = range * state.GrainSize;
+            uint32_t end = std::min(begin + state.GrainSize, state.Count);
+
+            (*state.Job)(begin, end);
+
+            state.DoneRanges.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void Init(uint32_t workerCount)
+    {
+        if (s_Data.Running)
+            return;
+
+        if (workerCount == 0)
+            workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+        Logger::Info("Initializing job system with {} workers...", workerCount);
+
+        s_Data.Running = true;
+        s_Data.Pending = 0;
+        s_Data.Queues.clear();
+
+        for (uint32_t i = 0; i <= workerCount; ++i)
+            s_Data.Queues.push_back(std::make_unique<WorkQueue>());
+
+        s_Data.Counters = std::make_unique<WorkerCounters[]>(workerCount + 1);
+        t_QueueIndex = (int32_t) workerCount;
+
+        s_Data.Workers.reserve(workerCount);
+
+        for (uint32_t i = 0; i < workerCount; ++i)
+            s_Data.Workers.emplace_back(&WorkerLoop, i);
+
+        Logger::Info("Job system initialized successfully!");
+    }
+
+    void Shutdown()
+    {
+        if (!s_Data.Running)
+            return;
+
+        Logger::Info("Shutting down job system...");
+
+        {
+            std::lock_guard<std::mutex> lock(s_Data.SleepMutex);
+            s_Data.Running = false;
+        }
+
+        s_Data.SleepCondition.notify_all();
+
+        // workers drain the queues before leaving
+        for (auto& worker : s_Data.Workers)
+            worker.join();
+
+        // helpers left in the queue of this thread are done already
+        while (Job* job = s_Data.Queues.back()->Pop())
+            delete job;
+
+        s_Data.Workers.clear();
+        s_Data.Queues.clear();
+        s_Data.Counters.reset();
+        t_QueueIndex = -1;
+
+        Logger::Info("Job system shut down successfully!");
+    }
+
+    uint32_t GetWorkerCount()
+    {
+        return (uint32_t) s_Data.Workers.size();
+    }
+
+    WorkerStats GetWorkerStats(uint32_t worker)
+    {
+        if (worker >= GetWorkerCount())
+            return {};
+
+        const WorkerCounters& counters = s_Data.Counters[worker];
+
+        return {
+            .Jobs = counters.Jobs.load(std::memory_order_relaxed),
+            .Steals = counters.Steals.load(std::memory_order_relaxed),
+            .BusyTime = (double) counters.BusyNanoseconds.load(std::memory_order_relaxed) * 1e-9,
+        };
+    }
+
+    void Submit(Job job)
+    {
+        if (s_Data.Workers.empty())
+        {
+            job();
+            return;
+        }
+
+        // submitted jobs only go to the local queue of workers, the thread that called Init only has ParallelFor
+        // helpers there. Waiting on a ParallelFor still runs the helpers of any enclosing one, and on a worker any job.
+        Enqueue(new Job(std::move(job)), t_QueueIndex < (int32_t) GetWorkerCount());
+    }
+
+    void ParallelFor(uint32_t count, uint32_t grainSize, const RangeJob& job)
+    {
+        if (count == 0)
+            return;
+
+        grainSize = std::max(1u, grainSize);
+        uint32_t rangeCount = (count + grainSize - 1) / grainSize;
+
+        if (rangeCount == 1 || s_Data.Workers.empty())
+        {
+            job(0, count);
+            return;
+        }
+
+        // helpers can start after this call returned, so the state must outlive it; they only
+        // touch the job after grabbing a range, which can't happen once all ranges are done
+        auto state = std::make_shared<ParallelForState>();
+        state->RangeCount = rangeCount;
+        state->Count = count;
+        state->GrainSize = grainSize;
+        state->Job = &job;
+
+        uint32_t helpers = std::min(rangeCount - 1, GetWorkerCount());
+
+        for (uint32_t i = 0; i < helpers; ++i)
+        {
+            Enqueue(new Job([state] {
+                RunRanges(*state);
+            }), true);
+        }
+
+        RunRanges(*state);
+
+        // the helpers nobody stole yet are on top of this thread's queue, they have nothing left to do
+        while (state->DoneRanges.load(std::memory_order_acquire) < rangeCount)
+        {
+            if (t_QueueIndex < 0 || !RunOneLocal((uint32_t) t_QueueIndex))
+                std::this_thread::yield();
+        }
+    }
+} // namespace Nova::JobSystem
@@ -0,0 +1,53 @@
+#include "Nova/ECS/Components.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/trigonometric.hpp>
+#include <entt/entity/registry.hpp>
+
+namespace Nova
+{
+    glm::vec2 GetQuadSize(const entt::registry& registry, entt::entity entity, const QuadTransform& transform)
+    {
+        // same order as the RendererSystem draws them in, the last one drawn is on top
+        if (const auto* sprite = registry.try_get<GPUSpriteAnimationComponent>(entity))
+            return sprite->Sheet ? transform.Scale * sprite->Sheet->GetFrameSize() : glm::vec2(0.0f);
+
+        if (const auto* sprite = registry.try_get<SpriteInstanceComponent>(entity))
+            return sprite->Sheet ? transform.Scale * sprite->Sheet->GetFrameSize() : glm::vec2(0.0f);
+
+        if (const auto* sprite = registry.try_get<SpriteComponent>(entity))
+            return transform.Scale * sprite->GetFrameSize();
+
+        if (const auto* texture = registry.try_get<TextureComponent>(entity))
+        {
+            if (!texture->Texture)
+                return {0.0f, 0.0f};
+
+            return transform.Scale * glm::vec2(texture->Texture->GetWidth(), texture->Texture->GetHeight());
+        }
+
+        return transform.Scale;
+    }
+
+    glm::vec4 GetQuadBounds(const QuadTransform& transform, const glm::vec2& size)
+    {
+        glm::vec2 x = {size.x, 0.0f};
+        glm::vec2 y = {0.0f, size.y};
+
+        if (transform.Rotation != 0.0f)
+        {
+            const float angle = glm::radians(transform.Rotation);
+            x = glm::vec2(std::cos(angle), std::sin(angle)) * size.x;
+            y = glm::vec2(-std::sin(angle), std::cos(angle)) * size.y;
+        }
+
+        // flipped (negative) sizes put the corners on the other side of the position
+        const glm::vec2 min = transform.Position + glm::vec2(std::min(x.x, 0.0f) + std::min(y.x, 0.0f),
+                                                             std::min(x.y, 0.0f) + std::min(y.y, 0.0f));
+        const glm::vec2 max = transform.Position + glm::vec2(std::max(x.x, 0.0f) + std::max(y.x, 0.0f),
+                                                             std::max(x.y, 0.0f) + std::max(y.y, 0.0f));
+
+        return {min, max};
+    }
+} // namespace Nova
@@ -1,4 +1,5 @@
 #include "Nova/ECS/Entity.hpp"
+#include "Nova/ECS/Components.hpp"
 #include "Nova/Misc/Assert.hpp"
 
 namespace Nova
@@ -26,4 +27,31 @@ namespace Nova
 
         return other;
     }
+
+    bool Entity::SetParent(const Entity& parent)
+    {
+        if (!m_ParentScene || parent.m_ParentScene != m_ParentScene)
+            return false;
+
+        return m_ParentScene->m_TransformSystem.SetParent(m_Entity, parent.m_Entity);
+    }
+
+    void Entity::RemoveParent()
+    {
+        if (m_ParentScene)
+            m_ParentScene->m_TransformSystem.SetParent(m_Entity, entt::null);
+    }
+
+    Entity Entity::GetParent() const
+    {
+        if (!m_ParentScene)
+            return Entity();
+
+        const auto* node = m_ParentScene->m_Registry.try_get<HierarchyComponent>(m_Entity);
+
+        if (!node || node->Parent == entt::null)
+            return Entity();
+
+        return Entity(node->Parent, m_ParentScene);
+    }
 } // namespace Nova
@@ -0,0 +1,16 @@
+#include "Nova/ECS/ParticleSystem.hpp"
+#include "Nova/ECS/Components.hpp"
+
+#include "Nova/Scene/Scene.hpp"
+
+namespace Nova
+{
+    void ParticleSystem::Update(float deltaTime)
+    {
+        auto view = m_ParentScene->GetEntitiesWith<ParticleEmitterComponent, const QuadTransform>();
+
+        view.each([deltaTime](ParticleEmitterComponent& emitter, const QuadTransform& transform) {
+            emitter.Update(deltaTime, transform.Position);
+        });
+    }
+} // namespace Nova
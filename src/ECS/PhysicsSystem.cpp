@@ -0,0 +1,112 @@
+#include "Nova/ECS/PhysicsSystem.hpp"
+#include "Nova/ECS/Components.hpp"
+
+#include "Nova/Scene/Scene.hpp"
+
+#include <cmath>
+#include <glm/common.hpp>
+#include <glm/trigonometric.hpp>
+
+namespace Nova
+{
+    // the quad rotates around its top left corner, the body around the center of the quad
+    static glm::vec2 RotateHalfSize(const glm::vec2& size, float angle)
+    {
+        const glm::vec2 half = size * 0.5f;
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+
+        return {c * half.x - s * half.y, s * half.x + c * half.y};
+    }
+
+    // size is the one the quad is drawn at (GetQuadSize), which only matches Scale for colored quads
+    static PhysicsTransform ToPhysics(const QuadTransform& transform, const glm::vec2& size)
+    {
+        const float angle = glm::radians(transform.Rotation);
+        return {.Position = transform.Position + RotateHalfSize(size, angle), .Angle = angle};
+    }
+
+    static QuadTransform ToQuad(const PhysicsTransform& transform, const glm::vec2& scale, const glm::vec2& size)
+    {
+        return {
+            .Position = transform.Position - RotateHalfSize(size, transform.Angle),
+            .Scale = scale,
+            .Rotation = glm::degrees(transform.Angle),
+        };
+    }
+
+    static bool IsSame(const QuadTransform& lhs, const QuadTransform& rhs)
+    {
+        return lhs.Position == rhs.Position && lhs.Scale == rhs.Scale && lhs.Rotation == rhs.Rotation;
+    }
+
+    void PhysicsSystem::Connect()
+    {
+        entt::registry& registry = m_ParentScene->GetRegistry();
+
+        registry.on_destroy<RigidBodyComponent>().connect<&PhysicsSystem::OnRemoved>(*this);
+        registry.on_destroy<QuadTransform>().connect<&PhysicsSystem::OnRemoved>(*this);
+    }
+
+    void PhysicsSystem::OnRemoved(entt::registry& registry, entt::entity entity)
+    {
+        auto* rigidBody = registry.try_get<RigidBodyComponent>(entity);
+
+        if (!rigidBody || rigidBody->Body == INVALID_PHYSICS_BODY)
+            return;
+
+        m_World.DestroyBody(rigidBody->Body);
+        rigidBody->Body = INVALID_PHYSICS_BODY;
+    }
+
+    void PhysicsSystem::Update(float deltaTime)
+    {
+        entt::registry& registry = m_ParentScene->GetRegistry();
+        auto view = registry.view<QuadTransform, RigidBodyComponent>();
+
+        // new bodies, and the ones whose quad was moved by something other than the simulation
+        view.each([&](entt::entity entity, const QuadTransform& transform, RigidBodyComponent& rigidBody) {
+            const glm::vec2 size = GetQuadSize(registry, entity, transform);
+
+            if (rigidBody.Body == INVALID_PHYSICS_BODY)
+            {
+                // the texture isn't loaded yet, the body would be made at the wrong place and size
+                if (size == glm::vec2(0.0f))
+                    return;
+
+                PhysicsBodyConfig config = rigidBody.Config;
+                config.Transform = ToPhysics(transform, size);
+                config.UserData = entt::to_integral(entity);
+
+                if (config.Shape.IsEmpty())
+                    config.Shape = PhysicsShape::MakeBox(glm::abs(size) * 0.5f);
+
+                rigidBody.Body = m_World.CreateBody(config);
+                rigidBody.Synced = transform;
+            }
+            else if (!IsSame(transform, rigidBody.Synced))
+            {
+                m_World.SetTransform(rigidBody.Body, ToPhysics(transform, size));
+                rigidBody.Synced = transform;
+            }
+        });
+
+        if (m_World.Update(deltaTime) == 0 && m_World.GetStats().AwakeBodies == 0)
+            return;
+
+        // replaced rather than written through the view, so the hierarchy and the render cache see the change
+        view.each([&](entt::entity entity, const QuadTransform& transform, RigidBodyComponent& rigidBody) {
+            if (rigidBody.Body == INVALID_PHYSICS_BODY || m_World.GetType(rigidBody.Body) == PhysicsBodyType::Static)
+                return;
+
+            const PhysicsTransform body = m_World.GetInterpolatedTransform(rigidBody.Body);
+            const QuadTransform updated = ToQuad(body, transform.Scale, GetQuadSize(registry, entity, transform));
+
+            if (IsSame(updated, transform))
+                return;
+
+            registry.replace<QuadTransform>(entity, updated);
+            rigidBody.Synced = updated;
+        });
+    }
+} // namespace Nova
@@ -8,18 +8,67 @@ namespace Nova
 {
     void RendererSystem::Update(float deltaTime)
     {
+        // Draw all quads with a color and a render cache, rebuilding the ones that changed
+        {
+            auto view =
+                m_ParentScene->GetEntitiesWith<RenderCacheComponent, const QuadTransform, const ColorComponent>();
+            const auto& textures = m_ParentScene->GetStorage<const TextureComponent>();
+
+            view.each([&textures](entt::entity entity, RenderCacheComponent& cache, const QuadTransform& transform,
+                                  const ColorComponent& color) {
+                if (cache.Dirty)
+                {
+                    Renderer::BuildQuad(cache.ColorQuad, transform.Position, transform.Scale, color,
+                                        transform.Rotation);
+
+                    // the textured quad is rebuilt below
+                    cache.Dirty = textures.contains(entity);
+                }
+
+                Renderer::DrawQuad(cache.ColorQuad);
+            });
+        }
+
         // Draw all quads with a color in the scene
         {
-            auto view = m_ParentScene->GetEntitiesWith<const QuadTransform, const ColorComponent>();
+            auto view = m_ParentScene->GetEntitiesWith<const QuadTransform, const ColorComponent>(
+                entt::exclude<RenderCacheComponent>);
 
             view.each([](const QuadTransform& transform, const ColorComponent& color) {
                 Renderer::DrawQuad(transform.Position, transform.Scale, color, transform.Rotation);
             });
         }
 
+        // Draw all quads with a texture and a render cache, rebuilding the ones that changed
+        {
+            auto view =
+                m_ParentScene->GetEntitiesWith<RenderCacheComponent, const QuadTransform, const TextureComponent>();
+
+            view.each([](RenderCacheComponent& cache, const QuadTransform& transform, const TextureComponent& texture) {
+                std::shared_ptr<Texture> current = texture.Texture;
+
+                // asset placeholders are swapped for the loaded texture
+                if (current && current != cache.TextureQuad.Texture)
+                    cache.Dirty = true;
+
+                if (cache.Dirty)
+                {
+                    const glm::vec4 sourceRect = {0.0f, 0.0f, current ? current->GetWidth() : 1.0f,
+                                                  current ? current->GetHeight() : 1.0f};
+
+                    Renderer::BuildQuad(cache.TextureQuad, current, transform.Position, transform.Scale,
+                                        texture.Color, transform.Rotation, {0.0f, 0.0f}, sourceRect);
+                    cache.Dirty = false;
+                }
+
+                Renderer::DrawQuad(cache.TextureQuad);
+            });
+        }
+
         // Draw all quads with a texture component in the scene
         {
-            auto view = m_ParentScene->GetEntitiesWith<const QuadTransform, const TextureComponent>();
+            auto view = m_ParentScene->GetEntitiesWith<const QuadTransform, const TextureComponent>(
+                entt::exclude<RenderCacheComponent>);
 
             // clang-format off
             view.each([](const QuadTransform& transform, const TextureComponent& texture) {
@@ -36,5 +85,32 @@ namespace Nova
                 Renderer::DrawSprite(sprite, transform.Position, transform.Scale, transform.Rotation);
             });
         }
+
+        // Draw all quads with a sprite instance in the scene
+        {
+            auto view = m_ParentScene->GetEntitiesWith<const QuadTransform, const SpriteInstanceComponent>();
+
+            view.each([](const QuadTransform& transform, const SpriteInstanceComponent& instance) {
+                Renderer::DrawSprite(instance, transform.Position, transform.Scale, transform.Rotation);
+            });
+        }
+
+        // Draw all quads with a GPU sprite animation in the scene
+        {
+            auto view = m_ParentScene->GetEntitiesWith<const QuadTransform, const GPUSpriteAnimationComponent>();
+
+            view.each([](const QuadTransform& transform, const GPUSpriteAnimationComponent& animation) {
+                Renderer::DrawSprite(animation, transform.Position, transform.Scale, transform.Rotation);
+            });
+        }
+
+        // Draw all particle emitters in the scene
+        {
+            auto view = m_ParentScene->GetEntitiesWith<const ParticleEmitterComponent>();
+
+            view.each([](const ParticleEmitterComponent& emitter) {
+                Renderer::DrawParticles(emitter);
+            });
+        }
     }
 } // namespace Nova
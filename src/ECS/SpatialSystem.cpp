@@ -0,0 +1,56 @@
+#include "Nova/ECS/SpatialSystem.hpp"
+#include "Nova/ECS/Components.hpp"
+
+#include "Nova/Scene/Scene.hpp"
+
+namespace Nova
+{
+    void SpatialSystem::Connect()
+    {
+        entt::registry& registry = m_ParentScene->GetRegistry();
+
+        registry.on_destroy<SpatialComponent>().connect<&SpatialSystem::OnRemoved>(*this);
+        registry.on_destroy<QuadTransform>().connect<&SpatialSystem::OnRemoved>(*this);
+    }
+
+    void SpatialSystem::OnRemoved(entt::registry& registry, entt::entity entity)
+    {
+        auto* spatial = registry.try_get<SpatialComponent>(entity);
+
+        if (!spatial || spatial->Proxy == INVALID_SPATIAL_PROXY)
+            return;
+
+        m_Index.Remove(spatial->Proxy);
+        spatial->Proxy = INVALID_SPATIAL_PROXY;
+    }
+
+    void SpatialSystem::SetCellSize(float cellSize)
+    {
+        m_Index = SpatialHash(cellSize);
+
+        m_ParentScene->GetRegistry().view<SpatialComponent>().each([](SpatialComponent& spatial) {
+            spatial.Proxy = INVALID_SPATIAL_PROXY;
+        });
+    }
+
+    void SpatialSystem::Update(float deltaTime)
+    {
+        entt::registry& registry = m_ParentScene->GetRegistry();
+        auto view = registry.view<const QuadTransform, SpatialComponent>();
+
+        view.each([&](entt::entity entity, const QuadTransform& transform, SpatialComponent& spatial) {
+            const glm::vec4 bounds = GetQuadBounds(transform, GetQuadSize(registry, entity, transform));
+
+            if (spatial.Proxy == INVALID_SPATIAL_PROXY)
+            {
+                spatial.Proxy = m_Index.Insert({bounds.x, bounds.y}, {bounds.z, bounds.w}, entt::to_integral(entity));
+                spatial.Bounds = bounds;
+            }
+            else if (bounds != spatial.Bounds)
+            {
+                m_Index.Move(spatial.Proxy, {bounds.x, bounds.y}, {bounds.z, bounds.w});
+                spatial.Bounds = bounds;
+            }
+        });
+    }
+} // namespace Nova
@@ -1,16 +1,134 @@
 #include "Nova/ECS/SpriteSystem.hpp"
 #include "Nova/ECS/Components.hpp"
 
+#include "Nova/Core/JobSystem.hpp"
+#include "Nova/Misc/Metrics.hpp"
+#include "Nova/Renderer/Renderer.hpp"
 #include "Nova/Scene/Scene.hpp"
 
+#include <algorithm>
+#include <glm/geometric.hpp>
+
 namespace Nova
 {
+    // a multiple of the entt page size, so every range covers whole pages
+    static constexpr uint32_t SPRITE_GRAIN_SIZE = 8192;
+
+    // calls update(components, first, count) on the contiguous runs of the components of type T, split across the
+    // workers. first is the index of components in the storage.
+    template<typename T, typename Fn>
+    static void UpdateStorage(Scene& scene, const Fn& update)
+    {
+        auto& storage = scene.GetStorage<T>();
+        const uint32_t size = (uint32_t) storage.size();
+
+        if (size == 0)
+            return;
+
+        constexpr uint32_t pageSize = (uint32_t) entt::component_traits<T>::page_size;
+        T* const* pages = storage.raw();
+
+        JobSystem::ParallelFor(size, SPRITE_GRAIN_SIZE, [&](uint32_t begin, uint32_t end) {
+            while (begin < end)
+            {
+                const uint32_t offset = begin % pageSize;
+                const uint32_t count = std::min(end - begin, pageSize - offset);
+
+                update(pages[begin / pageSize] + offset, begin, count);
+                begin += count;
+            }
+        });
+    }
+
+    uint32_t SpriteSystem::UpdateLOD(float deltaTime)
+    {
+        m_SpriteDeltaTimes.clear();
+        m_InstanceDeltaTimes.clear();
+
+        auto view = m_ParentScene->GetEntitiesWith<AnimationLODComponent, const QuadTransform>();
+
+        if (view.size_hint() == 0)
+            return 0;
+
+        const auto& sprites = m_ParentScene->GetStorage<const SpriteComponent>();
+        const auto& instances = m_ParentScene->GetStorage<const SpriteInstanceComponent>();
+
+        m_SpriteDeltaTimes.assign(sprites.size(), deltaTime);
+        m_InstanceDeltaTimes.assign(instances.size(), deltaTime);
+
+        const glm::vec2 viewport = glm::vec2(Renderer::GetViewportSize());
+        uint32_t skipped = 0;
+
+        view.each([&](entt::entity entity, AnimationLODComponent& lod, const QuadTransform& transform) {
+            // drawn at Scale times the frame size, rotated around its position (the top left corner), so all of it
+            // stays within its diagonal from there
+            glm::vec2 size = transform.Scale;
+
+            if (sprites.contains(entity))
+                size *= sprites.get(entity).GetFrameSize();
+            else if (instances.contains(entity) && instances.get(entity).Sheet)
+                size *= instances.get(entity).Sheet->GetFrameSize();
+
+            const float extent = glm::length(size);
+            const bool visible = transform.Position.x + extent >= 0.0f && transform.Position.x - extent <= viewport.x &&
+                                 transform.Position.y + extent >= 0.0f && transform.Position.y - extent <= viewport.y;
+
+            // staggered by entity, so the throttled ones don't all advance on the same frame
+            const bool due = (m_FrameIndex + entt::to_integral(entity)) % std::max(lod.Interval, 1u) == 0;
+
+            float step = lod.PendingTime + deltaTime;
+            const bool advance = due && (visible || !lod.PauseOffscreen);
+
+            lod.PendingTime = advance ? 0.0f : step;
+            step = advance ? step : 0.0f;
+
+            if (sprites.contains(entity))
+            {
+                m_SpriteDeltaTimes[sprites.index(entity)] = step;
+                skipped += advance ? 0 : 1;
+            }
+
+            if (instances.contains(entity))
+            {
+                m_InstanceDeltaTimes[instances.index(entity)] = step;
+                skipped += advance ? 0 : 1;
+            }
+        });
+
+        return skipped;
+    }
+
     void SpriteSystem::Update(float deltaTime)
     {
-        auto view = m_ParentScene->GetEntitiesWith<SpriteComponent>();
+        Scene& scene = *m_ParentScene;
+
+        ++m_FrameIndex;
+
+        const uint32_t skipped = UpdateLOD(deltaTime);
+        const uint32_t total = (uint32_t) (scene.GetStorage<const SpriteComponent>().size() +
+                                           scene.GetStorage<const SpriteInstanceComponent>().size());
+
+        Metrics::IncrementAnimationUpdates(total - skipped);
+        Metrics::IncrementSkippedAnimationUpdates(skipped);
+
+        const float* spriteDeltaTimes = m_SpriteDeltaTimes.empty() ? nullptr : m_SpriteDeltaTimes.data();
+        const float* instanceDeltaTimes = m_InstanceDeltaTimes.empty() ? nullptr : m_InstanceDeltaTimes.data();
+
+        UpdateStorage<SpriteComponent>(scene, [&](SpriteComponent* sprites, uint32_t first, uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const float step = spriteDeltaTimes ? spriteDeltaTimes[first + i] : deltaTime;
+
+                if (step > 0.0f)
+                    sprites[i].Update(step);
+            }
+        });
 
-        view.each([deltaTime](SpriteComponent& sprite) {
-            sprite.Update(deltaTime);
+        UpdateStorage<SpriteInstanceComponent>(scene, [&](SpriteInstance* sprites, uint32_t first, uint32_t count) {
+            if (instanceDeltaTimes)
+                SpriteSheet::UpdateInstances(sprites, instanceDeltaTimes + first, count);
+            else
+                SpriteSheet::UpdateInstances(sprites, count, deltaTime);
         });
     }
 } // namespace Nova
@@ -1,12 +1,41 @@
 #include "Nova/ECS/System.hpp"
 #include "Nova/Misc/Assert.hpp"
 
+#include <algorithm>
+
 namespace Nova
 {
-    System::System(Scene* parentScene)
+    System::System(Scene* parentScene, SystemAccess access) : m_Access(std::move(access))
     {
         NOVA_ASSERT(parentScene, "A system's parent scene cannot be null");
 
         m_ParentScene = parentScene;
     }
+
+    bool SystemAccess::Allows(entt::id_type type, bool write) const noexcept
+    {
+        if (!Declared)
+            return true;
+
+        return std::any_of(Components.begin(), Components.end(), [type, write](const ComponentAccess& component) {
+            return component.Type == type && (component.Write || !write);
+        });
+    }
+
+    bool SystemAccess::ConflictsWith(const SystemAccess& other) const noexcept
+    {
+        if (!Declared || !other.Declared)
+            return true;
+
+        for (const ComponentAccess& component : Components)
+        {
+            for (const ComponentAccess& otherComponent : other.Components)
+            {
+                if (component.Type == otherComponent.Type && (component.Write || otherComponent.Write))
+                    return true;
+            }
+        }
+
+        return false;
+    }
 } // namespace Nova
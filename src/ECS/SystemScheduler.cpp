@@ -0,0 +1,108 @@
+#include "Nova/ECS/SystemScheduler.hpp"
+
+#include "Nova/Core/JobSystem.hpp"
+#include "Nova/Misc/Assert.hpp"
+
+#include <algorithm>
+
+namespace Nova
+{
+    // access of the system running on this thread
+    static thread_local const SystemAccess* t_RunningAccess = nullptr;
+
+    // nested when a ParallelFor of a system runs another system of its stage on this thread while waiting
+    static void RunSystem(System& system, float deltaTime)
+    {
+        SystemScheduler::AccessScope scope(&system.GetAccess());
+        system.Update(deltaTime);
+    }
+
+    SystemScheduler::AccessScope::AccessScope(const SystemAccess* access) : m_Previous(t_RunningAccess)
+    {
+        t_RunningAccess = access;
+    }
+
+    SystemScheduler::AccessScope::~AccessScope()
+    {
+        t_RunningAccess = m_Previous;
+    }
+
+    void SystemScheduler::Add(System* system)
+    {
+        m_Systems.push_back(system);
+        m_Dirty = true;
+    }
+
+    void SystemScheduler::Build(entt::registry& registry)
+    {
+        std::vector<uint32_t> stages(m_Systems.size(), 0);
+        uint32_t stageCount = 0;
+
+        for (size_t i = 0; i < m_Systems.size(); ++i)
+        {
+            const SystemAccess& access = m_Systems[i]->GetAccess();
+
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (access.ConflictsWith(m_Systems[j]->GetAccess()))
+                    stages[i] = std::max(stages[i], stages[j] + 1);
+            }
+
+            stageCount = std::max(stageCount, stages[i] + 1);
+
+            // views create missing storages, which can't happen while other systems use the registry
+            for (const ComponentAccess& component : access.Components)
+                component.Assure(registry);
+        }
+
+        m_Stages.assign(stageCount, {});
+
+        for (size_t i = 0; i < m_Systems.size(); ++i)
+            m_Stages[stages[i]].push_back(m_Systems[i]);
+
+        m_Dirty = false;
+    }
+
+    void SystemScheduler::Run(entt::registry& registry, float deltaTime)
+    {
+        if (m_Dirty)
+            Build(registry);
+
+        for (const auto& stage : m_Stages)
+        {
+            if (stage.size() == 1)
+            {
+                RunSystem(*stage[0], deltaTime);
+                continue;
+            }
+
+            JobSystem::ParallelFor((uint32_t) stage.size(), 1, [&stage, deltaTime](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i)
+                    RunSystem(*stage[i], deltaTime);
+            });
+        }
+    }
+
+    const SystemAccess* SystemScheduler::GetRunningAccess()
+    {
+        return t_RunningAccess;
+    }
+
+    void SystemScheduler::CheckAccess(entt::id_type type, bool write, std::string_view name)
+    {
+        if (!t_RunningAccess)
+            return;
+
+        NOVA_ASSERT(t_RunningAccess->Allows(type, write), "System {} {} without declaring it",
+                    write ? "writes" : "reads", name);
+    }
+
+    void SystemScheduler::CheckRegistryAccess()
+    {
+        if (!t_RunningAccess)
+            return;
+
+        NOVA_ASSERT(!t_RunningAccess->Declared,
+                    "Systems that declare their access must use Scene::GetEntitiesWith or Scene::GetStorage");
+    }
+} // namespace Nova
@@ -0,0 +1,269 @@
+#include "Nova/ECS/TransformSystem.hpp"
+#include "Nova/ECS/Components.hpp"
+
+#include "Nova/Misc/Logger.hpp"
+#include "Nova/Scene/Scene.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/trigonometric.hpp>
+
+namespace Nova
+{
+    static QuadTransform ToWorld(const QuadTransform& parent, const LocalTransform& local)
+    {
+        const float angle = glm::radians(parent.Rotation);
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+
+        return {
+            .Position = parent.Position + glm::vec2(c * local.Position.x - s * local.Position.y,
+                                                    s * local.Position.x + c * local.Position.y),
+            .Scale = local.Scale,
+            .Rotation = parent.Rotation + local.Rotation,
+        };
+    }
+
+    static LocalTransform ToLocal(const QuadTransform& parent, const QuadTransform& world)
+    {
+        const float angle = glm::radians(parent.Rotation);
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        const glm::vec2 offset = world.Position - parent.Position;
+
+        return {
+            .Position = {c * offset.x + s * offset.y, -s * offset.x + c * offset.y},
+            .Scale = world.Scale,
+            .Rotation = world.Rotation - parent.Rotation,
+        };
+    }
+
+    void TransformSystem::Connect()
+    {
+        entt::registry& registry = m_ParentScene->GetRegistry();
+
+        registry.on_construct<LocalTransform>().connect<&TransformSystem::OnTransformChanged>(*this);
+        registry.on_update<LocalTransform>().connect<&TransformSystem::OnTransformChanged>(*this);
+        registry.on_update<QuadTransform>().connect<&TransformSystem::OnRootChanged>(*this);
+
+        registry.on_construct<HierarchyComponent>().connect<&TransformSystem::OnNodeCreated>(*this);
+        registry.on_destroy<HierarchyComponent>().connect<&TransformSystem::OnNodeDestroyed>(*this);
+    }
+
+    // until the next Sort the roots of the nodes can be out of date, the node is queued and Sort swaps in its root
+    void TransformSystem::OnTransformChanged(entt::registry& registry, entt::entity entity)
+    {
+        if (auto* node = registry.try_get<HierarchyComponent>(entity))
+        {
+            node->Dirty = true;
+            m_DirtyRoots.push_back(m_Unsorted ? entity : node->Root);
+        }
+    }
+
+    // the QuadTransform of children is written by Update
+    void TransformSystem::OnRootChanged(entt::registry& registry, entt::entity entity)
+    {
+        auto* node = registry.try_get<HierarchyComponent>(entity);
+
+        if (node && node->Parent == entt::null)
+        {
+            node->Dirty = true;
+            m_DirtyRoots.push_back(entity);
+        }
+    }
+
+    // new nodes start dirty, the trees left by destroyed ones keep their world transforms
+    void TransformSystem::OnNodeCreated(entt::registry& registry, entt::entity entity)
+    {
+        m_Unsorted = true;
+        m_DirtyRoots.push_back(entity);
+    }
+
+    void TransformSystem::OnNodeDestroyed(entt::registry& registry, entt::entity entity)
+    {
+        m_Unsorted = true;
+    }
+
+    void TransformSystem::MarkDirty(entt::entity entity)
+    {
+        OnTransformChanged(m_ParentScene->GetRegistry(), entity);
+    }
+
+    bool TransformSystem::SetParent(entt::entity child, entt::entity parent)
+    {
+        entt::registry& registry = m_ParentScene->GetRegistry();
+
+        const bool hasTransforms =
+            registry.all_of<QuadTransform>(child) && (parent == entt::null || registry.all_of<QuadTransform>(parent));
+
+        if (!hasTransforms)
+        {
+            Logger::Warning("Entities need a QuadTransform to be part of the transform hierarchy");
+            return false;
+        }
+
+        for (entt::entity ancestor = parent; ancestor != entt::null;)
+        {
+            if (ancestor == child)
+            {
+                Logger::Warning("An entity can't be parented to one of its descendants");
+                return false;
+            }
+
+            const auto* node = registry.try_get<HierarchyComponent>(ancestor);
+            ancestor = node ? node->Parent : entt::null;
+        }
+
+        // the world transforms of both have to include the changes made so far
+        Flush(registry);
+
+        const QuadTransform world = registry.get<QuadTransform>(child);
+
+        if (parent == entt::null)
+        {
+            if (auto* node = registry.try_get<HierarchyComponent>(child))
+                node->Parent = entt::null;
+
+            registry.remove<LocalTransform>(child);
+            m_Unsorted = true;
+
+            return true;
+        }
+
+        // parents that weren't in the hierarchy become roots
+        if (!registry.all_of<HierarchyComponent>(parent))
+        {
+            const HierarchyComponent root = {.World = registry.get<QuadTransform>(parent)};
+            registry.emplace<HierarchyComponent>(parent, root);
+        }
+
+        auto& node = registry.get_or_emplace<HierarchyComponent>(child);
+        node.Parent = parent;
+        node.Dirty = true;
+        m_DirtyRoots.push_back(child);
+
+        // the child stays where it is
+        const QuadTransform& parentWorld = registry.get<HierarchyComponent>(parent).World;
+        registry.emplace_or_replace<LocalTransform>(child, ToLocal(parentWorld, world));
+
+        m_Unsorted = true;
+
+        return true;
+    }
+
+    void TransformSystem::Sort(entt::registry& registry)
+    {
+        auto view = registry.view<HierarchyComponent>();
+
+        // children of destroyed entities become roots where they are
+        view.each([&registry](entt::entity entity, HierarchyComponent& node) {
+            if (node.Parent != entt::null && !registry.all_of<HierarchyComponent>(node.Parent))
+            {
+                node.Parent = entt::null;
+                registry.remove<LocalTransform>(entity);
+            }
+        });
+
+        view.each([&registry](entt::entity entity, HierarchyComponent& node) {
+            node.Root = entity;
+            node.Depth = 0;
+            node.SubtreeSize = 1;
+
+            for (entt::entity parent = node.Parent; parent != entt::null;)
+            {
+                ++node.Depth;
+                node.Root = parent;
+                parent = registry.get<HierarchyComponent>(parent).Parent;
+            }
+        });
+
+        // every tree in one run, starting with its root
+        registry.sort<HierarchyComponent>([](const HierarchyComponent& lhs, const HierarchyComponent& rhs) {
+            if (lhs.Root != rhs.Root)
+                return entt::to_integral(lhs.Root) < entt::to_integral(rhs.Root);
+
+            return lhs.Depth < rhs.Depth;
+        });
+
+        view.each([&registry](const HierarchyComponent& node) {
+            if (node.Parent != entt::null)
+                ++registry.get<HierarchyComponent>(node.Root).SubtreeSize;
+        });
+
+        // only the trees of the nodes changed so far are walked, the others keep their world transforms
+        for (entt::entity& entity : m_DirtyRoots)
+        {
+            const auto* node = registry.try_get<HierarchyComponent>(entity);
+            entity = node ? node->Root : entt::null;
+        }
+
+        std::erase_if(m_DirtyRoots, [](entt::entity entity) {
+            return entity == entt::null;
+        });
+
+        m_Unsorted = false;
+    }
+
+    void TransformSystem::Flush(entt::registry& registry)
+    {
+        if (m_Unsorted)
+            Sort(registry);
+
+        if (m_DirtyRoots.empty())
+            return;
+
+        std::sort(m_DirtyRoots.begin(), m_DirtyRoots.end());
+        m_DirtyRoots.erase(std::unique(m_DirtyRoots.begin(), m_DirtyRoots.end()), m_DirtyRoots.end());
+
+        auto& storage = registry.storage<HierarchyComponent>();
+        const entt::sparse_set& nodes = storage;
+
+        // by index, replacing a QuadTransform calls the listeners above
+        for (size_t i = 0; i < m_DirtyRoots.size(); ++i)
+        {
+            // the tree of the root, sorted by depth, so parents come before their children
+            const entt::entity root = m_DirtyRoots[i];
+            const auto first = nodes.find(root);
+            const auto last = first + storage.get(root).SubtreeSize;
+
+            for (auto it = first; it != last; ++it)
+            {
+                const entt::entity entity = *it;
+                HierarchyComponent& node = storage.get(entity);
+                const bool dirty = node.Dirty;
+
+                node.Changed = false;
+                node.Dirty = false;
+
+                if (node.Parent == entt::null)
+                {
+                    if (dirty)
+                    {
+                        node.World = registry.get<QuadTransform>(entity);
+                        node.Changed = true;
+                    }
+
+                    continue;
+                }
+
+                const HierarchyComponent& parent = storage.get(node.Parent);
+
+                if (!dirty && !parent.Changed)
+                    continue;
+
+                node.World = ToWorld(parent.World, registry.get<LocalTransform>(entity));
+                node.Changed = true;
+
+                // replace notifies the render cache
+                registry.replace<QuadTransform>(entity, node.World);
+            }
+        }
+
+        m_DirtyRoots.clear();
+    }
+
+    void TransformSystem::Update(float deltaTime)
+    {
+        Flush(m_ParentScene->GetRegistry());
+    }
+} // namespace Nova
@@ -0,0 +1,186 @@
+#include "Nova/Misc/LZ4.hpp"
+#include "Nova/Misc/Assert.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Nova::LZ4
+{
+    static constexpr size_t MIN_MATCH = 4;
+    static constexpr size_t LAST_LITERALS = 5; // the last 5 bytes are always literals
+    static constexpr size_t MATCH_FIND_LIMIT = 12; // no match starts in the last 12 bytes
+    static constexpr size_t MAX_OFFSET = 65535;
+    static constexpr uint32_t HASH_BITS = 12;
+
+    static uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, 4);
+        return value;
+    }
+
+    static uint32_t HashPosition(const uint8_t* p)
+    {
+        return (Read32(p) * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    static uint8_t* WriteLength(uint8_t* op, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+            *op++ = 255;
+
+        *op++ = (uint8_t) length;
+        return op;
+    }
+
+    static uint8_t* WriteSequence(uint8_t* op, const uint8_t* literals, size_t literalCount, size_t offset,
+                                  size_t matchLength)
+    {
+        uint8_t* token = op++;
+
+        *token = (uint8_t) (std::min<size_t>(literalCount, 15) << 4);
+
+        if (literalCount >= 15)
+            op = WriteLength(op, literalCount - 15);
+
+        std::memcpy(op, literals, literalCount);
+        op += literalCount;
+
+        // the last sequence only has literals
+        if (matchLength == 0)
+            return op;
+
+        *op++ = (uint8_t) offset;
+        *op++ = (uint8_t) (offset >> 8);
+
+        matchLength -= MIN_MATCH;
+        *token |= (uint8_t) std::min<size_t>(matchLength, 15);
+
+        if (matchLength >= 15)
+            op = WriteLength(op, matchLength - 15);
+
+        return op;
+    }
+
+    size_t Compress(std::span<const uint8_t> src, std::span<uint8_t> dst)
+    {
+        NOVA_ASSERT(dst.size() >= GetMaxCompressedSize(src.size()), "LZ4 destination buffer is too small!");
+
+        const uint8_t* base = src.data();
+        const size_t size = src.size();
+
+        uint8_t* op = dst.data();
+        size_t anchor = 0;
+
+        if (size > MATCH_FIND_LIMIT)
+        {
+            // positions + 1, so 0 means empty
+            std::vector<uint32_t> table(1u << HASH_BITS, 0);
+
+            const size_t matchLimit = size - LAST_LITERALS;
+            size_t ip = 0;
+
+            while (ip < size - MATCH_FIND_LIMIT)
+            {
+                const uint32_t hash = HashPosition(base + ip);
+                const size_t candidate = table[hash];
+                table[hash] = (uint32_t) ip + 1;
+
+                if (candidate == 0 || ip - (candidate - 1) > MAX_OFFSET ||
+                    Read32(base + candidate - 1) != Read32(base + ip))
+                {
+                    ++ip;
+                    continue;
+                }
+
+                const size_t ref = candidate - 1;
+                size_t length = MIN_MATCH;
+
+                while (ip + length < matchLimit && base[ref + length] == base[ip + length])
+                    ++length;
+
+                op = WriteSequence(op, base + anchor, ip - anchor, ip - ref, length);
+
+                ip += length;
+                anchor = ip;
+            }
+        }
+
+        op = WriteSequence(op, base + anchor, size - anchor, 0, 0);
+
+        return (size_t) (op - dst.data());
+    }
+
+    bool Decompress(std::span<const uint8_t> src, std::span<uint8_t> dst)
+    {
+        const uint8_t* ip = src.data();
+        const uint8_t* const inEnd = ip + src.size();
+
+        uint8_t* op = dst.data();
+        uint8_t* const outEnd = op + dst.size();
+
+        auto readLength = [&](size_t& length) {
+            uint8_t byte;
+
+            do
+            {
+                if (ip >= inEnd)
+                    return false;
+
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+
+            return true;
+        };
+
+        while (ip < inEnd)
+        {
+            const uint8_t token = *ip++;
+            size_t literalCount = token >> 4;
+
+            if (literalCount == 15 && !readLength(literalCount))
+                return false;
+
+            if (literalCount > (size_t) (inEnd - ip) || literalCount > (size_t) (outEnd - op))
+                return false;
+
+            std::memcpy(op, ip, literalCount);
+            ip += literalCount;
+            op += literalCount;
+
+            if (ip == inEnd)
+                break;
+
+            if (inEnd - ip < 2)
+                return false;
+
+            const size_t offset = ip[0] | (ip[1] << 8);
+            ip += 2;
+
+            if (offset == 0 || offset > (size_t) (op - dst.data()))
+                return false;
+
+            size_t matchLength = token & 15;
+
+            if (matchLength == 15 && !readLength(matchLength))
+                return false;
+
+            matchLength += MIN_MATCH;
+
+            if (matchLength > (size_t) (outEnd - op))
+                return false;
+
+            // matches can overlap the bytes they produce, so copy forward one byte at a time
+            const uint8_t* match = op - offset;
+
+            for (size_t i = 0; i < matchLength; ++i)
+                op[i] = match[i];
+
+            op += matchLength;
+        }
+
+        return op == outEnd;
+    }
+} // namespace Nova::LZ4
@@ -0,0 +1,143 @@
+#include "Nova/Misc/MappedFile.hpp"
+#include "Nova/Misc/Logger.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Nova
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Close();
+
+        m_Data = std::exchange(other.m_Data, nullptr);
+        m_Size = std::exchange(other.m_Size, 0);
+
+#ifdef _WIN32
+        m_File = std::exchange(other.m_File, nullptr);
+        m_Mapping = std::exchange(other.m_Mapping, nullptr);
+#endif
+
+        return *this;
+    }
+
+    bool MappedFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            Logger::Warning("Failed to open {} for mapping!", path.string());
+            return false;
+        }
+
+        LARGE_INTEGER size;
+
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            Logger::Warning("Cannot map empty file {}!", path.string());
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+        if (!data)
+        {
+            Logger::Warning("Failed to map {}!", path.string());
+
+            if (mapping)
+                CloseHandle(mapping);
+
+            CloseHandle(file);
+            return false;
+        }
+
+        m_File = file;
+        m_Mapping = mapping;
+        m_Data = static_cast<const uint8_t*>(data);
+        m_Size = (size_t) size.QuadPart;
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+        {
+            Logger::Warning("Failed to open {} for mapping!", path.string());
+            return false;
+        }
+
+        struct stat info;
+
+        if (fstat(fd, &info) != 0 || info.st_size == 0)
+        {
+            Logger::Warning("Cannot map empty file {}!", path.string());
+            close(fd);
+            return false;
+        }
+
+        void* data = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // the mapping keeps its own reference to the file
+        close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            Logger::Warning("Failed to map {}!", path.string());
+            return false;
+        }
+
+        m_Data = static_cast<const uint8_t*>(data);
+        m_Size = (size_t) info.st_size;
+#endif
+
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (!m_Data)
+            return;
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_Data);
+        CloseHandle(m_Mapping);
+        CloseHandle(m_File);
+
+        m_File = nullptr;
+        m_Mapping = nullptr;
+#else
+        munmap(const_cast<uint8_t*>(m_Data), m_Size);
+#endif
+
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+} // namespace Nova
@@ -1,6 +1,9 @@
 #include "Nova/Misc/Metrics.hpp"
+#include "Nova/Core/JobSystem.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <vector>
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 
@@ -12,7 +15,13 @@ namespace Nova::Metrics
         float FPS = 0.0f;
         uint32_t DrawCalls = 0;
         uint32_t DrawnObjects = 0;
+        uint32_t AnimationUpdates = 0;
+        uint32_t SkippedAnimationUpdates = 0;
+        uint64_t VertexBytes = 0;
         uint32_t Entities = 0;
+
+        std::vector<double> WorkerBusyTimes;
+        std::vector<float> WorkerUtilizations;
     };
 
     static MetricsData s_Data;
@@ -28,6 +37,23 @@ namespace Nova::Metrics
         s_Data.FPS = 1.0f / s_Data.DeltaTime;
         s_Data.DrawCalls = 0;
         s_Data.DrawnObjects = 0;
+        s_Data.AnimationUpdates = 0;
+        s_Data.SkippedAnimationUpdates = 0;
+        s_Data.VertexBytes = 0;
+
+        const uint32_t workerCount = JobSystem::GetWorkerCount();
+
+        s_Data.WorkerBusyTimes.resize(workerCount, 0.0);
+        s_Data.WorkerUtilizations.resize(workerCount, 0.0f);
+
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            const double busyTime = JobSystem::GetWorkerStats(i).BusyTime;
+            const double busy = busyTime - s_Data.WorkerBusyTimes[i];
+
+            s_Data.WorkerUtilizations[i] = std::clamp((float) (busy / s_Data.DeltaTime), 0.0f, 1.0f);
+            s_Data.WorkerBusyTimes[i] = busyTime;
+        }
 
         return s_Data.DeltaTime;
     }
@@ -42,6 +68,21 @@ namespace Nova::Metrics
         s_Data.DrawnObjects += count;
     }
 
+    void IncrementAnimationUpdates(uint32_t count)
+    {
+        s_Data.AnimationUpdates += count;
+    }
+
+    void IncrementSkippedAnimationUpdates(uint32_t count)
+    {
+        s_Data.SkippedAnimationUpdates += count;
+    }
+
+    void IncrementVertexBytes(uint64_t bytes)
+    {
+        s_Data.VertexBytes += bytes;
+    }
+
     void IncrementEntities()
     {
         ++s_Data.Entities;
@@ -61,8 +102,19 @@ namespace Nova::Metrics
         ImGui::Value("FPS", s_Data.FPS, "%.2f");
         ImGui::Value("Draw Calls", s_Data.DrawCalls);
         ImGui::Value("Drawn Objects", s_Data.DrawnObjects);
+        ImGui::Value("Animation Updates", s_Data.AnimationUpdates);
+        ImGui::Value("Skipped Animation Updates", s_Data.SkippedAnimationUpdates);
+        ImGui::Text("Vertex Data: %.1f KiB", s_Data.VertexBytes / 1024.0);
         ImGui::Value("Entities", s_Data.Entities);
 
+        for (size_t i = 0; i < s_Data.WorkerUtilizations.size(); ++i)
+        {
+            const JobSystem::WorkerStats stats = JobSystem::GetWorkerStats((uint32_t) i);
+
+            ImGui::Text("Worker %zu: %.1f%% (%llu jobs, %llu stolen)", i, s_Data.WorkerUtilizations[i] * 100.0f,
+                        (unsigned long long) stats.Jobs, (unsigned long long) stats.Steals);
+        }
+
         ImGui::End();
 #endif
     }
@@ -91,4 +143,24 @@ namespace Nova::Metrics
     {
         return s_Data.DrawnObjects;
     }
+
+    uint32_t GetAnimationUpdates()
+    {
+        return s_Data.AnimationUpdates;
+    }
+
+    uint32_t GetSkippedAnimationUpdates()
+    {
+        return s_Data.SkippedAnimationUpdates;
+    }
+
+    uint64_t GetVertexBytes()
+    {
+        return s_Data.VertexBytes;
+    }
+
+    float GetWorkerUtilization(uint32_t worker)
+    {
+        return (worker < s_Data.WorkerUtilizations.size()) ? s_Data.WorkerUtilizations[worker] : 0.0f;
+    }
 } // namespace Nova::Metrics
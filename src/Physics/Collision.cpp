@@ -0,0 +1,315 @@
+#include "Nova/Physics/Collision.hpp"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <glm/geometric.hpp>
+
+namespace Nova::Collision
+{
+    // the features of a contact point, packed into its ID
+    enum FeatureType : uint8_t
+    {
+        FEATURE_VERTEX = 0,
+        FEATURE_FACE = 1,
+    };
+
+    // in world units (pixels), how much deeper a face of b has to be to be the reference over the face of a
+    static constexpr float REFERENCE_FACE_TOLERANCE = 0.05f;
+
+    struct WorldPolygon
+    {
+        std::array<glm::vec2, MAX_POLYGON_VERTICES> Vertices;
+        std::array<glm::vec2, MAX_POLYGON_VERTICES> Normals;
+        uint32_t Count = 0;
+    };
+
+    struct ClipVertex
+    {
+        glm::vec2 Position;
+        uint32_t ID;
+    };
+
+    static uint32_t MakeID(uint32_t indexA, uint32_t indexB, FeatureType typeA, FeatureType typeB)
+    {
+        return indexA | (indexB << 8) | ((uint32_t) typeA << 16) | ((uint32_t) typeB << 24);
+    }
+
+    // same features, seen from the other shape
+    static uint32_t FlipID(uint32_t id)
+    {
+        return ((id & 0xFF) << 8) | ((id >> 8) & 0xFF) | ((id & 0xFF0000) << 8) | ((id >> 8) & 0xFF0000);
+    }
+
+    static WorldPolygon ToWorld(const PhysicsShape& shape, const PhysicsTransform& transform)
+    {
+        const float c = std::cos(transform.Angle);
+        const float s = std::sin(transform.Angle);
+
+        WorldPolygon polygon;
+        polygon.Count = shape.VertexCount;
+
+        for (uint32_t i = 0; i < shape.VertexCount; ++i)
+        {
+            const glm::vec2& vertex = shape.Vertices[i];
+            const glm::vec2& normal = shape.Normals[i];
+
+            polygon.Vertices[i] =
+                transform.Position + glm::vec2(c * vertex.x - s * vertex.y, s * vertex.x + c * vertex.y);
+            polygon.Normals[i] = {c * normal.x - s * normal.y, s * normal.x + c * normal.y};
+        }
+
+        return polygon;
+    }
+
+    static bool CollideCircles(const glm::vec2& centerA, float radiusA, const glm::vec2& centerB, float radiusB,
+                               float speculativeDistance, PhysicsManifold& manifold)
+    {
+        const glm::vec2 offset = centerB - centerA;
+        const float distance = glm::length(offset);
+        const float separation = distance - radiusA - radiusB;
+
+        if (separation > speculativeDistance)
+            return false;
+
+        manifold.Normal = (distance > 1e-6f) ? offset / distance : glm::vec2(0.0f, 1.0f);
+        manifold.Points[0] = {
+            .Position = 0.5f * (centerA + manifold.Normal * radiusA + centerB - manifold.Normal * radiusB),
+            .Separation = separation,
+            .ID = 0,
+        };
+        manifold.PointCount = 1;
+
+        return true;
+    }
+
+    static bool CollidePolygonCircle(const WorldPolygon& polygon, const glm::vec2& center, float radius,
+                                     float speculativeDistance, PhysicsManifold& manifold)
+    {
+        // face closest to the center
+        float faceSeparation = -std::numeric_limits<float>::max();
+        uint32_t face = 0;
+
+        for (uint32_t i = 0; i < polygon.Count; ++i)
+        {
+            const float separation = glm::dot(polygon.Normals[i], center - polygon.Vertices[i]);
+
+            if (separation > radius + speculativeDistance)
+                return false;
+
+            if (separation > faceSeparation)
+            {
+                faceSeparation = separation;
+                face = i;
+            }
+        }
+
+        const glm::vec2& v1 = polygon.Vertices[face];
+        const glm::vec2& v2 = polygon.Vertices[(face + 1) % polygon.Count];
+
+        glm::vec2 normal = polygon.Normals[face];
+        glm::vec2 closest = center - normal * faceSeparation;
+
+        // outside of the polygon, past the end of the face the closest point is a vertex
+        if (faceSeparation > 1e-6f)
+        {
+            const glm::vec2* vertex = nullptr;
+
+            if (glm::dot(center - v1, v2 - v1) <= 0.0f)
+                vertex = &v1;
+            else if (glm::dot(center - v2, v1 - v2) <= 0.0f)
+                vertex = &v2;
+
+            if (vertex)
+            {
+                const glm::vec2 offset = center - *vertex;
+                const float distance = glm::length(offset);
+
+                if (distance - radius > speculativeDistance)
+                    return false;
+
+                normal = (distance > 1e-6f) ? offset / distance : normal;
+                closest = *vertex;
+            }
+        }
+
+        const float separation = glm::dot(center - closest, normal) - radius;
+
+        if (separation > speculativeDistance)
+            return false;
+
+        manifold.Normal = normal;
+        manifold.Points[0] = {
+            .Position = 0.5f * (closest + center - normal * radius),
+            .Separation = separation,
+            .ID = 0,
+        };
+        manifold.PointCount = 1;
+
+        return true;
+    }
+
+    // largest separation along the normals of a, and the face it's from
+    static float FindMaxSeparation(const WorldPolygon& a, const WorldPolygon& b, uint32_t& face)
+    {
+        float maxSeparation = -std::numeric_limits<float>::max();
+
+        for (uint32_t i = 0; i < a.Count; ++i)
+        {
+            float separation = std::numeric_limits<float>::max();
+
+            for (uint32_t j = 0; j < b.Count; ++j)
+                separation = std::min(separation, glm::dot(a.Normals[i], b.Vertices[j] - a.Vertices[i]));
+
+            if (separation > maxSeparation)
+            {
+                maxSeparation = separation;
+                face = i;
+            }
+        }
+
+        return maxSeparation;
+    }
+
+    // keeps the part of the segment behind the plane dot(normal, x) = offset
+    static uint32_t ClipSegment(ClipVertex (&out)[2], const ClipVertex (&in)[2], const glm::vec2& normal, float offset,
+                                uint32_t referenceVertex)
+    {
+        uint32_t count = 0;
+
+        const float distance0 = glm::dot(normal, in[0].Position) - offset;
+        const float distance1 = glm::dot(normal, in[1].Position) - offset;
+
+        if (distance0 <= 0.0f)
+            out[count++] = in[0];
+
+        if (distance1 <= 0.0f)
+            out[count++] = in[1];
+
+        if (distance0 * distance1 < 0.0f)
+        {
+            const float t = distance0 / (distance0 - distance1);
+
+            out[count].Position = in[0].Position + t * (in[1].Position - in[0].Position);
+            out[count].ID = MakeID(referenceVertex, (in[0].ID >> 8) & 0xFF, FEATURE_VERTEX, FEATURE_FACE);
+            ++count;
+        }
+
+        return count;
+    }
+
+    static bool CollidePolygons(const WorldPolygon& a, const WorldPolygon& b, float speculativeDistance,
+                                PhysicsManifold& manifold)
+    {
+        uint32_t faceA = 0;
+        const float separationA = FindMaxSeparation(a, b, faceA);
+
+        if (separationA > speculativeDistance)
+            return false;
+
+        uint32_t faceB = 0;
+        const float separationB = FindMaxSeparation(b, a, faceB);
+
+        if (separationB > speculativeDistance)
+            return false;
+
+        // the reference face is the one of the least overlap, with a bias so it doesn't flip between similar faces
+        const bool flip = separationB > separationA + REFERENCE_FACE_TOLERANCE;
+
+        const WorldPolygon& reference = flip ? b : a;
+        const WorldPolygon& incident = flip ? a : b;
+        const uint32_t referenceFace = flip ? faceB : faceA;
+        const glm::vec2& normal = reference.Normals[referenceFace];
+
+        // the face of the incident polygon most against the reference one
+        uint32_t incidentFace = 0;
+        float minDot = std::numeric_limits<float>::max();
+
+        for (uint32_t i = 0; i < incident.Count; ++i)
+        {
+            const float dot = glm::dot(normal, incident.Normals[i]);
+
+            if (dot < minDot)
+            {
+                minDot = dot;
+                incidentFace = i;
+            }
+        }
+
+        const uint32_t incidentNext = (incidentFace + 1) % incident.Count;
+
+        const ClipVertex incidentEdge[2] = {
+            {incident.Vertices[incidentFace], MakeID(referenceFace, incidentFace, FEATURE_FACE, FEATURE_VERTEX)},
+            {incident.Vertices[incidentNext], MakeID(referenceFace, incidentNext, FEATURE_FACE, FEATURE_VERTEX)},
+        };
+
+        const uint32_t referenceNext = (referenceFace + 1) % reference.Count;
+        const glm::vec2& v1 = reference.Vertices[referenceFace];
+        const glm::vec2& v2 = reference.Vertices[referenceNext];
+        const glm::vec2 tangent = glm::normalize(v2 - v1);
+
+        // the incident edge, clipped to the sides of the reference face
+        ClipVertex clipped1[2];
+        ClipVertex clipped2[2];
+
+        if (ClipSegment(clipped1, incidentEdge, -tangent, -glm::dot(tangent, v1), referenceFace) < 2)
+            return false;
+
+        if (ClipSegment(clipped2, clipped1, tangent, glm::dot(tangent, v2), referenceNext) < 2)
+            return false;
+
+        const float frontOffset = glm::dot(normal, v1);
+
+        manifold.Normal = flip ? -normal : normal;
+        manifold.PointCount = 0;
+
+        for (const ClipVertex& vertex : clipped2)
+        {
+            const float separation = glm::dot(normal, vertex.Position) - frontOffset;
+
+            if (separation > speculativeDistance)
+                continue;
+
+            manifold.Points[manifold.PointCount++] = {
+                .Position = vertex.Position - 0.5f * separation * normal,
+                .Separation = separation,
+                .ID = flip ? FlipID(vertex.ID) : vertex.ID,
+            };
+        }
+
+        return manifold.PointCount > 0;
+    }
+
+    bool ComputeManifold(const PhysicsShape& a, const PhysicsTransform& transformA, const PhysicsShape& b,
+                         const PhysicsTransform& transformB, float speculativeDistance, PhysicsManifold& manifold)
+    {
+        manifold.PointCount = 0;
+
+        const bool circleA = a.Type == PhysicsShapeType::Circle;
+        const bool circleB = b.Type == PhysicsShapeType::Circle;
+
+        if (circleA && circleB)
+        {
+            return CollideCircles(transformA.Position, a.Radius, transformB.Position, b.Radius, speculativeDistance,
+                                  manifold);
+        }
+
+        if (circleB)
+        {
+            return CollidePolygonCircle(ToWorld(a, transformA), transformB.Position, b.Radius, speculativeDistance,
+                                        manifold);
+        }
+
+        if (circleA)
+        {
+            if (!CollidePolygonCircle(ToWorld(b, transformB), transformA.Position, a.Radius, speculativeDistance,
+                                      manifold))
+                return false;
+
+            manifold.Normal = -manifold.Normal;
+            return true;
+        }
+
+        return CollidePolygons(ToWorld(a, transformA), ToWorld(b, transformB), speculativeDistance, manifold);
+    }
+} // namespace Nova::Collision
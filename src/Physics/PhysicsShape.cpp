@@ -0,0 +1,170 @@
+#include "Nova/Physics/PhysicsShape.hpp"
+#include "Nova/Misc/Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <glm/geometric.hpp>
+
+namespace Nova
+{
+    static float Cross(const glm::vec2& a, const glm::vec2& b)
+    {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    static void ComputeNormals(PhysicsShape& shape)
+    {
+        for (uint32_t i = 0; i < shape.VertexCount; ++i)
+        {
+            const glm::vec2 edge = shape.Vertices[(i + 1) % shape.VertexCount] - shape.Vertices[i];
+            shape.Normals[i] = glm::normalize(glm::vec2(edge.y, -edge.x));
+        }
+    }
+
+    PhysicsShape PhysicsShape::MakeBox(const glm::vec2& halfExtents)
+    {
+        PhysicsShape shape;
+        shape.VertexCount = 4;
+        shape.Vertices[0] = {-halfExtents.x, -halfExtents.y};
+        shape.Vertices[1] = {halfExtents.x, -halfExtents.y};
+        shape.Vertices[2] = {halfExtents.x, halfExtents.y};
+        shape.Vertices[3] = {-halfExtents.x, halfExtents.y};
+        shape.Normals = {{{0.0f, -1.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {-1.0f, 0.0f}}};
+
+        return shape;
+    }
+
+    PhysicsShape PhysicsShape::MakeCircle(float radius)
+    {
+        return {.Type = PhysicsShapeType::Circle, .Radius = radius};
+    }
+
+    PhysicsShape PhysicsShape::MakePolygon(std::span<const glm::vec2> points)
+    {
+        if (points.size() < 3)
+        {
+            Logger::Warning("Polygon shapes need at least 3 points");
+            return {};
+        }
+
+        std::vector<glm::vec2> sorted(points.begin(), points.end());
+
+        std::sort(sorted.begin(), sorted.end(), [](const glm::vec2& lhs, const glm::vec2& rhs) {
+            return (lhs.x != rhs.x) ? lhs.x < rhs.x : lhs.y < rhs.y;
+        });
+
+        // monotone chain, lower then upper hull, dropping collinear points
+        std::vector<glm::vec2> hull(sorted.size() * 2);
+        size_t count = 0;
+
+        const auto addPoint = [&hull, &count](const glm::vec2& point, size_t minCount) {
+            while (count >= minCount && Cross(hull[count - 1] - hull[count - 2], point - hull[count - 2]) <= 1e-6f)
+                --count;
+
+            hull[count++] = point;
+        };
+
+        for (size_t i = 0; i < sorted.size(); ++i)
+            addPoint(sorted[i], 2);
+
+        for (size_t i = sorted.size() - 1, lowerCount = count + 1; i-- > 0;)
+            addPoint(sorted[i], lowerCount);
+
+        // the first point closes the chain
+        count = (count > 0) ? count - 1 : 0;
+
+        if (count < 3 || count > MAX_POLYGON_VERTICES)
+        {
+            Logger::Warning("Polygon shapes need from 3 to {} hull vertices, not {}", MAX_POLYGON_VERTICES, count);
+            return {};
+        }
+
+        PhysicsShape shape;
+        shape.VertexCount = (uint32_t) count;
+
+        glm::vec2 centroid = {0.0f, 0.0f};
+        float area = 0.0f;
+
+        for (uint32_t i = 0; i < shape.VertexCount; ++i)
+        {
+            const glm::vec2& a = hull[i];
+            const glm::vec2& b = hull[(i + 1) % shape.VertexCount];
+            const float triangleArea = 0.5f * Cross(a, b);
+
+            area += triangleArea;
+            centroid += triangleArea * (a + b) / 3.0f;
+        }
+
+        centroid /= area;
+
+        for (uint32_t i = 0; i < shape.VertexCount; ++i)
+            shape.Vertices[i] = hull[i] - centroid;
+
+        ComputeNormals(shape);
+
+        return shape;
+    }
+
+    PhysicsMass PhysicsShape::ComputeMass(float density) const noexcept
+    {
+        if (Type == PhysicsShapeType::Circle)
+        {
+            const float mass = density * 3.14159265f * Radius * Radius;
+            return {.Mass = mass, .Inertia = 0.5f * mass * Radius * Radius};
+        }
+
+        float area = 0.0f;
+        float inertia = 0.0f;
+
+        // triangles from the centroid to every edge
+        for (uint32_t i = 0; i < VertexCount; ++i)
+        {
+            const glm::vec2& a = Vertices[i];
+            const glm::vec2& b = Vertices[(i + 1) % VertexCount];
+            const float cross = Cross(a, b);
+
+            area += 0.5f * cross;
+            inertia += cross * (a.x * a.x + a.x * b.x + b.x * b.x + a.y * a.y + a.y * b.y + b.y * b.y) / 12.0f;
+        }
+
+        return {.Mass = density * area, .Inertia = density * inertia};
+    }
+
+    glm::vec4 PhysicsShape::ComputeBounds(const PhysicsTransform& transform) const noexcept
+    {
+        if (Type == PhysicsShapeType::Circle)
+            return {transform.Position - Radius, transform.Position + Radius};
+
+        const float c = std::cos(transform.Angle);
+        const float s = std::sin(transform.Angle);
+
+        glm::vec2 min = transform.Position;
+        glm::vec2 max = transform.Position;
+
+        for (uint32_t i = 0; i < VertexCount; ++i)
+        {
+            const glm::vec2& vertex = Vertices[i];
+            const glm::vec2 point =
+                transform.Position + glm::vec2(c * vertex.x - s * vertex.y, s * vertex.x + c * vertex.y);
+
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        return {min, max};
+    }
+
+    float PhysicsShape::ComputeExtent() const noexcept
+    {
+        if (Type == PhysicsShapeType::Circle)
+            return Radius;
+
+        float extent = 0.0f;
+
+        for (uint32_t i = 0; i < VertexCount; ++i)
+            extent = std::max(extent, glm::length(Vertices[i]));
+
+        return extent;
+    }
+} // namespace Nova
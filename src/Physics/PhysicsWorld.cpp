@@ -0,0 +1,826 @@
+#include "Nova/Physics/PhysicsWorld.hpp"
+#include "Nova/Core/JobSystem.hpp"
+#include "Nova/Misc/Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <glm/geometric.hpp>
+
+namespace Nova
+{
+    // pairs checked for contacts by a single job
+    static constexpr uint32_t CONTACT_GRAIN_SIZE = 256;
+
+    // islands are split in about this many jobs
+    static constexpr uint32_t ISLAND_JOB_COUNT = 256;
+
+    // past this condition number the points of a contact are solved one by one
+    static constexpr float MAX_BLOCK_CONDITION = 1000.0f;
+
+    // contacts are made this many linear slops before the shapes touch, so the solver sees them coming
+    static constexpr float SPECULATIVE_SLOPS = 4.0f;
+
+    static float Cross(const glm::vec2& a, const glm::vec2& b)
+    {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    // angular velocity crossed with an anchor, the velocity of the anchor from the rotation
+    static glm::vec2 Cross(float w, const glm::vec2& r)
+    {
+        return {-w * r.y, w * r.x};
+    }
+
+    static bool Contains(const glm::vec4& outer, const glm::vec4& inner)
+    {
+        return outer.x <= inner.x && outer.y <= inner.y && outer.z >= inner.z && outer.w >= inner.w;
+    }
+
+    PhysicsWorld::PhysicsWorld(const PhysicsWorldConfig& config)
+        : m_Config(config), m_Broadphase(config.CellSize)
+    {
+    }
+
+    PhysicsBodyID PhysicsWorld::CreateBody(const PhysicsBodyConfig& config)
+    {
+        if (config.Shape.IsEmpty())
+        {
+            Logger::Warning("Physics bodies need a shape");
+            return INVALID_PHYSICS_BODY;
+        }
+
+        PhysicsBodyID id = m_FirstFree;
+
+        if (id != INVALID_PHYSICS_BODY)
+            m_FirstFree = m_Bodies[id].NextFree;
+        else
+        {
+            id = (PhysicsBodyID) m_Bodies.size();
+            m_Bodies.emplace_back();
+        }
+
+        const bool moves = config.Type != PhysicsBodyType::Static;
+
+        Body& body = m_Bodies[id];
+        body = {
+            .Shape = config.Shape,
+            .Transform = config.Transform,
+            .PreviousTransform = config.Transform,
+            .LinearVelocity = moves ? config.LinearVelocity : glm::vec2(0.0f),
+            .AngularVelocity = (moves && !config.FixedRotation) ? config.AngularVelocity : 0.0f,
+            .Friction = config.Friction,
+            .Restitution = config.Restitution,
+            .LinearDamping = config.LinearDamping,
+            .AngularDamping = config.AngularDamping,
+            .GravityScale = config.GravityScale,
+            .Extent = config.Shape.ComputeExtent(),
+            .Type = config.Type,
+            .Awake = moves,
+            .AllowSleep = config.AllowSleep,
+            .Alive = true,
+            .UserData = config.UserData,
+        };
+
+        // static and kinematic bodies have infinite mass
+        if (config.Type == PhysicsBodyType::Dynamic)
+        {
+            const PhysicsMass mass = config.Shape.ComputeMass(config.Density);
+
+            body.InvMass = (mass.Mass > 0.0f) ? 1.0f / mass.Mass : 1.0f;
+            body.InvInertia = (!config.FixedRotation && mass.Inertia > 0.0f) ? 1.0f / mass.Inertia : 0.0f;
+        }
+
+        const glm::vec4 bounds = config.Shape.ComputeBounds(config.Transform);
+        const float margin = m_Config.AABBMargin;
+
+        body.Bounds = {bounds.x - margin, bounds.y - margin, bounds.z + margin, bounds.w + margin};
+        body.Proxy = m_Broadphase.Insert({body.Bounds.x, body.Bounds.y}, {body.Bounds.z, body.Bounds.w}, id);
+
+        return id;
+    }
+
+    void PhysicsWorld::DestroyBody(PhysicsBodyID body)
+    {
+        if (body >= m_Bodies.size() || !m_Bodies[body].Alive)
+            return;
+
+        Body& data = m_Bodies[body];
+
+        // what rested on the body falls
+        WakeOverlapping(data.Bounds);
+
+        m_Broadphase.Remove(data.Proxy);
+        data.Proxy = INVALID_SPATIAL_PROXY;
+        data.Alive = false;
+        data.Awake = false;
+
+        m_Destroyed.push_back(body);
+    }
+
+    void PhysicsWorld::Clear()
+    {
+        m_Broadphase = SpatialHash(m_Config.CellSize);
+        m_Accumulator = 0.0f;
+        m_Stats = {};
+
+        m_Bodies.clear();
+        m_FirstFree = INVALID_PHYSICS_BODY;
+        m_Destroyed.clear();
+        m_Contacts.clear();
+        m_Islands.clear();
+    }
+
+    uint32_t PhysicsWorld::Update(float deltaTime)
+    {
+        m_Accumulator += deltaTime;
+
+        uint32_t steps = 0;
+
+        while (m_Accumulator >= m_Config.TimeStep && steps < m_Config.MaxStepsPerUpdate)
+        {
+            Step();
+
+            m_Accumulator -= m_Config.TimeStep;
+            ++steps;
+        }
+
+        // the time that didn't fit in the steps is dropped
+        m_Accumulator = std::fmod(m_Accumulator, m_Config.TimeStep);
+
+        return steps;
+    }
+
+    void PhysicsWorld::Step()
+    {
+        for (Body& body : m_Bodies)
+            body.PreviousTransform = body.Transform;
+
+        UpdateContacts();
+        BuildIslands();
+
+        const uint32_t islandCount = (uint32_t) m_Islands.size();
+        const uint32_t grainSize = std::max(islandCount / ISLAND_JOB_COUNT, 1u);
+
+        JobSystem::ParallelFor(islandCount, grainSize, [this](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+                SolveIsland(m_Islands[i]);
+        });
+
+        UpdateBroadphase();
+
+        // nothing refers to the destroyed bodies anymore
+        for (PhysicsBodyID body : m_Destroyed)
+        {
+            m_Bodies[body].NextFree = m_FirstFree;
+            m_FirstFree = body;
+        }
+
+        m_Destroyed.clear();
+
+        m_Stats = {};
+
+        for (const Body& body : m_Bodies)
+        {
+            m_Stats.Bodies += body.Alive ? 1 : 0;
+            m_Stats.AwakeBodies += body.Awake ? 1 : 0;
+        }
+
+        m_Stats.Contacts = (uint32_t) m_Contacts.size();
+        m_Stats.Islands = islandCount;
+    }
+
+    void PhysicsWorld::UpdateContacts()
+    {
+        m_Pairs.clear();
+        m_Broadphase.FindPairs(m_Pairs);
+
+        // pairs that can't move towards each other
+        std::erase_if(m_Pairs, [this](const SpatialPair& pair) {
+            return m_Bodies[pair.A].Type != PhysicsBodyType::Dynamic &&
+                   m_Bodies[pair.B].Type != PhysicsBodyType::Dynamic;
+        });
+
+        m_NewContacts.resize(m_Pairs.size());
+
+        const float speculativeDistance = SPECULATIVE_SLOPS * m_Config.LinearSlop;
+
+        JobSystem::ParallelFor((uint32_t) m_Pairs.size(), CONTACT_GRAIN_SIZE, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const PhysicsBodyID idA = std::min(m_Pairs[i].A, m_Pairs[i].B);
+                const PhysicsBodyID idB = std::max(m_Pairs[i].A, m_Pairs[i].B);
+                const Body& a = m_Bodies[idA];
+                const Body& b = m_Bodies[idB];
+
+                Contact& contact = m_NewContacts[i];
+                const uint64_t key = ((uint64_t) idA << 32) | idB;
+
+                // sleeping bodies haven't moved, their contact is the same as in the last step
+                if (!a.Awake && !b.Awake)
+                {
+                    const auto previous = std::lower_bound(
+                        m_Contacts.begin(), m_Contacts.end(), key,
+                        [](const Contact& contact, uint64_t key) { return contact.Key < key; });
+
+                    if (previous != m_Contacts.end() && previous->Key == key)
+                        contact = *previous;
+                    else
+                        contact.PointCount = 0;
+
+                    continue;
+                }
+
+                PhysicsManifold manifold;
+
+                if (!Collision::ComputeManifold(a.Shape, a.Transform, b.Shape, b.Transform, speculativeDistance,
+                                                manifold))
+                {
+                    contact.PointCount = 0;
+                    continue;
+                }
+
+                contact = {
+                    .Key = key,
+                    .A = idA,
+                    .B = idB,
+                    .Normal = manifold.Normal,
+                    .PointCount = manifold.PointCount,
+                    .Friction = std::sqrt(a.Friction * b.Friction),
+                    .Restitution = std::max(a.Restitution, b.Restitution),
+                };
+
+                for (uint32_t p = 0; p < manifold.PointCount; ++p)
+                {
+                    const PhysicsContactPoint& point = manifold.Points[p];
+
+                    contact.Points[p] = {
+                        .AnchorA = point.Position - a.Transform.Position,
+                        .AnchorB = point.Position - b.Transform.Position,
+                        .Separation = point.Separation,
+                        .ID = point.ID,
+                    };
+                }
+            }
+        });
+
+        std::erase_if(m_NewContacts, [](const Contact& contact) { return contact.PointCount == 0; });
+
+        std::sort(m_NewContacts.begin(), m_NewContacts.end(),
+                  [](const Contact& lhs, const Contact& rhs) { return lhs.Key < rhs.Key; });
+
+        // warm starting, the points that were already there start from their last impulses
+        size_t previous = 0;
+
+        for (Contact& contact : m_NewContacts)
+        {
+            while (previous < m_Contacts.size() && m_Contacts[previous].Key < contact.Key)
+                ++previous;
+
+            if (previous == m_Contacts.size())
+                break;
+
+            const Contact& old = m_Contacts[previous];
+
+            if (old.Key != contact.Key)
+                continue;
+
+            for (uint32_t p = 0; p < contact.PointCount; ++p)
+            {
+                for (uint32_t q = 0; q < old.PointCount; ++q)
+                {
+                    if (contact.Points[p].ID != old.Points[q].ID)
+                        continue;
+
+                    contact.Points[p].NormalImpulse = old.Points[q].NormalImpulse;
+                    contact.Points[p].TangentImpulse = old.Points[q].TangentImpulse;
+                    break;
+                }
+            }
+        }
+
+        std::swap(m_Contacts, m_NewContacts);
+
+        // moving kinematic bodies wake up what they touch, dynamic ones wake up their whole island
+        for (const Contact& contact : m_Contacts)
+        {
+            Body& a = m_Bodies[contact.A];
+            Body& b = m_Bodies[contact.B];
+
+            if (a.Type == PhysicsBodyType::Kinematic && a.Awake)
+                WakeUp(b);
+            else if (b.Type == PhysicsBodyType::Kinematic && b.Awake)
+                WakeUp(a);
+        }
+    }
+
+    void PhysicsWorld::BuildIslands()
+    {
+        const uint32_t bodyCount = (uint32_t) m_Bodies.size();
+
+        m_IslandRoots.resize(bodyCount);
+
+        for (uint32_t i = 0; i < bodyCount; ++i)
+            m_IslandRoots[i] = i;
+
+        const auto find = [this](uint32_t body) {
+            while (m_IslandRoots[body] != body)
+            {
+                m_IslandRoots[body] = m_IslandRoots[m_IslandRoots[body]];
+                body = m_IslandRoots[body];
+            }
+
+            return body;
+        };
+
+        // static and kinematic bodies don't join islands, nothing a contact does moves them
+        for (const Contact& contact : m_Contacts)
+        {
+            if (m_Bodies[contact.A].Type != PhysicsBodyType::Dynamic ||
+                m_Bodies[contact.B].Type != PhysicsBodyType::Dynamic)
+                continue;
+
+            const uint32_t rootA = find(contact.A);
+            const uint32_t rootB = find(contact.B);
+
+            if (rootA != rootB)
+                m_IslandRoots[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+
+        m_Islands.clear();
+
+        // roots are the lowest ID of their island, so they come first
+        for (uint32_t i = 0; i < bodyCount; ++i)
+        {
+            Body& body = m_Bodies[i];
+
+            if (body.Type != PhysicsBodyType::Dynamic || !body.Alive)
+                continue;
+
+            // every link points to a lower ID, already pointing to its root
+            const uint32_t root = m_IslandRoots[m_IslandRoots[i]];
+            m_IslandRoots[i] = root;
+
+            if (root == i)
+            {
+                body.Island = (uint32_t) m_Islands.size();
+                m_Islands.emplace_back();
+            }
+            else
+                body.Island = m_Bodies[root].Island;
+
+            m_Islands[body.Island].Awake |= body.Awake;
+        }
+
+        const auto contactIsland = [this](const Contact& contact) -> Island& {
+            const Body& a = m_Bodies[contact.A];
+            return m_Islands[(a.Type == PhysicsBodyType::Dynamic) ? a.Island : m_Bodies[contact.B].Island];
+        };
+
+        // an awake body wakes up its whole island
+        for (uint32_t i = 0; i < bodyCount; ++i)
+        {
+            Body& body = m_Bodies[i];
+
+            if (body.Type != PhysicsBodyType::Dynamic || !body.Alive || !m_Islands[body.Island].Awake)
+                continue;
+
+            if (!body.Awake)
+                WakeUp(body);
+
+            ++m_Islands[body.Island].BodyCount;
+        }
+
+        for (const Contact& contact : m_Contacts)
+        {
+            Island& island = contactIsland(contact);
+            island.ContactCount += island.Awake ? 1 : 0;
+        }
+
+        uint32_t bodyOffset = 0;
+        uint32_t contactOffset = 0;
+
+        for (Island& island : m_Islands)
+        {
+            island.FirstBody = bodyOffset;
+            island.FirstContact = contactOffset;
+            bodyOffset += island.BodyCount;
+            contactOffset += island.ContactCount;
+
+            // counted again while filling
+            island.BodyCount = 0;
+            island.ContactCount = 0;
+        }
+
+        m_IslandBodies.resize(bodyOffset);
+        m_IslandContacts.resize(contactOffset);
+
+        for (uint32_t i = 0; i < bodyCount; ++i)
+        {
+            const Body& body = m_Bodies[i];
+
+            if (body.Type == PhysicsBodyType::Dynamic && body.Awake)
+            {
+                Island& island = m_Islands[body.Island];
+                m_IslandBodies[island.FirstBody + island.BodyCount++] = i;
+            }
+        }
+
+        for (uint32_t i = 0; i < m_Contacts.size(); ++i)
+        {
+            Island& island = contactIsland(m_Contacts[i]);
+
+            if (island.Awake)
+                m_IslandContacts[island.FirstContact + island.ContactCount++] = i;
+        }
+
+        std::erase_if(m_Islands, [](const Island& island) { return !island.Awake; });
+
+        // the biggest islands first, so they don't end up last on a single thread
+        std::stable_sort(m_Islands.begin(), m_Islands.end(),
+                         [](const Island& lhs, const Island& rhs) { return lhs.BodyCount > rhs.BodyCount; });
+    }
+
+    // only touches the bodies and contacts of the island, islands are solved at the same time
+    void PhysicsWorld::SolveIsland(const Island& island)
+    {
+        const float dt = m_Config.TimeStep;
+        const float invDt = 1.0f / dt;
+
+        const uint32_t* bodies = m_IslandBodies.data() + island.FirstBody;
+        const uint32_t* contacts = m_IslandContacts.data() + island.FirstContact;
+
+        for (uint32_t i = 0; i < island.BodyCount; ++i)
+        {
+            Body& body = m_Bodies[bodies[i]];
+
+            body.LinearVelocity += dt * (m_Config.Gravity * body.GravityScale + body.InvMass * body.Force);
+            body.LinearVelocity *= 1.0f / (1.0f + dt * body.LinearDamping);
+            body.AngularVelocity *= 1.0f / (1.0f + dt * body.AngularDamping);
+        }
+
+        // static and kinematic bodies are shared between islands, only dynamic ones are written
+        const auto applyImpulse = [](Body& a, Body& b, const ContactPoint& point, const glm::vec2& impulse) {
+            if (a.Type == PhysicsBodyType::Dynamic)
+            {
+                a.LinearVelocity -= a.InvMass * impulse;
+                a.AngularVelocity -= a.InvInertia * Cross(point.AnchorA, impulse);
+            }
+
+            if (b.Type == PhysicsBodyType::Dynamic)
+            {
+                b.LinearVelocity += b.InvMass * impulse;
+                b.AngularVelocity += b.InvInertia * Cross(point.AnchorB, impulse);
+            }
+        };
+
+        const auto relativeVelocity = [](const Body& a, const Body& b, const ContactPoint& point) {
+            return b.LinearVelocity + Cross(b.AngularVelocity, point.AnchorB) - a.LinearVelocity -
+                   Cross(a.AngularVelocity, point.AnchorA);
+        };
+
+        for (uint32_t i = 0; i < island.ContactCount; ++i)
+        {
+            Contact& contact = m_Contacts[contacts[i]];
+            Body& a = m_Bodies[contact.A];
+            Body& b = m_Bodies[contact.B];
+
+            const glm::vec2 normal = contact.Normal;
+            const glm::vec2 tangent = {normal.y, -normal.x};
+
+            for (uint32_t p = 0; p < contact.PointCount; ++p)
+            {
+                ContactPoint& point = contact.Points[p];
+
+                const float rnA = Cross(point.AnchorA, normal);
+                const float rnB = Cross(point.AnchorB, normal);
+                const float rtA = Cross(point.AnchorA, tangent);
+                const float rtB = Cross(point.AnchorB, tangent);
+
+                const float normalMass = a.InvMass + b.InvMass + a.InvInertia * rnA * rnA + b.InvInertia * rnB * rnB;
+                const float tangentMass = a.InvMass + b.InvMass + a.InvInertia * rtA * rtA + b.InvInertia * rtB * rtB;
+
+                point.NormalMass = (normalMass > 0.0f) ? 1.0f / normalMass : 0.0f;
+                point.TangentMass = (tangentMass > 0.0f) ? 1.0f / tangentMass : 0.0f;
+
+                // shapes apart may only close the gap this step, overlapping ones are pushed out
+                if (point.Separation > 0.0f)
+                    point.TargetVelocity = -point.Separation * invDt;
+                else
+                {
+                    point.TargetVelocity =
+                        m_Config.Baumgarte * invDt * std::max(-point.Separation - m_Config.LinearSlop, 0.0f);
+                }
+
+                const float normalVelocity = glm::dot(relativeVelocity(a, b, point), normal);
+
+                // only once the shapes meet within this step, a speculative point bouncing early adds energy
+                if (contact.Restitution > 0.0f && normalVelocity < -m_Config.RestitutionThreshold &&
+                    point.Separation + normalVelocity * dt < 0.0f)
+                    point.TargetVelocity = std::max(point.TargetVelocity, -contact.Restitution * normalVelocity);
+            }
+
+            contact.SolveBlock = false;
+
+            if (contact.PointCount < 2)
+                continue;
+
+            const float rn1A = Cross(contact.Points[0].AnchorA, normal);
+            const float rn1B = Cross(contact.Points[0].AnchorB, normal);
+            const float rn2A = Cross(contact.Points[1].AnchorA, normal);
+            const float rn2B = Cross(contact.Points[1].AnchorB, normal);
+            const float mass = a.InvMass + b.InvMass;
+
+            contact.K11 = mass + a.InvInertia * rn1A * rn1A + b.InvInertia * rn1B * rn1B;
+            contact.K22 = mass + a.InvInertia * rn2A * rn2A + b.InvInertia * rn2B * rn2B;
+            contact.K12 = mass + a.InvInertia * rn1A * rn2A + b.InvInertia * rn1B * rn2B;
+
+            const float determinant = contact.K11 * contact.K22 - contact.K12 * contact.K12;
+            contact.SolveBlock = contact.K11 * contact.K11 < MAX_BLOCK_CONDITION * determinant;
+        }
+
+        // warm started after every approach speed is measured, or the impulses holding a pile up look like impacts
+        // and bounce
+        for (uint32_t i = 0; i < island.ContactCount; ++i)
+        {
+            const Contact& contact = m_Contacts[contacts[i]];
+            const glm::vec2 tangent = {contact.Normal.y, -contact.Normal.x};
+
+            for (uint32_t p = 0; p < contact.PointCount; ++p)
+            {
+                const ContactPoint& point = contact.Points[p];
+                applyImpulse(m_Bodies[contact.A], m_Bodies[contact.B], point,
+                             point.NormalImpulse * contact.Normal + point.TangentImpulse * tangent);
+            }
+        }
+
+        for (uint32_t iteration = 0; iteration < m_Config.VelocityIterations; ++iteration)
+        {
+            for (uint32_t i = 0; i < island.ContactCount; ++i)
+            {
+                Contact& contact = m_Contacts[contacts[i]];
+                Body& a = m_Bodies[contact.A];
+                Body& b = m_Bodies[contact.B];
+
+                const glm::vec2 normal = contact.Normal;
+                const glm::vec2 tangent = {normal.y, -normal.x};
+
+                // friction first, bounded by the normal impulse of the last iteration
+                for (uint32_t p = 0; p < contact.PointCount; ++p)
+                {
+                    ContactPoint& point = contact.Points[p];
+
+                    const float maxFriction = contact.Friction * point.NormalImpulse;
+                    const float lambda = -point.TangentMass * glm::dot(relativeVelocity(a, b, point), tangent);
+                    const float impulse = std::clamp(point.TangentImpulse + lambda, -maxFriction, maxFriction);
+
+                    applyImpulse(a, b, point, (impulse - point.TangentImpulse) * tangent);
+                    point.TangentImpulse = impulse;
+                }
+
+                // both points at once, so neither is solved first and stacks stay symmetric. The impulses have to be
+                // positive, with the velocities reaching the targets where they aren't zero: as in Box2D, each case
+                // of the points pushing or not is tried in turn.
+                if (contact.SolveBlock)
+                {
+                    ContactPoint& point1 = contact.Points[0];
+                    ContactPoint& point2 = contact.Points[1];
+
+                    const glm::vec2 accumulated = {point1.NormalImpulse, point2.NormalImpulse};
+
+                    // velocities towards the targets, as if the accumulated impulses weren't applied
+                    const float b1 = glm::dot(relativeVelocity(a, b, point1), normal) - point1.TargetVelocity -
+                                     (contact.K11 * accumulated.x + contact.K12 * accumulated.y);
+                    const float b2 = glm::dot(relativeVelocity(a, b, point2), normal) - point2.TargetVelocity -
+                                     (contact.K12 * accumulated.x + contact.K22 * accumulated.y);
+
+                    const float determinant = contact.K11 * contact.K22 - contact.K12 * contact.K12;
+                    const glm::vec2 both = {(contact.K12 * b2 - contact.K22 * b1) / determinant,
+                                            (contact.K12 * b1 - contact.K11 * b2) / determinant};
+                    const float first = -b1 / contact.K11;
+                    const float second = -b2 / contact.K22;
+
+                    // when no case fits, the impulses stay as they were
+                    glm::vec2 impulse = accumulated;
+
+                    if (both.x >= 0.0f && both.y >= 0.0f)
+                        impulse = both;
+                    else if (first >= 0.0f && contact.K12 * first + b2 >= 0.0f)
+                        impulse = {first, 0.0f};
+                    else if (second >= 0.0f && contact.K12 * second + b1 >= 0.0f)
+                        impulse = {0.0f, second};
+                    else if (b1 >= 0.0f && b2 >= 0.0f)
+                        impulse = {0.0f, 0.0f};
+
+                    applyImpulse(a, b, point1, (impulse.x - accumulated.x) * normal);
+                    applyImpulse(a, b, point2, (impulse.y - accumulated.y) * normal);
+                    point1.NormalImpulse = impulse.x;
+                    point2.NormalImpulse = impulse.y;
+                    continue;
+                }
+
+                for (uint32_t p = 0; p < contact.PointCount; ++p)
+                {
+                    ContactPoint& point = contact.Points[p];
+
+                    const float normalVelocity = glm::dot(relativeVelocity(a, b, point), normal);
+                    const float lambda = point.NormalMass * (point.TargetVelocity - normalVelocity);
+                    const float impulse = std::max(point.NormalImpulse + lambda, 0.0f);
+
+                    applyImpulse(a, b, point, (impulse - point.NormalImpulse) * normal);
+                    point.NormalImpulse = impulse;
+                }
+            }
+        }
+
+        float minSleepTime = std::numeric_limits<float>::max();
+
+        for (uint32_t i = 0; i < island.BodyCount; ++i)
+        {
+            Body& body = m_Bodies[bodies[i]];
+
+            body.Transform.Position += dt * body.LinearVelocity;
+            body.Transform.Angle += dt * body.AngularVelocity;
+            body.Force = {0.0f, 0.0f};
+
+            body.Enlarged = !Contains(body.Bounds, body.Shape.ComputeBounds(body.Transform));
+
+            // the fastest any point of the body can move
+            const bool moving = glm::length(body.LinearVelocity) + body.Extent * std::abs(body.AngularVelocity) >
+                                m_Config.SleepVelocity;
+
+            if (!body.AllowSleep || moving)
+                body.SleepTime = 0.0f;
+            else
+                body.SleepTime += dt;
+
+            minSleepTime = std::min(minSleepTime, body.SleepTime);
+        }
+
+        // the whole island sleeps, or none of it
+        if (minSleepTime < m_Config.TimeToSleep)
+            return;
+
+        for (uint32_t i = 0; i < island.BodyCount; ++i)
+        {
+            Body& body = m_Bodies[bodies[i]];
+
+            body.Awake = false;
+            body.LinearVelocity = {0.0f, 0.0f};
+            body.AngularVelocity = 0.0f;
+        }
+    }
+
+    void PhysicsWorld::UpdateBroadphase()
+    {
+        const float dt = m_Config.TimeStep;
+
+        for (Body& body : m_Bodies)
+        {
+            if (body.Type == PhysicsBodyType::Kinematic && body.Awake)
+            {
+                body.Transform.Position += dt * body.LinearVelocity;
+                body.Transform.Angle += dt * body.AngularVelocity;
+                MoveProxy(body);
+
+                // still kinematic bodies don't wake anything up
+                body.Awake = body.LinearVelocity != glm::vec2(0.0f) || body.AngularVelocity != 0.0f;
+            }
+            else if (body.Enlarged)
+            {
+                MoveProxy(body);
+                body.Enlarged = false;
+            }
+        }
+    }
+
+    void PhysicsWorld::MoveProxy(Body& body)
+    {
+        const glm::vec4 bounds = body.Shape.ComputeBounds(body.Transform);
+
+        if (Contains(body.Bounds, bounds))
+            return;
+
+        const float margin = m_Config.AABBMargin;
+
+        body.Bounds = {bounds.x - margin, bounds.y - margin, bounds.z + margin, bounds.w + margin};
+        m_Broadphase.Move(body.Proxy, {body.Bounds.x, body.Bounds.y}, {body.Bounds.z, body.Bounds.w});
+    }
+
+    void PhysicsWorld::WakeUp(Body& body) noexcept
+    {
+        if (body.Type == PhysicsBodyType::Static)
+            return;
+
+        body.Awake = true;
+        body.SleepTime = 0.0f;
+    }
+
+    void PhysicsWorld::WakeOverlapping(const glm::vec4& bounds)
+    {
+        std::vector<uint32_t> overlapping;
+        m_Broadphase.QueryAABB({bounds.x, bounds.y}, {bounds.z, bounds.w}, overlapping);
+
+        for (uint32_t body : overlapping)
+        {
+            if (m_Bodies[body].Type == PhysicsBodyType::Dynamic)
+                WakeUp(m_Bodies[body]);
+        }
+    }
+
+    PhysicsTransform PhysicsWorld::GetInterpolatedTransform(PhysicsBodyID body) const noexcept
+    {
+        const Body& data = m_Bodies[body];
+        const float alpha = m_Accumulator / m_Config.TimeStep;
+
+        return {
+            .Position = data.PreviousTransform.Position +
+                        alpha * (data.Transform.Position - data.PreviousTransform.Position),
+            .Angle = data.PreviousTransform.Angle + alpha * (data.Transform.Angle - data.PreviousTransform.Angle),
+        };
+    }
+
+    void PhysicsWorld::SetTransform(PhysicsBodyID body, const PhysicsTransform& transform)
+    {
+        Body& data = m_Bodies[body];
+
+        // the bodies around a static one have to notice it moved, where it was and where it is
+        if (data.Type == PhysicsBodyType::Static)
+            WakeOverlapping(data.Bounds);
+
+        data.Transform = transform;
+        data.PreviousTransform = transform;
+        MoveProxy(data);
+
+        if (data.Type == PhysicsBodyType::Static)
+            WakeOverlapping(data.Bounds);
+        else
+            WakeUp(data);
+    }
+
+    void PhysicsWorld::SetLinearVelocity(PhysicsBodyID body, const glm::vec2& velocity)
+    {
+        Body& data = m_Bodies[body];
+
+        if (data.Type == PhysicsBodyType::Static)
+            return;
+
+        data.LinearVelocity = velocity;
+        WakeUp(data);
+    }
+
+    void PhysicsWorld::SetAngularVelocity(PhysicsBodyID body, float velocity)
+    {
+        Body& data = m_Bodies[body];
+
+        // static bodies and fixed rotations
+        if (data.Type == PhysicsBodyType::Static || (data.Type == PhysicsBodyType::Dynamic && data.InvInertia == 0.0f))
+            return;
+
+        data.AngularVelocity = velocity;
+        WakeUp(data);
+    }
+
+    void PhysicsWorld::ApplyForce(PhysicsBodyID body, const glm::vec2& force)
+    {
+        Body& data = m_Bodies[body];
+
+        if (data.Type != PhysicsBodyType::Dynamic)
+            return;
+
+        data.Force += force;
+        WakeUp(data);
+    }
+
+    void PhysicsWorld::ApplyImpulse(PhysicsBodyID body, const glm::vec2& impulse, const glm::vec2& point)
+    {
+        Body& data = m_Bodies[body];
+
+        if (data.Type != PhysicsBodyType::Dynamic)
+            return;
+
+        data.LinearVelocity += data.InvMass * impulse;
+        data.AngularVelocity += data.InvInertia * Cross(point - data.Transform.Position, impulse);
+        WakeUp(data);
+    }
+
+    void PhysicsWorld::SetAwake(PhysicsBodyID body, bool awake)
+    {
+        Body& data = m_Bodies[body];
+
+        if (awake)
+        {
+            WakeUp(data);
+            return;
+        }
+
+        if (data.Type == PhysicsBodyType::Static)
+            return;
+
+        data.Awake = false;
+        data.SleepTime = 0.0f;
+        data.LinearVelocity = {0.0f, 0.0f};
+        data.AngularVelocity = 0.0f;
+    }
+} // namespace Nova
@@ -0,0 +1,495 @@
+#include "Nova/Physics/SpatialHash.hpp"
+#include "Nova/Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <glm/geometric.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOVA_SPATIAL_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Nova
+{
+    // cells checked for pairs by a single job
+    static constexpr uint32_t PAIR_GRAIN_SIZE = 64;
+
+    // keeps cell coordinates far from overflowing, whatever the boxes
+    static constexpr float MAX_CELL_COORDINATE = 1 << 30;
+
+    // cells are kept until there are this many empty ones, and they're half of the cells
+    static constexpr uint32_t MIN_EMPTY_CELLS = 4096;
+
+    static constexpr uint32_t MIN_SLOT_COUNT = 64;
+
+    static constexpr uint64_t PackCell(int32_t x, int32_t y)
+    {
+        return ((uint64_t) (uint32_t) x << 32) | (uint32_t) y;
+    }
+
+    // cell coordinates are clamped, so no cell packs to this
+    static constexpr uint64_t EMPTY_SLOT = PackCell(INT32_MIN, 0);
+
+#ifdef NOVA_SPATIAL_SSE
+    using BoundsVector = __m128;
+
+    // bounds of a box as the query that overlaps them: max x, max y, -min x, -min y
+    static BoundsVector ToQuery(const float* bounds)
+    {
+        const __m128 value = _mm_load_ps(bounds);
+        return _mm_xor_ps(_mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)), _mm_set1_ps(-0.0f));
+    }
+
+    static bool Overlaps(const float* bounds, BoundsVector query)
+    {
+        return _mm_movemask_ps(_mm_cmple_ps(_mm_load_ps(bounds), query)) == 0xF;
+    }
+#else
+    struct BoundsVector
+    {
+        float Lanes[4];
+    };
+
+    static BoundsVector ToQuery(const float* bounds)
+    {
+        return {{-bounds[2], -bounds[3], -bounds[0], -bounds[1]}};
+    }
+
+    static bool Overlaps(const float* bounds, const BoundsVector& query)
+    {
+        return bounds[0] <= query.Lanes[0] && bounds[1] <= query.Lanes[1] && bounds[2] <= query.Lanes[2] &&
+               bounds[3] <= query.Lanes[3];
+    }
+#endif
+
+    SpatialHash::SpatialHash(float cellSize)
+        : m_CellSize(std::max(cellSize, 1e-3f)), m_InvCellSize(1.0f / m_CellSize)
+    {
+    }
+
+    glm::ivec4 SpatialHash::GetCellRange(const glm::vec2& min, const glm::vec2& max) const noexcept
+    {
+        const auto toCell = [this](float value) {
+            return (int32_t) std::clamp(std::floor(value * m_InvCellSize), -MAX_CELL_COORDINATE, MAX_CELL_COORDINATE);
+        };
+
+        return {toCell(min.x), toCell(min.y), toCell(max.x), toCell(max.y)};
+    }
+
+    uint32_t SpatialHash::FindSlot(uint64_t key) const noexcept
+    {
+        const uint32_t mask = (uint32_t) m_SlotKeys.size() - 1;
+        uint32_t slot = (uint32_t) ((key * 0x9E3779B97F4A7C15ull) >> m_SlotShift);
+
+        while (m_SlotKeys[slot] != key && m_SlotKeys[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & mask;
+
+        return slot;
+    }
+
+    const SpatialHash::Cell* SpatialHash::FindCell(int32_t x, int32_t y) const
+    {
+        if (m_Cells.empty())
+            return nullptr;
+
+        const uint32_t slot = FindSlot(PackCell(x, y));
+        return (m_SlotKeys[slot] != EMPTY_SLOT) ? &m_Cells[m_SlotCells[slot]] : nullptr;
+    }
+
+    SpatialHash::Cell& SpatialHash::GetOrAddCell(int32_t x, int32_t y)
+    {
+        // at most half full
+        if ((m_Cells.size() + 1) * 2 > m_SlotKeys.size())
+            Rehash(std::max((uint32_t) m_SlotKeys.size() * 2, MIN_SLOT_COUNT));
+
+        const uint64_t key = PackCell(x, y);
+        const uint32_t slot = FindSlot(key);
+
+        if (m_SlotKeys[slot] == EMPTY_SLOT)
+        {
+            m_SlotKeys[slot] = key;
+            m_SlotCells[slot] = (uint32_t) m_Cells.size();
+            m_Cells.push_back({.X = x, .Y = y});
+            ++m_EmptyCells;
+        }
+
+        return m_Cells[m_SlotCells[slot]];
+    }
+
+    void SpatialHash::Rehash(uint32_t slotCount)
+    {
+        m_SlotKeys.assign(slotCount, EMPTY_SLOT);
+        m_SlotCells.resize(slotCount);
+        m_SlotShift = 64 - std::countr_zero(slotCount);
+
+        for (uint32_t index = 0; index < m_Cells.size(); ++index)
+        {
+            const uint64_t key = PackCell(m_Cells[index].X, m_Cells[index].Y);
+            const uint32_t slot = FindSlot(key);
+
+            m_SlotKeys[slot] = key;
+            m_SlotCells[slot] = index;
+        }
+    }
+
+    void SpatialHash::Compact()
+    {
+        std::erase_if(m_Cells, [](const Cell& cell) { return cell.Entries.empty(); });
+        m_EmptyCells = 0;
+
+        uint32_t slotCount = MIN_SLOT_COUNT;
+
+        while (m_Cells.size() * 2 > slotCount)
+            slotCount *= 2;
+
+        Rehash(slotCount);
+    }
+
+    SpatialProxy SpatialHash::Insert(const glm::vec2& min, const glm::vec2& max, uint32_t userData)
+    {
+        SpatialProxy proxy = m_FirstFree;
+
+        if (proxy != INVALID_SPATIAL_PROXY)
+            m_FirstFree = m_Proxies[proxy].NextFree;
+        else
+        {
+            proxy = (SpatialProxy) m_Proxies.size();
+            m_Proxies.emplace_back();
+        }
+
+        Proxy& data = m_Proxies[proxy];
+        data.Cells = GetCellRange(min, max);
+        data.UserData = userData;
+        data.NextFree = INVALID_SPATIAL_PROXY;
+
+        AddToCells(proxy, {
+            .Bounds = {min.x, min.y, -max.x, -max.y},
+            .Proxy = proxy,
+            .UserData = userData,
+            .FirstCellX = data.Cells.x,
+            .FirstCellY = data.Cells.y,
+        });
+
+        return proxy;
+    }
+
+    void SpatialHash::Move(SpatialProxy proxy, const glm::vec2& min, const glm::vec2& max)
+    {
+        Proxy& data = m_Proxies[proxy];
+        const glm::ivec4 cells = GetCellRange(min, max);
+
+        if (cells != data.Cells)
+        {
+            RemoveFromCells(proxy);
+            data.Cells = cells;
+
+            AddToCells(proxy, {
+                .Bounds = {min.x, min.y, -max.x, -max.y},
+                .Proxy = proxy,
+                .UserData = data.UserData,
+                .FirstCellX = cells.x,
+                .FirstCellY = cells.y,
+            });
+
+            if (m_EmptyCells > MIN_EMPTY_CELLS && m_EmptyCells * 2 > m_Cells.size())
+                Compact();
+
+            return;
+        }
+
+        // same cells, only the bounds change
+        for (int32_t y = cells.y; y <= cells.w; ++y)
+        {
+            for (int32_t x = cells.x; x <= cells.z; ++x)
+            {
+                Cell& cell = m_Cells[m_SlotCells[FindSlot(PackCell(x, y))]];
+
+                for (CellEntry& entry : cell.Entries)
+                {
+                    if (entry.Proxy != proxy)
+                        continue;
+
+                    entry.Bounds[0] = min.x;
+                    entry.Bounds[1] = min.y;
+                    entry.Bounds[2] = -max.x;
+                    entry.Bounds[3] = -max.y;
+                    break;
+                }
+            }
+        }
+    }
+
+    void SpatialHash::Remove(SpatialProxy proxy)
+    {
+        RemoveFromCells(proxy);
+
+        Proxy& data = m_Proxies[proxy];
+        data.Cells = {0, 0, -1, -1};
+        data.NextFree = m_FirstFree;
+        m_FirstFree = proxy;
+
+        if (m_EmptyCells > MIN_EMPTY_CELLS && m_EmptyCells * 2 > m_Cells.size())
+            Compact();
+    }
+
+    void SpatialHash::Clear()
+    {
+        m_Proxies.clear();
+        m_Cells.clear();
+        m_EmptyCells = 0;
+        m_SlotKeys.clear();
+        m_SlotCells.clear();
+        m_SlotShift = 64;
+        m_FirstFree = INVALID_SPATIAL_PROXY;
+    }
+
+    void SpatialHash::AddToCells(SpatialProxy proxy, const CellEntry& entry)
+    {
+        const glm::ivec4 cells = m_Proxies[proxy].Cells;
+
+        for (int32_t y = cells.y; y <= cells.w; ++y)
+        {
+            for (int32_t x = cells.x; x <= cells.z; ++x)
+            {
+                Cell& cell = GetOrAddCell(x, y);
+
+                if (cell.Entries.empty())
+                    --m_EmptyCells;
+
+                cell.Entries.push_back(entry);
+            }
+        }
+    }
+
+    void SpatialHash::RemoveFromCells(SpatialProxy proxy)
+    {
+        const glm::ivec4 cells = m_Proxies[proxy].Cells;
+
+        for (int32_t y = cells.y; y <= cells.w; ++y)
+        {
+            for (int32_t x = cells.x; x <= cells.z; ++x)
+            {
+                std::vector<CellEntry>& entries = m_Cells[m_SlotCells[FindSlot(PackCell(x, y))]].Entries;
+
+                auto entry = std::find_if(entries.begin(), entries.end(),
+                                          [proxy](const CellEntry& entry) { return entry.Proxy == proxy; });
+
+                *entry = entries.back();
+                entries.pop_back();
+
+                if (entries.empty())
+                    ++m_EmptyCells;
+            }
+        }
+    }
+
+    template<typename Fn>
+    void SpatialHash::ForEachInRange(const glm::ivec4& range, const Fn& fn) const
+    {
+        // a box in several cells of the range is only visited from the first of them
+        const auto visitCell = [&range, &fn](const Cell& cell) {
+            for (const CellEntry& entry : cell.Entries)
+            {
+                if (cell.X == std::max(entry.FirstCellX, range.x) && cell.Y == std::max(entry.FirstCellY, range.y))
+                    fn(entry);
+            }
+        };
+
+        const int64_t rangeCells = ((int64_t) range.z - range.x + 1) * ((int64_t) range.w - range.y + 1);
+
+        // big ranges over few cells go through the cells instead of looking up every coordinate
+        if (rangeCells > (int64_t) m_Cells.size())
+        {
+            for (const Cell& cell : m_Cells)
+            {
+                if (cell.X >= range.x && cell.X <= range.z && cell.Y >= range.y && cell.Y <= range.w)
+                    visitCell(cell);
+            }
+
+            return;
+        }
+
+        for (int32_t y = range.y; y <= range.w; ++y)
+        {
+            for (int32_t x = range.x; x <= range.z; ++x)
+            {
+                if (const Cell* cell = FindCell(x, y))
+                    visitCell(*cell);
+            }
+        }
+    }
+
+    void SpatialHash::QueryAABB(const glm::vec2& min, const glm::vec2& max, std::vector<uint32_t>& result) const
+    {
+        alignas(16) const float bounds[4] = {min.x, min.y, -max.x, -max.y};
+        const BoundsVector query = ToQuery(bounds);
+
+        ForEachInRange(GetCellRange(min, max), [&query, &result](const CellEntry& entry) {
+            if (Overlaps(entry.Bounds, query))
+                result.push_back(entry.UserData);
+        });
+    }
+
+    void SpatialHash::QueryCircle(const glm::vec2& center, float radius, std::vector<uint32_t>& result) const
+    {
+        const glm::vec2 min = center - radius;
+        const glm::vec2 max = center + radius;
+
+        alignas(16) const float bounds[4] = {min.x, min.y, -max.x, -max.y};
+        const BoundsVector query = ToQuery(bounds);
+        const float radiusSquared = radius * radius;
+
+        ForEachInRange(GetCellRange(min, max), [&](const CellEntry& entry) {
+            if (!Overlaps(entry.Bounds, query))
+                return;
+
+            // distance from the center to the closest point of the box
+            const float dx = std::max({entry.Bounds[0] - center.x, 0.0f, center.x + entry.Bounds[2]});
+            const float dy = std::max({entry.Bounds[1] - center.y, 0.0f, center.y + entry.Bounds[3]});
+
+            if (dx * dx + dy * dy <= radiusSquared)
+                result.push_back(entry.UserData);
+        });
+    }
+
+    // distance along the ray to the box, negative when it misses
+    static float IntersectRay(const float* bounds, const glm::vec2& origin, const glm::vec2& direction,
+                              const glm::vec2& invDirection)
+    {
+        float entry = 0.0f;
+        float exit = std::numeric_limits<float>::infinity();
+
+        for (int axis = 0; axis < 2; ++axis)
+        {
+            const float min = bounds[axis];
+            const float max = -bounds[axis + 2];
+
+            if (direction[axis] == 0.0f)
+            {
+                if (origin[axis] < min || origin[axis] > max)
+                    return -1.0f;
+
+                continue;
+            }
+
+            const float t0 = (min - origin[axis]) * invDirection[axis];
+            const float t1 = (max - origin[axis]) * invDirection[axis];
+
+            entry = std::max(entry, std::min(t0, t1));
+            exit = std::min(exit, std::max(t0, t1));
+        }
+
+        return (entry <= exit) ? entry : -1.0f;
+    }
+
+    bool SpatialHash::Raycast(const glm::vec2& origin, const glm::vec2& direction, float maxDistance,
+                              SpatialRaycastHit& hit) const
+    {
+        const float length = glm::length(direction);
+
+        // maxDistance bounds the cells walked, so it has to be finite
+        if (!(length > 0.0f) || !(maxDistance >= 0.0f) || !std::isfinite(maxDistance))
+            return false;
+
+        const glm::vec2 dir = direction / length;
+        const glm::vec2 invDir = glm::vec2(1.0f) / dir;
+
+        // walks the cells along the ray in order, until the next one starts past the closest hit so far
+        const glm::ivec4 start = GetCellRange(origin, origin);
+        glm::ivec2 cell = {start.x, start.y};
+        const glm::ivec2 step = {(dir.x > 0.0f) ? 1 : -1, (dir.y > 0.0f) ? 1 : -1};
+
+        glm::vec2 next;
+        glm::vec2 delta;
+
+        for (int axis = 0; axis < 2; ++axis)
+        {
+            if (dir[axis] == 0.0f)
+            {
+                next[axis] = std::numeric_limits<float>::infinity();
+                delta[axis] = std::numeric_limits<float>::infinity();
+                continue;
+            }
+
+            const float boundary = (float) (cell[axis] + (step[axis] > 0 ? 1 : 0)) * m_CellSize;
+            next[axis] = (boundary - origin[axis]) * invDir[axis];
+            delta[axis] = m_CellSize * std::abs(invDir[axis]);
+        }
+
+        float closest = maxDistance;
+        bool found = false;
+
+        while (true)
+        {
+            if (const Cell* current = FindCell(cell.x, cell.y))
+            {
+                for (const CellEntry& entry : current->Entries)
+                {
+                    const float distance = IntersectRay(entry.Bounds, origin, dir, invDir);
+
+                    if (distance >= 0.0f && distance <= closest && (!found || distance < closest))
+                    {
+                        closest = distance;
+                        hit = {.UserData = entry.UserData, .Distance = distance};
+                        found = true;
+                    }
+                }
+            }
+
+            const int axis = (next.x < next.y) ? 0 : 1;
+
+            if (next[axis] > closest)
+                break;
+
+            cell[axis] += step[axis];
+            next[axis] += delta[axis];
+        }
+
+        return found;
+    }
+
+    void SpatialHash::FindPairs(std::vector<SpatialPair>& pairs) const
+    {
+        const uint32_t cellCount = (uint32_t) m_Cells.size();
+
+        // a list per range, joined in order so the result doesn't depend on the threads
+        std::vector<std::vector<SpatialPair>> rangePairs((cellCount + PAIR_GRAIN_SIZE - 1) / PAIR_GRAIN_SIZE);
+
+        JobSystem::ParallelFor(cellCount, PAIR_GRAIN_SIZE, [this, &rangePairs](uint32_t begin, uint32_t end) {
+            std::vector<SpatialPair>& result = rangePairs[begin / PAIR_GRAIN_SIZE];
+
+            for (uint32_t index = begin; index < end; ++index)
+            {
+                const Cell& cell = m_Cells[index];
+                const CellEntry* entries = cell.Entries.data();
+                const uint32_t count = (uint32_t) cell.Entries.size();
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const CellEntry& a = entries[i];
+                    const BoundsVector query = ToQuery(a.Bounds);
+
+                    for (uint32_t j = i + 1; j < count; ++j)
+                    {
+                        const CellEntry& b = entries[j];
+
+                        if (!Overlaps(b.Bounds, query))
+                            continue;
+
+                        // boxes sharing several cells are paired in the first of them
+                        if (cell.X == std::max(a.FirstCellX, b.FirstCellX) &&
+                            cell.Y == std::max(a.FirstCellY, b.FirstCellY))
+                            result.push_back({a.UserData, b.UserData});
+                    }
+                }
+            }
+        });
+
+        for (const std::vector<SpatialPair>& result : rangePairs)
+            pairs.insert(pairs.end(), result.begin(), result.end());
+    }
+} // namespace Nova
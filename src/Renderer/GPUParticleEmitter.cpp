@@ -0,0 +1,318 @@
+#include "Nova/Renderer/GPUParticleEmitter.hpp"
+#include "Nova/Renderer/GLError.hpp"
+
+#include "Nova/Misc/Logger.hpp"
+
+#include <glad/glad.h>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Nova
+{
+    struct GPUParticle
+    {
+        glm::vec2 Position;
+        glm::vec2 Velocity;
+        float Age;
+        float Lifetime;
+    };
+
+    static constexpr const char* s_UpdateShaderSource =
+        "#version 330 core\n"
+        "layout (location = 0) in vec2 aPosition;\n"
+        "layout (location = 1) in vec2 aVelocity;\n"
+        "layout (location = 2) in float aAge;\n"
+        "layout (location = 3) in float aLifetime;\n"
+        "out vec2 vPosition;\n"
+        "out vec2 vVelocity;\n"
+        "out float vAge;\n"
+        "out float vLifetime;\n"
+        "uniform float uDeltaTime;\n"
+        "uniform float uTime;\n"
+        "uniform int uEmitting;\n"
+        "uniform vec2 uEmitterPosition;\n"
+        "uniform vec2 uSpawnArea;\n"
+        "uniform vec2 uVelocityMin;\n"
+        "uniform vec2 uVelocityMax;\n"
+        "uniform vec2 uLifetime;\n"
+        "uniform vec2 uAcceleration;\n"
+        "uint Hash(uint x)\n"
+        "{\n"
+        "    x ^= x >> 16; x *= 0x7feb352du;\n"
+        "    x ^= x >> 15; x *= 0x846ca68bu;\n"
+        "    x ^= x >> 16;\n"
+        "    return x;\n"
+        "}\n"
+        "float Random(inout uint state)\n"
+        "{\n"
+        "    state = Hash(state);\n"
+        "    return float(state >> 8) * (1.0 / 16777216.0);\n"
+        "}\n"
+        "void main()\n"
+        "{\n"
+        "    vPosition = aPosition;\n"
+        "    vVelocity = aVelocity;\n"
+        "    vAge = aAge + uDeltaTime;\n"
+        "    vLifetime = aLifetime;\n"
+        "    if (vAge >= vLifetime)\n"
+        "    {\n"
+        "        if (uEmitting == 0) return;\n"
+        "        uint state = Hash(uint(gl_VertexID) ^ floatBitsToUint(uTime));\n"
+        "        vec2 spawn = vec2(Random(state), Random(state)) - 0.5;\n"
+        "        vPosition = uEmitterPosition + spawn * uSpawnArea;\n"
+        "        vVelocity = mix(uVelocityMin, uVelocityMax, vec2(Random(state), Random(state)));\n"
+        "        vLifetime = max(mix(uLifetime.x, uLifetime.y, Random(state)), 1e-4);\n"
+        "        vAge = 0.0;\n"
+        "    }\n"
+        "    else if (vAge >= 0.0)\n"
+        "    {\n"
+        "        vVelocity += uAcceleration * uDeltaTime;\n"
+        "        vPosition += vVelocity * uDeltaTime;\n"
+        "    }\n"
+        "}\n";
+
+    static constexpr const char* s_DrawVertexShaderSource =
+        "#version 330 core\n"
+        "layout (location = 0) in vec2 aCorner;\n"
+        "layout (location = 1) in vec2 aPosition;\n"
+        "layout (location = 2) in float aAge;\n"
+        "layout (location = 3) in float aLifetime;\n"
+        "out vec2 TexCoords;\n"
+        "out vec4 Color;\n"
+        "uniform mat4 uProjection;\n"
+        "uniform vec2 uSize;\n"
+        "uniform vec4 uStartColor;\n"
+        "uniform vec4 uEndColor;\n"
+        "void main()\n"
+        "{\n"
+        "    TexCoords = aCorner + 0.5;\n"
+        "    if (aAge < 0.0 || aAge >= aLifetime)\n"
+        "    {\n"
+        "        Color = vec4(0.0);\n"
+        "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+        "        return;\n"
+        "    }\n"
+        "    float t = aAge / aLifetime;\n"
+        "    Color = mix(uStartColor, uEndColor, t);\n"
+        "    gl_Position = uProjection * vec4(aPosition + aCorner * mix(uSize.x, uSize.y, t), 0.0, 1.0);\n"
+        "}\n";
+
+    static constexpr const char* s_DrawFragmentShaderSource =
+        "#version 330 core\n"
+        "in vec2 TexCoords;\n"
+        "in vec4 Color;\n"
+        "out vec4 FragColor;\n"
+        "uniform sampler2D uTexture;\n"
+        "uniform sampler2D uPalette;\n"
+        "uniform int uIndexed;\n"
+        "uniform int uPaletteRow;\n"
+        "uniform int uPremultiplied;\n"
+        "void main()\n"
+        "{\n"
+        "    vec4 texel = texture(uTexture, TexCoords);\n"
+        "    if (uIndexed != 0) texel = texelFetch(uPalette, ivec2(int(texel.r * 255.0 + 0.5), uPaletteRow), 0);\n"
+        "    if (uPremultiplied != 0 && texel.a > 0.0) texel.rgb /= texel.a;\n"
+        "    vec4 color = Color * texel;\n"
+        "    if (color.a == 0.0) discard;\n"
+        "    FragColor = color;\n"
+        "}\n";
+
+    // triangle strip, centered on the particle position
+    static constexpr float s_Corners[] = {-0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f};
+
+    static glm::vec4 ToVec4(const Color& color)
+    {
+        return glm::vec4(color.r, color.g, color.b, color.a) / 255.0f;
+    }
+
+    GPUParticleEmitter::~GPUParticleEmitter()
+    {
+        Shutdown();
+    }
+
+    bool GPUParticleEmitter::Init(const GPUParticleEmitterConfig& config)
+    {
+        Shutdown();
+
+        if (config.MaxParticles == 0)
+        {
+            Logger::Warning("Cannot create a GPU particle emitter without particles!");
+            return false;
+        }
+
+        if (!m_UpdateShader.InitTransformFeedback(s_UpdateShaderSource,
+                                                  {"vPosition", "vVelocity", "vAge", "vLifetime"}) ||
+            !m_DrawShader.Init(s_DrawVertexShaderSource, s_DrawFragmentShaderSource))
+        {
+            Logger::Warning("Failed to create the GPU particle emitter shaders!");
+            m_UpdateShader.Shutdown();
+            return false;
+        }
+
+        m_Config = config;
+        m_Current = 0;
+        m_Time = 0.0f;
+
+        // every particle starts dead with a staggered negative age, so births are spread over the first lifetime
+        // instead of all happening on the first frame
+        std::vector<GPUParticle> particles(m_Config.MaxParticles);
+        const float lifetime = std::max(m_Config.LifetimeMax, 1e-4f);
+
+        for (uint32_t i = 0; i < m_Config.MaxParticles; ++i)
+        {
+            float birth = lifetime * (float) i / (float) m_Config.MaxParticles;
+            particles[i] = {{0.0f, 0.0f}, {0.0f, 0.0f}, -birth, 0.0f};
+        }
+
+        glGenBuffers(2, m_Buffers.data());
+        glGenBuffers(1, &m_CornerBuffer);
+        glGenVertexArrays(2, m_UpdateVAs.data());
+        glGenVertexArrays(2, m_DrawVAs.data());
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_CornerBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(s_Corners), s_Corners, GL_STATIC_DRAW);
+
+        for (size_t i = 0; i < m_Buffers.size(); ++i)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, m_Buffers[i]);
+            glBufferData(GL_ARRAY_BUFFER, particles.size() * sizeof(GPUParticle), particles.data(), GL_DYNAMIC_COPY);
+
+            glBindVertexArray(m_UpdateVAs[i]);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(GPUParticle),
+                                  (const void*) offsetof(GPUParticle, Position));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GPUParticle),
+                                  (const void*) offsetof(GPUParticle, Velocity));
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (const void*) offsetof(GPUParticle, Age));
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(GPUParticle),
+                                  (const void*) offsetof(GPUParticle, Lifetime));
+
+            glBindVertexArray(m_DrawVAs[i]);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(GPUParticle),
+                                  (const void*) offsetof(GPUParticle, Position));
+            glVertexAttribDivisor(1, 1);
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(GPUParticle), (const void*) offsetof(GPUParticle, Age));
+            glVertexAttribDivisor(2, 1);
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(GPUParticle),
+                                  (const void*) offsetof(GPUParticle, Lifetime));
+            glVertexAttribDivisor(3, 1);
+
+            glBindBuffer(GL_ARRAY_BUFFER, m_CornerBuffer);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+        }
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_DrawShader.Bind();
+        m_DrawShader.SetUniformInt("uTexture", 0);
+        m_DrawShader.SetUniformInt("uPalette", 1);
+        m_DrawShader.SetUniformInt("uPaletteRow", (int32_t) m_Config.PaletteRow);
+        m_DrawShader.SetUniformFloat2("uSize", {m_Config.StartSize, m_Config.EndSize});
+        m_DrawShader.SetUniformFloat4("uStartColor", ToVec4(m_Config.StartColor));
+        m_DrawShader.SetUniformFloat4("uEndColor", ToVec4(m_Config.EndColor));
+        m_DrawShader.Unbind();
+
+        m_UpdateShader.Bind();
+        m_UpdateShader.SetUniformFloat2("uSpawnArea", m_Config.SpawnArea);
+        m_UpdateShader.SetUniformFloat2("uVelocityMin", m_Config.VelocityMin);
+        m_UpdateShader.SetUniformFloat2("uVelocityMax", m_Config.VelocityMax);
+        m_UpdateShader.SetUniformFloat2("uLifetime", {m_Config.LifetimeMin, m_Config.LifetimeMax});
+        m_UpdateShader.SetUniformFloat2("uAcceleration", m_Config.Acceleration);
+        m_UpdateShader.Unbind();
+
+        CheckOpenGLErrors();
+        return true;
+    }
+
+    void GPUParticleEmitter::Shutdown()
+    {
+        if (!IsInitialized())
+            return;
+
+        glDeleteVertexArrays(2, m_UpdateVAs.data());
+        glDeleteVertexArrays(2, m_DrawVAs.data());
+        glDeleteBuffers(2, m_Buffers.data());
+        glDeleteBuffers(1, &m_CornerBuffer);
+
+        m_UpdateVAs = {0, 0};
+        m_DrawVAs = {0, 0};
+        m_Buffers = {0, 0};
+        m_CornerBuffer = 0;
+
+        m_UpdateShader.Shutdown();
+        m_DrawShader.Shutdown();
+    }
+
+    void GPUParticleEmitter::Update(float deltaTime, const glm::vec2& position)
+    {
+        if (!IsInitialized())
+            return;
+
+        m_Time += deltaTime;
+
+        const uint32_t next = 1 - m_Current;
+
+        m_UpdateShader.Bind();
+        m_UpdateShader.SetUniformFloat("uDeltaTime", deltaTime);
+        m_UpdateShader.SetUniformFloat("uTime", m_Time);
+        m_UpdateShader.SetUniformInt("uEmitting", Emitting ? 1 : 0);
+        m_UpdateShader.SetUniformFloat2("uEmitterPosition", position);
+
+        // simulation only, nothing has to reach the rasterizer
+        glEnable(GL_RASTERIZER_DISCARD);
+
+        glBindVertexArray(m_UpdateVAs[m_Current]);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_Buffers[next]);
+
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, m_Config.MaxParticles);
+        glEndTransformFeedback();
+
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glBindVertexArray(0);
+
+        glDisable(GL_RASTERIZER_DISCARD);
+
+        m_UpdateShader.Unbind();
+
+        m_Current = next;
+
+        CheckOpenGLErrors();
+    }
+
+    void GPUParticleEmitter::Draw(const glm::mat4& projection, const Texture& fallbackTexture) const
+    {
+        if (!IsInitialized())
+            return;
+
+        const Texture& texture = m_Config.Texture ? *m_Config.Texture : fallbackTexture;
+        texture.Bind(0);
+
+        // indexed textures are resolved through their palette, like in the quad shader
+        if (texture.IsIndexed())
+            texture.GetPalette()->Bind(1);
+
+        m_DrawShader.Bind();
+        m_DrawShader.SetUniformInt("uIndexed", texture.IsIndexed() ? 1 : 0);
+        m_DrawShader.SetUniformMat4("uProjection", projection);
+        // straight alpha after filtering, like the quad shader, the blending expects it
+        m_DrawShader.SetUniformInt("uPremultiplied", texture.IsPremultiplied() ? 1 : 0);
+
+        glBindVertexArray(m_DrawVAs[m_Current]);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_Config.MaxParticles);
+        glBindVertexArray(0);
+
+        m_DrawShader.Unbind();
+    }
+} // namespace Nova
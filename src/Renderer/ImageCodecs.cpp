@@ -0,0 +1,373 @@
+#include "Nova/Renderer/ImageCodecs.hpp"
+#include "Nova/Core/JobSystem.hpp"
+
+#include <array>
+#include <cctype>
+#include <cstring>
+
+namespace Nova::ImageCodecs
+{
+    // same limit as the reference QOI implementation, also keeps width * height * 4 from overflowing
+    static constexpr uint64_t MAX_PIXELS = 400'000'000;
+
+    // below this, splitting the conversion costs more than it saves
+    static constexpr uint64_t PARALLEL_MIN_PIXELS = 256 * 256;
+    static constexpr uint32_t ROWS_PER_JOB = 64;
+
+    static constexpr size_t QOI_HEADER_SIZE = 14;
+    static constexpr size_t QOI_END_MARKER_SIZE = 8;
+    static constexpr std::array<uint8_t, 8> QOI_END_MARKER = {0, 0, 0, 0, 0, 0, 0, 1};
+
+    // clang-format off
+    enum QOIOp : uint8_t
+    {
+        QOIOp_Index = 0x00,
+        QOIOp_Diff  = 0x40,
+        QOIOp_Luma  = 0x80,
+        QOIOp_Run   = 0xC0,
+        QOIOp_RGB   = 0xFE,
+        QOIOp_RGBA  = 0xFF
+    };
+    // clang-format on
+
+    static constexpr uint8_t QOI_OP_MASK = 0xC0;
+
+    static constexpr size_t TGA_HEADER_SIZE = 18;
+
+    struct QOIPixel
+    {
+        uint8_t R = 0, G = 0, B = 0, A = 255;
+
+        bool operator==(const QOIPixel& other) const noexcept = default;
+    };
+
+    static uint32_t HashQOIPixel(const QOIPixel& px)
+    {
+        return (px.R * 3 + px.G * 5 + px.B * 7 + px.A * 11) % 64;
+    }
+
+    static uint32_t ReadBigEndian32(const uint8_t* bytes)
+    {
+        return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | bytes[3];
+    }
+
+    static bool IsValidSize(uint32_t width, uint32_t height)
+    {
+        return width > 0 && height > 0 && (uint64_t) width * height <= MAX_PIXELS;
+    }
+
+    static bool GetQOIInfo(std::span<const uint8_t> bytes, ImageInfo& info)
+    {
+        if (bytes.size() < QOI_HEADER_SIZE + QOI_END_MARKER_SIZE || std::memcmp(bytes.data(), "qoif", 4) != 0)
+            return false;
+
+        const uint32_t channels = bytes[12];
+
+        info.Format = ImageFormat::QOI;
+        info.Width = ReadBigEndian32(bytes.data() + 4);
+        info.Height = ReadBigEndian32(bytes.data() + 8);
+        info.Channels = 4;
+        info.SourceChannels = channels;
+        info.DataOffset = QOI_HEADER_SIZE;
+
+        return (channels == 3 || channels == 4) && IsValidSize(info.Width, info.Height);
+    }
+
+    static bool GetTGAInfo(std::span<const uint8_t> bytes, ImageInfo& info)
+    {
+        if (bytes.size() < TGA_HEADER_SIZE)
+            return false;
+
+        const uint8_t idLength = bytes[0];
+        const uint8_t colorMapType = bytes[1];
+        const uint8_t imageType = bytes[2];
+        const uint8_t bitsPerPixel = bytes[16];
+        const uint8_t descriptor = bytes[17];
+
+        // only uncompressed true color (2) and grayscale (3) images, stored left to right
+        if (colorMapType != 0 || (descriptor & 0x10))
+            return false;
+
+        if (!(imageType == 2 && (bitsPerPixel == 24 || bitsPerPixel == 32)) && !(imageType == 3 && bitsPerPixel == 8))
+            return false;
+
+        info.Format = ImageFormat::TGA;
+        info.Width = bytes[12] | (bytes[13] << 8);
+        info.Height = bytes[14] | (bytes[15] << 8);
+        info.SourceChannels = bitsPerPixel / 8;
+        info.Channels = (info.SourceChannels == 1) ? 1 : 4;
+        info.DataOffset = TGA_HEADER_SIZE + idLength;
+        info.BottomUp = !(descriptor & 0x20);
+        info.BGR = info.SourceChannels > 1;
+
+        return IsValidSize(info.Width, info.Height);
+    }
+
+    // next number of a PNM header, skipping whitespace and comments
+    static bool ReadPNMNumber(std::span<const uint8_t> bytes, size_t& offset, uint32_t& value)
+    {
+        while (offset < bytes.size())
+        {
+            if (bytes[offset] == '#')
+            {
+                while (offset < bytes.size() && bytes[offset] != '\n')
+                    ++offset;
+            }
+            else if (std::isspace(bytes[offset]))
+                ++offset;
+            else
+                break;
+        }
+
+        if (offset >= bytes.size() || !std::isdigit(bytes[offset]))
+            return false;
+
+        uint64_t number = 0;
+
+        while (offset < bytes.size() && std::isdigit(bytes[offset]) && number <= UINT32_MAX)
+            number = number * 10 + (bytes[offset++] - '0');
+
+        value = (uint32_t) number;
+        return number <= UINT32_MAX;
+    }
+
+    static bool GetPNMInfo(std::span<const uint8_t> bytes, ImageInfo& info)
+    {
+        if (bytes.size() < 3 || bytes[0] != 'P' || (bytes[1] != '5' && bytes[1] != '6'))
+            return false;
+
+        size_t offset = 2;
+        uint32_t maxValue = 0;
+
+        if (!ReadPNMNumber(bytes, offset, info.Width) || !ReadPNMNumber(bytes, offset, info.Height) ||
+            !ReadPNMNumber(bytes, offset, maxValue))
+            return false;
+
+        // 16-bit samples are left to stb_image
+        if (maxValue != 255 || offset >= bytes.size() || !std::isspace(bytes[offset]))
+            return false;
+
+        info.Format = ImageFormat::PNM;
+        info.SourceChannels = (bytes[1] == '5') ? 1 : 3;
+        info.Channels = (info.SourceChannels == 1) ? 1 : 4;
+        info.DataOffset = offset + 1;
+
+        return IsValidSize(info.Width, info.Height);
+    }
+
+    bool GetInfo(std::span<const uint8_t> bytes, ImageInfo& info)
+    {
+        info = {};
+
+        // TGA has no magic, so it's tried last
+        return GetQOIInfo(bytes, info) || GetPNMInfo(bytes, info) || GetTGAInfo(bytes, info);
+    }
+
+    static bool DecodeQOI(std::span<const uint8_t> bytes, const ImageInfo& info, uint8_t* pixels, size_t pitch)
+    {
+        const size_t end = bytes.size() - QOI_END_MARKER_SIZE;
+        size_t offset = info.DataOffset;
+
+        std::array<QOIPixel, 64> index = {};
+        QOIPixel px;
+        uint32_t run = 0;
+
+        for (uint32_t y = 0; y < info.Height; ++y)
+        {
+            uint8_t* row = pixels + y * pitch;
+
+            for (uint32_t x = 0; x < info.Width; ++x)
+            {
+                if (run > 0)
+                    --run;
+                else
+                {
+                    if (offset >= end)
+                        return false;
+
+                    const uint8_t op = bytes[offset++];
+
+                    if (op == QOIOp_RGB || op == QOIOp_RGBA)
+                    {
+                        const size_t size = (op == QOIOp_RGB) ? 3 : 4;
+
+                        if (end - offset < size)
+                            return false;
+
+                        px.R = bytes[offset];
+                        px.G = bytes[offset + 1];
+                        px.B = bytes[offset + 2];
+
+                        if (op == QOIOp_RGBA)
+                            px.A = bytes[offset + 3];
+
+                        offset += size;
+                    }
+                    else if ((op & QOI_OP_MASK) == QOIOp_Index)
+                        px = index[op];
+                    else if ((op & QOI_OP_MASK) == QOIOp_Diff)
+                    {
+                        px.R += ((op >> 4) & 0x03) - 2;
+                        px.G += ((op >> 2) & 0x03) - 2;
+                        px.B += (op & 0x03) - 2;
+                    }
+                    else if ((op & QOI_OP_MASK) == QOIOp_Luma)
+                    {
+                        if (offset >= end)
+                            return false;
+
+                        const uint8_t next = bytes[offset++];
+                        const int greenDiff = (op & 0x3F) - 32;
+
+                        px.R += greenDiff - 8 + ((next >> 4) & 0x0F);
+                        px.G += greenDiff;
+                        px.B += greenDiff - 8 + (next & 0x0F);
+                    }
+                    else
+                        run = op & 0x3F;
+
+                    index[HashQOIPixel(px)] = px;
+                }
+
+                std::memcpy(row + x * 4, &px, 4);
+            }
+        }
+
+        return true;
+    }
+
+    static void ConvertRow(const uint8_t* src, uint32_t srcChannels, uint8_t* dst, uint32_t dstChannels,
+                           uint32_t width, bool swapRB)
+    {
+        if (srcChannels == dstChannels && !swapRB)
+        {
+            std::memcpy(dst, src, (size_t) width * srcChannels);
+            return;
+        }
+
+        // the only conversions left end up in RGBA
+        const uint32_t red = swapRB ? 2 : 0;
+        const uint32_t blue = swapRB ? 0 : 2;
+
+        for (uint32_t x = 0; x < width; ++x, src += srcChannels, dst += 4)
+        {
+            dst[0] = src[red];
+            dst[1] = src[1];
+            dst[2] = src[blue];
+            dst[3] = (srcChannels == 4) ? src[3] : 255;
+        }
+    }
+
+    void ConvertRows(const uint8_t* src, size_t srcPitch, uint32_t srcChannels, uint8_t* dst, size_t dstPitch,
+                     uint32_t dstChannels, uint32_t width, uint32_t height, bool swapRB, bool flip)
+    {
+        auto convert = [&](uint32_t begin, uint32_t end) {
+            for (uint32_t y = begin; y < end; ++y)
+            {
+                const uint8_t* row = src + (size_t) (flip ? height - 1 - y : y) * srcPitch;
+                ConvertRow(row, srcChannels, dst + y * dstPitch, dstChannels, width, swapRB);
+            }
+        };
+
+        if ((uint64_t) width * height < PARALLEL_MIN_PIXELS)
+            convert(0, height);
+        else
+            JobSystem::ParallelFor(height, ROWS_PER_JOB, convert);
+    }
+
+    bool Decode(std::span<const uint8_t> bytes, const ImageInfo& info, uint8_t* pixels, size_t pitch)
+    {
+        if (info.Format == ImageFormat::QOI)
+            return DecodeQOI(bytes, info, pixels, pitch);
+
+        // the other formats are raw pixels after the header, so every row can be converted on its own
+        const size_t srcPitch = (size_t) info.Width * info.SourceChannels;
+
+        if (info.DataOffset > bytes.size() || (bytes.size() - info.DataOffset) / srcPitch < info.Height)
+            return false;
+
+        ConvertRows(bytes.data() + info.DataOffset, srcPitch, info.SourceChannels, pixels, pitch, info.Channels,
+                    info.Width, info.Height, info.BGR, info.BottomUp);
+
+        return true;
+    }
+
+    std::vector<uint8_t> EncodeQOI(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels)
+    {
+        std::vector<uint8_t> bytes;
+        bytes.reserve(QOI_HEADER_SIZE + (size_t) width * height * (channels + 1) + QOI_END_MARKER_SIZE);
+
+        auto write32 = [&bytes](uint32_t value) {
+            for (int shift = 24; shift >= 0; shift -= 8)
+                bytes.push_back((uint8_t) (value >> shift));
+        };
+
+        bytes.insert(std::end(bytes), {'q', 'o', 'i', 'f'});
+        write32(width);
+        write32(height);
+        bytes.push_back((uint8_t) channels);
+        bytes.push_back(0); // sRGB with linear alpha
+
+        std::array<QOIPixel, 64> index = {};
+        QOIPixel previous;
+        uint32_t run = 0;
+
+        const uint64_t pixelCount = (uint64_t) width * height;
+
+        for (uint64_t i = 0; i < pixelCount; ++i)
+        {
+            const uint8_t* src = pixels + i * channels;
+            const QOIPixel px = {src[0], src[1], src[2], (channels == 4) ? src[3] : (uint8_t) 255};
+
+            if (px == previous)
+            {
+                if (++run == 62 || i == pixelCount - 1)
+                {
+                    bytes.push_back(QOIOp_Run | (run - 1));
+                    run = 0;
+                }
+
+                continue;
+            }
+
+            if (run > 0)
+            {
+                bytes.push_back(QOIOp_Run | (run - 1));
+                run = 0;
+            }
+
+            const uint32_t hash = HashQOIPixel(px);
+
+            if (index[hash] == px)
+                bytes.push_back(QOIOp_Index | hash);
+            else
+            {
+                index[hash] = px;
+
+                const int8_t dr = (int8_t) (px.R - previous.R);
+                const int8_t dg = (int8_t) (px.G - previous.G);
+                const int8_t db = (int8_t) (px.B - previous.B);
+                const int8_t drg = (int8_t) (dr - dg);
+                const int8_t dbg = (int8_t) (db - dg);
+
+                if (px.A != previous.A)
+                    bytes.insert(std::end(bytes), {QOIOp_RGBA, px.R, px.G, px.B, px.A});
+                else if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+                    bytes.push_back(QOIOp_Diff | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+                else if (drg >= -8 && drg <= 7 && dg >= -32 && dg <= 31 && dbg >= -8 && dbg <= 7)
+                {
+                    bytes.push_back(QOIOp_Luma | (dg + 32));
+                    bytes.push_back(((drg + 8) << 4) | (dbg + 8));
+                }
+                else
+                    bytes.insert(std::end(bytes), {QOIOp_RGB, px.R, px.G, px.B});
+            }
+
+            previous = px;
+        }
+
+        bytes.insert(std::end(bytes), std::begin(QOI_END_MARKER), std::end(QOI_END_MARKER));
+
+        return bytes;
+    }
+} // namespace Nova::ImageCodecs
@@ -0,0 +1,153 @@
+#include "Nova/Renderer/ParticleEmitter.hpp"
+#include "Nova/Core/JobSystem.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOVA_PARTICLES_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Nova
+{
+    static constexpr uint32_t PARTICLE_GRAIN_SIZE = 16384;
+
+    struct ParticleArrays
+    {
+        float* PosX;
+        float* PosY;
+        float* VelX;
+        float* VelY;
+        float* Age;
+    };
+
+    // semi-implicit euler over [begin, end)
+    static void IntegrateParticles(const ParticleArrays& p, uint32_t begin, uint32_t end, const glm::vec2& acceleration,
+                                   float deltaTime)
+    {
+        const float accX = acceleration.x * deltaTime;
+        const float accY = acceleration.y * deltaTime;
+
+        uint32_t i = begin;
+
+#ifdef NOVA_PARTICLES_SSE
+        const __m128 dt = _mm_set1_ps(deltaTime);
+        const __m128 ax = _mm_set1_ps(accX);
+        const __m128 ay = _mm_set1_ps(accY);
+
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128 vx = _mm_add_ps(_mm_loadu_ps(p.VelX + i), ax);
+            __m128 vy = _mm_add_ps(_mm_loadu_ps(p.VelY + i), ay);
+
+            _mm_storeu_ps(p.VelX + i, vx);
+            _mm_storeu_ps(p.VelY + i, vy);
+            _mm_storeu_ps(p.PosX + i, _mm_add_ps(_mm_loadu_ps(p.PosX + i), _mm_mul_ps(vx, dt)));
+            _mm_storeu_ps(p.PosY + i, _mm_add_ps(_mm_loadu_ps(p.PosY + i), _mm_mul_ps(vy, dt)));
+            _mm_storeu_ps(p.Age + i, _mm_add_ps(_mm_loadu_ps(p.Age + i), dt));
+        }
+#endif
+
+        for (; i < end; ++i)
+        {
+            p.VelX[i] += accX;
+            p.VelY[i] += accY;
+            p.PosX[i] += p.VelX[i] * deltaTime;
+            p.PosY[i] += p.VelY[i] * deltaTime;
+            p.Age[i] += deltaTime;
+        }
+    }
+
+    ParticleEmitter::ParticleEmitter(const ParticleEmitterConfig& config) : m_Config(config)
+    {
+        m_PosX.resize(m_Config.MaxParticles);
+        m_PosY.resize(m_Config.MaxParticles);
+        m_VelX.resize(m_Config.MaxParticles);
+        m_VelY.resize(m_Config.MaxParticles);
+        m_Age.resize(m_Config.MaxParticles);
+        m_InvLifetime.resize(m_Config.MaxParticles);
+    }
+
+    void ParticleEmitter::Update(float deltaTime, const glm::vec2& position)
+    {
+        if (m_Count > 0)
+        {
+            ParticleArrays arrays = {m_PosX.data(), m_PosY.data(), m_VelX.data(), m_VelY.data(), m_Age.data()};
+
+            JobSystem::ParallelFor(m_Count, PARTICLE_GRAIN_SIZE, [&](uint32_t begin, uint32_t end) {
+                IntegrateParticles(arrays, begin, end, m_Config.Acceleration, deltaTime);
+            });
+
+            KillDeadParticles();
+        }
+
+        if (!Emitting)
+            return;
+
+        m_EmissionAccumulator += m_Config.EmissionRate * deltaTime;
+
+        uint32_t toEmit = (uint32_t) m_EmissionAccumulator;
+        m_EmissionAccumulator -= (float) toEmit;
+
+        Emit(toEmit, position);
+    }
+
+    void ParticleEmitter::Emit(uint32_t count, const glm::vec2& position)
+    {
+        count = std::min(count, (uint32_t) m_PosX.size() - m_Count);
+
+        const glm::vec2 halfArea = m_Config.SpawnArea * 0.5f;
+
+        for (uint32_t i = m_Count; i < m_Count + count; ++i)
+        {
+            m_PosX[i] = position.x + RandomFloat(-halfArea.x, halfArea.x);
+            m_PosY[i] = position.y + RandomFloat(-halfArea.y, halfArea.y);
+            m_VelX[i] = RandomFloat(m_Config.VelocityMin.x, m_Config.VelocityMax.x);
+            m_VelY[i] = RandomFloat(m_Config.VelocityMin.y, m_Config.VelocityMax.y);
+            m_Age[i] = 0.0f;
+            m_InvLifetime[i] = 1.0f / std::max(RandomFloat(m_Config.LifetimeMin, m_Config.LifetimeMax), 1e-4f);
+        }
+
+        m_Count += count;
+    }
+
+    void ParticleEmitter::Clear() noexcept
+    {
+        m_Count = 0;
+        m_EmissionAccumulator = 0.0f;
+    }
+
+    float ParticleEmitter::RandomFloat(float min, float max) noexcept
+    {
+        // xorshift32
+        m_RandomState ^= m_RandomState << 13;
+        m_RandomState ^= m_RandomState >> 17;
+        m_RandomState ^= m_RandomState << 5;
+
+        return min + (max - min) * ((float) (m_RandomState >> 8) * (1.0f / 16777216.0f));
+    }
+
+    void ParticleEmitter::KillDeadParticles() noexcept
+    {
+        // swap-remove keeps the arrays dense, particle order doesn't matter
+        uint32_t i = 0;
+
+        while (i < m_Count)
+        {
+            if (m_Age[i] * m_InvLifetime[i] < 1.0f)
+            {
+                ++i;
+                continue;
+            }
+
+            uint32_t last = --m_Count;
+
+            m_PosX[i] = m_PosX[last];
+            m_PosY[i] = m_PosY[last];
+            m_VelX[i] = m_VelX[last];
+            m_VelY[i] = m_VelY[last];
+            m_Age[i] = m_Age[last];
+            m_InvLifetime[i] = m_InvLifetime[last];
+        }
+    }
+} // namespace Nova
@@ -0,0 +1,512 @@
+#include "Nova/Renderer/RenderCapture.hpp"
+#include "Nova/Renderer/Renderer.hpp"
+#include "Nova/Misc/Logger.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace Nova
+{
+    static constexpr std::array<char, 4> CAPTURE_MAGIC = {'N', 'V', 'R', 'C'};
+    static constexpr uint32_t CAPTURE_VERSION = 1;
+    static constexpr uint16_t CAPTURE_DEFAULT_TEXTURE = 0xFFFF;
+
+    enum class CaptureOp : uint8_t
+    {
+        EndFrame = 0,
+        Clear,
+        Projection,
+        DefineTexture,
+        Quad,
+        Shape
+    };
+
+    // clang-format off
+    enum CaptureQuadFlags_ : uint8_t
+    {
+        CaptureQuadFlags_None           = 0,
+        CaptureQuadFlags_Rotated        = 1 << 0,
+        CaptureQuadFlags_HasOrigin      = 1 << 1,
+        CaptureQuadFlags_FullSource     = 1 << 2
+    };
+    // clang-format on
+
+    struct CaptureTexture
+    {
+        uint16_t Index;
+        int Width;
+        int Height;
+    };
+
+    struct CaptureData
+    {
+        bool Armed = false;
+        bool Active = false;
+        uint32_t FramesLeft = 0;
+        uint32_t FramesWritten = 0;
+        std::ofstream File;
+        std::vector<uint8_t> Buffer;
+        std::unordered_map<uint32_t, CaptureTexture> Textures;
+    };
+
+    static CaptureData s_Capture;
+
+    template<typename T>
+    static void Write(const T& value)
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        s_Capture.Buffer.insert(std::end(s_Capture.Buffer), bytes, bytes + sizeof(T));
+    }
+
+    static void FlushCapture()
+    {
+        s_Capture.File.write(reinterpret_cast<const char*>(s_Capture.Buffer.data()), s_Capture.Buffer.size());
+        s_Capture.Buffer.clear();
+    }
+
+    static uint16_t GetCaptureTextureIndex(const Texture* texture)
+    {
+        if (!texture)
+            return CAPTURE_DEFAULT_TEXTURE;
+
+        uint32_t id = (uint32_t) texture->GetID();
+        auto it = s_Capture.Textures.find(id);
+
+        // GL names are recycled once a texture is deleted, so a size change means it's a new texture
+        if (it != std::end(s_Capture.Textures) && it->second.Width == texture->GetWidth() &&
+            it->second.Height == texture->GetHeight())
+            return it->second.Index;
+
+        uint16_t index = 0;
+
+        if (it != std::end(s_Capture.Textures))
+            index = it->second.Index;
+        else
+        {
+            if (s_Capture.Textures.size() >= CAPTURE_DEFAULT_TEXTURE)
+            {
+                Logger::Warning("Too many textures in render capture, drawing with the default texture instead");
+                return CAPTURE_DEFAULT_TEXTURE;
+            }
+
+            index = (uint16_t) s_Capture.Textures.size();
+        }
+
+        s_Capture.Textures[id] = {index, texture->GetWidth(), texture->GetHeight()};
+
+        Write(CaptureOp::DefineTexture);
+        Write(index);
+        Write((int32_t) texture->GetWidth());
+        Write((int32_t) texture->GetHeight());
+        Write(texture->GetFilter());
+
+        return index;
+    }
+
+    bool RenderCapture::Begin(const std::filesystem::path& path, uint32_t frameCount)
+    {
+        if (IsCapturing())
+        {
+            Logger::Warning("A render capture is already in progress!");
+            return false;
+        }
+
+        if (frameCount == 0)
+        {
+            Logger::Warning("Render capture needs at least one frame!");
+            return false;
+        }
+
+        s_Capture.File.open(path, std::ios::binary | std::ios::trunc);
+
+        if (!s_Capture.File.is_open())
+        {
+            Logger::Warning("Failed to open render capture file {}!", path.string());
+            return false;
+        }
+
+        glm::ivec2 viewport = Renderer::GetViewportSize();
+
+        s_Capture.Buffer.clear();
+        s_Capture.Textures.clear();
+
+        Write(CAPTURE_MAGIC);
+        Write(CAPTURE_VERSION);
+        Write((int32_t) viewport.x);
+        Write((int32_t) viewport.y);
+
+        s_Capture.Armed = true;
+        s_Capture.FramesLeft = frameCount;
+        s_Capture.FramesWritten = 0;
+
+        Logger::Info("Capturing {} frames to {}...", frameCount, path.string());
+        return true;
+    }
+
+    void RenderCapture::End()
+    {
+        if (!IsCapturing())
+            return;
+
+        FlushCapture();
+        s_Capture.File.close();
+
+        s_Capture.Armed = false;
+        s_Capture.Active = false;
+        s_Capture.Textures.clear();
+
+        Logger::Info("Render capture finished, {} frames written", s_Capture.FramesWritten);
+    }
+
+    bool RenderCapture::IsCapturing()
+    {
+        return s_Capture.Armed || s_Capture.Active;
+    }
+
+    void RenderCapture::RecordBeginFrame()
+    {
+        if (!s_Capture.Armed)
+            return;
+
+        s_Capture.Armed = false;
+        s_Capture.Active = true;
+    }
+
+    void RenderCapture::RecordEndFrame()
+    {
+        if (!s_Capture.Active)
+            return;
+
+        Write(CaptureOp::EndFrame);
+        FlushCapture();
+
+        ++s_Capture.FramesWritten;
+
+        if (--s_Capture.FramesLeft == 0)
+            End();
+    }
+
+    void RenderCapture::RecordClear(const Color& color)
+    {
+        if (!s_Capture.Active)
+            return;
+
+        Write(CaptureOp::Clear);
+        Write(color);
+    }
+
+    void RenderCapture::RecordProjection(int width, int height)
+    {
+        if (!s_Capture.Active)
+            return;
+
+        Write(CaptureOp::Projection);
+        Write((int32_t) width);
+        Write((int32_t) height);
+    }
+
+    void RenderCapture::RecordQuad(const Texture* texture, const glm::vec2& position, const glm::vec2& scale,
+                                   const Color& color, float rotation, const glm::vec2& origin,
+                                   const glm::vec4& sourceRect)
+    {
+        if (!s_Capture.Active)
+            return;
+
+        uint16_t textureIndex = GetCaptureTextureIndex(texture);
+
+        int width = texture ? texture->GetWidth() : 1;
+        int height = texture ? texture->GetHeight() : 1;
+
+        uint8_t flags = CaptureQuadFlags_None;
+
+        if (rotation != 0.0f)
+            flags |= CaptureQuadFlags_Rotated;
+
+        if (origin.x != 0.0f || origin.y != 0.0f)
+            flags |= CaptureQuadFlags_HasOrigin;
+
+        if (sourceRect == glm::vec4{0.0f, 0.0f, (float) width, (float) height})
+            flags |= CaptureQuadFlags_FullSource;
+
+        Write(CaptureOp::Quad);
+        Write(flags);
+        Write(textureIndex);
+        Write(position);
+        Write(scale);
+        Write(color);
+
+        if (flags & CaptureQuadFlags_Rotated)
+            Write(rotation);
+
+        if (flags & CaptureQuadFlags_HasOrigin)
+            Write(origin);
+
+        if (!(flags & CaptureQuadFlags_FullSource))
+            Write(sourceRect);
+    }
+
+    void RenderCapture::RecordShape(const glm::vec2& position, const glm::vec2& size, float cornerRadius,
+                                    const Color& color, float rotation, float outlineThickness)
+    {
+        if (!s_Capture.Active)
+            return;
+
+        Write(CaptureOp::Shape);
+        Write(position);
+        Write(size);
+        Write(cornerRadius);
+        Write(color);
+        Write(rotation);
+        Write(outlineThickness);
+    }
+
+    class CaptureReader
+    {
+    public:
+        CaptureReader(const std::vector<uint8_t>& stream, size_t offset) : m_Stream(stream), m_Offset(offset) {}
+
+        template<typename T>
+        bool Read(T& value)
+        {
+            if (m_Offset + sizeof(T) > m_Stream.size())
+                return false;
+
+            std::memcpy(&value, m_Stream.data() + m_Offset, sizeof(T));
+            m_Offset += sizeof(T);
+            return true;
+        }
+
+        bool IsAtEnd() const noexcept
+        {
+            return m_Offset >= m_Stream.size();
+        }
+
+        size_t GetOffset() const noexcept
+        {
+            return m_Offset;
+        }
+
+    private:
+        const std::vector<uint8_t>& m_Stream;
+        size_t m_Offset;
+    };
+
+    struct CaptureQuad
+    {
+        uint16_t TextureIndex = CAPTURE_DEFAULT_TEXTURE;
+        uint8_t Flags = CaptureQuadFlags_None;
+        glm::vec2 Position = {0.0f, 0.0f};
+        glm::vec2 Scale = {1.0f, 1.0f};
+        Nova::Color Color = Nova::White;
+        float Rotation = 0.0f;
+        glm::vec2 Origin = {0.0f, 0.0f};
+        glm::vec4 SourceRect = {0.0f, 0.0f, 1.0f, 1.0f};
+    };
+
+    static bool ReadQuad(CaptureReader& reader, CaptureQuad& quad)
+    {
+        bool ok = reader.Read(quad.Flags) && reader.Read(quad.TextureIndex) && reader.Read(quad.Position) &&
+                  reader.Read(quad.Scale) && reader.Read(quad.Color);
+
+        if (ok && (quad.Flags & CaptureQuadFlags_Rotated))
+            ok = reader.Read(quad.Rotation);
+
+        if (ok && (quad.Flags & CaptureQuadFlags_HasOrigin))
+            ok = reader.Read(quad.Origin);
+
+        if (ok && !(quad.Flags & CaptureQuadFlags_FullSource))
+            ok = reader.Read(quad.SourceRect);
+
+        return ok;
+    }
+
+    struct CaptureShape
+    {
+        glm::vec2 Position = {0.0f, 0.0f};
+        glm::vec2 Size = {0.0f, 0.0f};
+        float CornerRadius = 0.0f;
+        Nova::Color Color = Nova::White;
+        float Rotation = 0.0f;
+        float OutlineThickness = 0.0f;
+    };
+
+    static bool ReadShape(CaptureReader& reader, CaptureShape& shape)
+    {
+        return reader.Read(shape.Position) && reader.Read(shape.Size) && reader.Read(shape.CornerRadius) &&
+               reader.Read(shape.Color) && reader.Read(shape.Rotation) && reader.Read(shape.OutlineThickness);
+    }
+
+    bool RenderReplay::Load(const std::filesystem::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+
+        if (!in.is_open())
+        {
+            Logger::Warning("Failed to open render capture {}!", path.string());
+            return false;
+        }
+
+        m_Stream.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        m_FrameOffsets.clear();
+        m_Textures.clear();
+
+        CaptureReader reader(m_Stream, 0);
+
+        std::array<char, 4> magic;
+        uint32_t version = 0;
+        int32_t width = 0, height = 0;
+
+        if (!reader.Read(magic) || magic != CAPTURE_MAGIC || !reader.Read(version) || version != CAPTURE_VERSION)
+        {
+            Logger::Warning("{} is not a valid render capture!", path.string());
+            return false;
+        }
+
+        if (!reader.Read(width) || !reader.Read(height))
+        {
+            Logger::Warning("Render capture {} is truncated!", path.string());
+            return false;
+        }
+
+        m_Width = width;
+        m_Height = height;
+
+        // validate the whole stream up front and create the textures, so playback never does any loading
+        size_t frameStart = reader.GetOffset();
+
+        while (!reader.IsAtEnd())
+        {
+            CaptureOp op;
+            bool ok = reader.Read(op);
+
+            switch (op)
+            {
+            case CaptureOp::EndFrame:
+                m_FrameOffsets.push_back(frameStart);
+                frameStart = reader.GetOffset();
+                break;
+            case CaptureOp::Clear: {
+                Color color;
+                ok = ok && reader.Read(color);
+                break;
+            }
+            case CaptureOp::Projection: {
+                int32_t w, h;
+                ok = ok && reader.Read(w) && reader.Read(h);
+                break;
+            }
+            case CaptureOp::DefineTexture: {
+                uint16_t index;
+                int32_t w, h;
+                TextureFilter filter;
+                ok = ok && reader.Read(index) && reader.Read(w) && reader.Read(h) && reader.Read(filter);
+
+                if (!ok || w <= 0 || h <= 0)
+                {
+                    ok = false;
+                    break;
+                }
+
+                if (index >= m_Textures.size())
+                    m_Textures.resize(index + 1);
+
+                std::vector<Color> pixels((size_t) w * h, Nova::White);
+
+                m_Textures[index] = std::make_shared<Texture>();
+                m_Textures[index]->Init(w, h, pixels.data());
+                m_Textures[index]->SetFilter(filter);
+                break;
+            }
+            case CaptureOp::Quad: {
+                CaptureQuad quad;
+                ok = ok && ReadQuad(reader, quad);
+                break;
+            }
+            case CaptureOp::Shape: {
+                CaptureShape shape;
+                ok = ok && ReadShape(reader, shape);
+                break;
+            }
+            default:
+                ok = false;
+            }
+
+            if (!ok)
+            {
+                Logger::Warning("Render capture {} is corrupted, keeping the first {} frames", path.string(),
+                                m_FrameOffsets.size());
+                break;
+            }
+        }
+
+        Logger::Info("Loaded render capture {} ({} frames, {} textures)", path.string(), m_FrameOffsets.size(),
+                     m_Textures.size());
+
+        return !m_FrameOffsets.empty();
+    }
+
+    void RenderReplay::PlayFrame(uint32_t index) const
+    {
+        if (index >= m_FrameOffsets.size())
+            return;
+
+        CaptureReader reader(m_Stream, m_FrameOffsets[index]);
+        CaptureOp op;
+
+        while (reader.Read(op) && op != CaptureOp::EndFrame)
+        {
+            switch (op)
+            {
+            case CaptureOp::Clear: {
+                Color color;
+                reader.Read(color);
+                Renderer::ClearScreen(color);
+                break;
+            }
+            case CaptureOp::Projection: {
+                int32_t w, h;
+                reader.Read(w);
+                reader.Read(h);
+                Renderer::UpdateProjection(w, h);
+                break;
+            }
+            case CaptureOp::DefineTexture: {
+                uint16_t textureIndex;
+                int32_t w, h;
+                TextureFilter filter;
+                reader.Read(textureIndex);
+                reader.Read(w);
+                reader.Read(h);
+                reader.Read(filter);
+                break;
+            }
+            case CaptureOp::Quad: {
+                CaptureQuad quad;
+                ReadQuad(reader, quad);
+
+                std::shared_ptr<Texture> texture =
+                    (quad.TextureIndex < m_Textures.size()) ? m_Textures[quad.TextureIndex] : nullptr;
+
+                if ((quad.Flags & CaptureQuadFlags_FullSource) && texture)
+                    quad.SourceRect = {0.0f, 0.0f, (float) texture->GetWidth(), (float) texture->GetHeight()};
+
+                Renderer::DrawQuad(texture, quad.Position, quad.Scale, quad.Color, quad.Rotation, quad.Origin,
+                                   quad.SourceRect);
+                break;
+            }
+            case CaptureOp::Shape: {
+                CaptureShape shape;
+                ReadShape(reader, shape);
+
+                Renderer::DrawRoundedRect(shape.Position, shape.Size, shape.CornerRadius, shape.Color, shape.Rotation,
+                                          shape.OutlineThickness);
+                break;
+            }
+            default:
+                return;
+            }
+        }
+    }
+} // namespace Nova
@@ -3,12 +3,15 @@
 #include "Nova/Renderer/Shader.hpp"
 #include "Nova/Renderer/Texture.hpp"
 #include "Nova/Renderer/GLError.hpp"
+#include "Nova/Renderer/RenderCapture.hpp"
+#include "Nova/Renderer/TextureUploader.hpp"
 
 #include "Nova/Misc/Logger.hpp"
 #include "Nova/Misc/Assert.hpp"
 #include "Nova/Misc/Metrics.hpp"
 
 #include "Nova/Core/Window.hpp"
+#include "Nova/Core/JobSystem.hpp"
 
 #include <glad/glad.h>
 #include <glm/vec2.hpp>
@@ -17,6 +20,7 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <array>
 #include <algorithm>
+#include <cmath>
 
 namespace Nova::Renderer
 {
@@ -24,18 +28,17 @@ namespace Nova::Renderer
     static constexpr size_t MAX_VERTICES = MAX_QUADS * 4;
     static constexpr size_t MAX_INDICES = MAX_QUADS * 6;
     static constexpr size_t MAX_TEXTURE_SLOTS = 16;
+    static constexpr uint32_t PARTICLE_VERTEX_GRAIN_SIZE = 4096;
 
-    struct VertexData
-    {
-        glm::vec2 Position;
-        glm::vec2 TexCoords;
-        glm::vec4 Color;
-        float TexIndex;
-    };
+    using VertexData = QuadVertex;
 
     struct RendererData
     {
         uint32_t QuadIndicesCount = 0;
+        float Time = 0.0f;
+        bool WarnedCPUAnimation = false; // of a GPUSpriteAnimation clip that isn't consecutive
+        glm::ivec2 ViewportSize = {0, 0};
+        glm::mat4 Projection = {1.0f};
         std::shared_ptr<Texture> QuadTexture = std::make_shared<Texture>(); // just a white 1x1 texture
         std::vector<VertexData> QuadVertices;
         std::vector<std::shared_ptr<Texture>> QuadTextures;
@@ -51,49 +54,118 @@ namespace Nova::Renderer
         "layout (location = 0) in vec2 aPos;\n"
         "layout (location = 1) in vec2 aTexCoords;\n"
         "layout (location = 2) in vec4 aColor;\n"
-        "layout (location = 3) in float aTexIndex;\n"
+        "layout (location = 3) in vec4 aParams;\n"
+        "layout (location = 4) in uvec4 aQuad;\n"      // texture slot, flags, palette row, frame count
+        "layout (location = 5) in uvec2 aAnimation;\n" // columns, first cell
         "out vec2 TexCoords;\n"
         "out vec4 Color;\n"
-        "out float TexIndex;\n"
+        "flat out int TexIndex;\n"
+        "out vec2 ShapeLocal;\n"
+        "flat out vec4 ShapeParams;\n"
+        "flat out float PaletteRow;\n"
         "uniform mat4 uProjection;\n"
+        "uniform float uTime;\n"
         "void main()\n"
         "{\n"
         "    TexCoords = aTexCoords;\n"
+        "    ShapeLocal = vec2(0.0);\n"
+        "    ShapeParams = vec4(0.0);\n"
+        "    if ((aQuad.y & 1u) != 0u)\n"
+        "    {\n"
+        "        ShapeLocal = (aTexCoords * 2.0 - 1.0) * (aParams.xy + 1.0);\n"
+        "        ShapeParams = aParams;\n"
+        "    }\n"
+        "    else if ((aQuad.y & 2u) != 0u)\n"
+        "    {\n"
+        "        float frameCount = float(aQuad.w);\n"
+        "        float frame = floor(max(uTime - aParams.x, 0.0) / aParams.y);\n"
+        "        frame = ((aQuad.y & 4u) != 0u) ? mod(frame, frameCount) : min(frame, frameCount - 1.0);\n"
+        "        uint columns = aAnimation.x;\n"
+        "        uint first = aAnimation.y;\n"
+        "        uint cell = first + uint(frame);\n"
+        "        ivec2 delta = ivec2(cell % columns, cell / columns) - ivec2(first % columns, first / columns);\n"
+        "        TexCoords += vec2(delta) * aParams.zw;\n"
+        "    }\n"
         "    Color = aColor;\n"
-        "    TexIndex = aTexIndex;\n"
+        "    TexIndex = int(aQuad.x);\n"
+        "    PaletteRow = float(aQuad.z);\n"
         "    gl_Position = uProjection * vec4(aPos, 0.0, 1.0);\n"
         "}\n";
 
+    // samplers can't be indexed with a variable in GLSL 330, hence the switches
     static constexpr const char* s_FragmentShaderSource = 
         "#version 330 core\n"
         "in vec2 TexCoords;\n"
         "in vec4 Color;\n"
-        "in float TexIndex;\n"
+        "flat in int TexIndex;\n"
+        "in vec2 ShapeLocal;\n"
+        "flat in vec4 ShapeParams;\n"
+        "flat in float PaletteRow;\n"
         "out vec4 FragColor;\n"
         "uniform sampler2D uTextures[16];\n"
-        "void main()\n"
+        "uniform int uPremultipliedMask;\n"
+        "uniform int uIndexedMask;\n"
+        "uniform int uPaletteSlots[16];\n"
+        "vec4 SampleTexture(int slot, vec2 uv)\n"
         "{\n"
-        "    int texIdx = int(TexIndex);\n"
-        "    vec4 color = Color;\n"
-        "    switch (texIdx)\n"
+        "    switch (slot)\n"
+        "    {\n"
+        "        case 0: return texture(uTextures[0], uv);\n"
+        "        case 1: return texture(uTextures[1], uv);\n"
+        "        case 2: return texture(uTextures[2], uv);\n"
+        "        case 3: return texture(uTextures[3], uv);\n"
+        "        case 4: return texture(uTextures[4], uv);\n"
+        "        case 5: return texture(uTextures[5], uv);\n"
+        "        case 6: return texture(uTextures[6], uv);\n"
+        "        case 7: return texture(uTextures[7], uv);\n"
+        "        case 8: return texture(uTextures[8], uv);\n"
+        "        case 9: return texture(uTextures[9], uv);\n"
+        "        case 10: return texture(uTextures[10], uv);\n"
+        "        case 11: return texture(uTextures[11], uv);\n"
+        "        case 12: return texture(uTextures[12], uv);\n"
+        "        case 13: return texture(uTextures[13], uv);\n"
+        "        case 14: return texture(uTextures[14], uv);\n"
+        "        case 15: return texture(uTextures[15], uv);\n"
+        "    }\n"
+        "    return vec4(1.0);\n"
+        "}\n"
+        "vec4 FetchTexel(int slot, ivec2 texel)\n"
+        "{\n"
+        "    switch (slot)\n"
         "    {\n"
-        "        case 0: color *= texture(uTextures[0], TexCoords); break;\n"
-        "        case 1: color *= texture(uTextures[1], TexCoords); break;\n"
-        "        case 2: color *= texture(uTextures[2], TexCoords); break;\n"
-        "        case 3: color *= texture(uTextures[3], TexCoords); break;\n"
-        "        case 4: color *= texture(uTextures[4], TexCoords); break;\n"
-        "        case 5: color *= texture(uTextures[5], TexCoords); break;\n"
-        "        case 6: color *= texture(uTextures[6], TexCoords); break;\n"
-        "        case 7: color *= texture(uTextures[7], TexCoords); break;\n"
-        "        case 8: color *= texture(uTextures[8], TexCoords); break;\n"
-        "        case 9: color *= texture(uTextures[9], TexCoords); break;\n"
-        "        case 10: color *= texture(uTextures[10], TexCoords); break;\n"
-        "        case 11: color *= texture(uTextures[11], TexCoords); break;\n"
-        "        case 12: color *= texture(uTextures[12], TexCoords); break;\n"
-        "        case 13: color *= texture(uTextures[13], TexCoords); break;\n"
-        "        case 14: color *= texture(uTextures[14], TexCoords); break;\n"
-        "        case 15: color *= texture(uTextures[15], TexCoords); break;\n"
+        "        case 0: return texelFetch(uTextures[0], texel, 0);\n"
+        "        case 1: return texelFetch(uTextures[1], texel, 0);\n"
+        "        case 2: return texelFetch(uTextures[2], texel, 0);\n"
+        "        case 3: return texelFetch(uTextures[3], texel, 0);\n"
+        "        case 4: return texelFetch(uTextures[4], texel, 0);\n"
+        "        case 5: return texelFetch(uTextures[5], texel, 0);\n"
+        "        case 6: return texelFetch(uTextures[6], texel, 0);\n"
+        "        case 7: return texelFetch(uTextures[7], texel, 0);\n"
+        "        case 8: return texelFetch(uTextures[8], texel, 0);\n"
+        "        case 9: return texelFetch(uTextures[9], texel, 0);\n"
+        "        case 10: return texelFetch(uTextures[10], texel, 0);\n"
+        "        case 11: return texelFetch(uTextures[11], texel, 0);\n"
+        "        case 12: return texelFetch(uTextures[12], texel, 0);\n"
+        "        case 13: return texelFetch(uTextures[13], texel, 0);\n"
+        "        case 14: return texelFetch(uTextures[14], texel, 0);\n"
+        "        case 15: return texelFetch(uTextures[15], texel, 0);\n"
         "    }\n"
+        "    return vec4(1.0);\n"
+        "}\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 q = abs(ShapeLocal) - ShapeParams.xy + ShapeParams.z;\n"
+        "    float dist = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - ShapeParams.z;\n"
+        "    if (ShapeParams.w > 0.0) dist = abs(dist + ShapeParams.w * 0.5) - ShapeParams.w * 0.5;\n"
+        "    float edge = max(fwidth(dist), 1e-4);\n"
+        "    int texIdx = TexIndex;\n"
+        "    vec4 color = Color;\n"
+        "    if (ShapeParams.x > 0.0) color.a *= clamp(0.5 - dist / edge, 0.0, 1.0);\n"
+        "    vec4 texel = SampleTexture(texIdx, TexCoords);\n"
+        "    if (((uIndexedMask >> texIdx) & 1) != 0)\n"
+        "        texel = FetchTexel(uPaletteSlots[texIdx], ivec2(int(texel.r * 255.0 + 0.5), int(PaletteRow + 0.5)));\n"
+        "    if (((uPremultipliedMask >> texIdx) & 1) != 0 && texel.a > 0.0) texel.rgb /= texel.a;\n"
+        "    color *= texel;\n"
         "    if (color.a == 0.0) discard;\n"
         "    FragColor = color;\n"
         "}\n";
@@ -112,15 +184,25 @@ namespace Nova::Renderer
     {
         glm::mat4 projection = glm::ortho(0.0f, (float) width, (float) height, 0.0f, -1.0f, 1.0f);
 
+        s_Data.Projection = projection;
+
         s_Data.QuadShader.Bind();
         s_Data.QuadShader.SetUniformMat4("uProjection", projection);
         s_Data.QuadShader.Unbind();
 
         glViewport(0, 0, width, height);
 
+        s_Data.ViewportSize = {width, height};
+        RenderCapture::RecordProjection(width, height);
+
         CheckOpenGLErrors();
     }
 
+    glm::ivec2 GetViewportSize()
+    {
+        return s_Data.ViewportSize;
+    }
+
     void EnableMultisampling()
     {
         glEnable(GL_MULTISAMPLE);
@@ -150,8 +232,10 @@ namespace Nova::Renderer
         s_Data.QuadVA.InitVertexBuffer(nullptr, s_Data.QuadVertices.capacity() * sizeof(VertexData),
                                        {{ShaderDataType::Float2, false},
                                         {ShaderDataType::Float2, false},
+                                        {ShaderDataType::UByte4, true},
                                         {ShaderDataType::Float4, false},
-                                        {ShaderDataType::Float, false}});
+                                        {ShaderDataType::UShort4, false},
+                                        {ShaderDataType::UShort2, false}});
 
         std::vector<uint32_t> quadIndices(MAX_INDICES);
 
@@ -189,6 +273,8 @@ namespace Nova::Renderer
 
         UpdateProjection(width, height);
 
+        TextureUploader::Init();
+
         CheckOpenGLErrors();
 
         s_Initialized = true;
@@ -202,7 +288,10 @@ namespace Nova::Renderer
 
         Logger::Info("Shutting down Renderer...");
 
+        // the capture ends with the last frame the application ended, not with this extra one
+        RenderCapture::End();
         EndFrame();
+        TextureUploader::Shutdown();
 
         s_Data.QuadVA.Shutdown();
         s_Data.QuadShader.Shutdown();
@@ -223,6 +312,16 @@ namespace Nova::Renderer
         s_Data.QuadIndicesCount = 0;
     }
 
+    // slot of the texture in the current batch, or the number of slots in use when it isn't there
+    static size_t FindBatchTextureSlot(const Texture& texture)
+    {
+        auto it = std::ranges::find_if(s_Data.QuadTextures, [&](const auto& tex) {
+            return tex->GetID() == texture.GetID();
+        });
+
+        return std::distance(std::begin(s_Data.QuadTextures), it);
+    }
+
     static void SendQuadBatch()
     {
         if (s_Data.QuadIndicesCount == 0)
@@ -231,10 +330,33 @@ namespace Nova::Renderer
         s_Data.QuadVA.Bind();
         s_Data.QuadShader.Bind();
 
+        int32_t premultipliedMask = 0;
+        int32_t indexedMask = 0;
+        std::array<int32_t, MAX_TEXTURE_SLOTS> paletteSlots = {};
+
         for (size_t i = 0; i < s_Data.QuadTextures.size(); ++i)
-            s_Data.QuadTextures[i]->Bind(i);
+        {
+            const Texture& texture = *s_Data.QuadTextures[i];
+            texture.Bind(i);
 
-        s_Data.QuadVA.SetVertexBufferData(s_Data.QuadVertices.data(), s_Data.QuadVertices.size() * sizeof(VertexData));
+            if (texture.IsPremultiplied())
+                premultipliedMask |= 1 << i;
+
+            if (texture.IsIndexed())
+            {
+                indexedMask |= 1 << i;
+                paletteSlots[i] = (int32_t) FindBatchTextureSlot(*texture.GetPalette());
+            }
+        }
+
+        s_Data.QuadShader.SetUniformInt("uPremultipliedMask", premultipliedMask);
+        s_Data.QuadShader.SetUniformInt("uIndexedMask", indexedMask);
+        s_Data.QuadShader.SetUniformIntV("uPaletteSlots", paletteSlots.data(), MAX_TEXTURE_SLOTS);
+        s_Data.QuadShader.SetUniformFloat("uTime", s_Data.Time);
+
+        const size_t vertexBytes = s_Data.QuadVertices.size() * sizeof(VertexData);
+
+        s_Data.QuadVA.SetVertexBufferData(s_Data.QuadVertices.data(), vertexBytes);
         glDrawElements(GL_TRIANGLES, s_Data.QuadIndicesCount, GL_UNSIGNED_INT, nullptr);
 
         s_Data.QuadShader.Unbind();
@@ -244,24 +366,243 @@ namespace Nova::Renderer
 
         Metrics::IncrementDrawnObjects(s_Data.QuadIndicesCount / 6);
         Metrics::IncrementDrawCalls();
+        Metrics::IncrementVertexBytes(vertexBytes);
 
         ClearQuadBatch();
     }
 
-    void BeginFrame() {}
+    // returns the slot of the texture in the current batch, flushing the batch if all slots are taken
+    static uint16_t GetBatchTextureIndex(const std::shared_ptr<Texture>& texture)
+    {
+        if (texture == s_Data.QuadTexture)
+            return 0;
+
+        // the writes of the frame so far, coalesced into one upload
+        texture->FlushWrites();
+
+        if (const size_t slot = FindBatchTextureSlot(*texture); slot < s_Data.QuadTextures.size())
+            return static_cast<uint16_t>(slot);
+
+        // indexed textures bring their palette along, both have to fit in the same batch
+        const std::shared_ptr<Texture>& palette = texture->GetPalette();
+
+        if (s_Data.QuadTextures.size() + (palette ? 2 : 1) > MAX_TEXTURE_SLOTS)
+            SendQuadBatch();
+
+        if (palette)
+            GetBatchTextureIndex(palette);
+
+        s_Data.QuadTextures.emplace_back(texture);
+        return static_cast<uint16_t>(s_Data.QuadTextures.size() - 1);
+    }
+
+    void Flush()
+    {
+        SendQuadBatch();
+    }
+
+    float GetTime()
+    {
+        return s_Data.Time;
+    }
+
+    void BeginFrame()
+    {
+        s_Data.Time = (float) Metrics::GetTime();
+
+        TextureUploader::Update();
+        RenderCapture::RecordBeginFrame();
+    }
 
     void EndFrame()
     {
         SendQuadBatch();
         CheckOpenGLErrors();
+
+        RenderCapture::RecordEndFrame();
     }
 
     void ClearScreen(const Color& color)
     {
+        RenderCapture::RecordClear(color);
+
         glClearColor((color.r / 255.0f), (color.g / 255.0f), (color.b / 255.0f), (color.a / 255.0f));
         glClear(GL_COLOR_BUFFER_BIT);
     }
 
+    // per quad data of sprites animated by the vertex shader (see QuadVertex)
+    struct QuadAnimation
+    {
+        float StartTime = 0.0f;
+        float FrameTime = 0.0f;
+        glm::vec2 CellSize = {0.0f, 0.0f}; // in uv
+        uint16_t FrameCount = 0;
+        uint16_t Columns = 0;
+        uint16_t FirstCell = 0;
+        bool Loop = false;
+    };
+
+    // world space vertices of a quad, without the texture slot which depends on the batch. animation is null for
+    // quads that aren't animated on the GPU.
+    static void BuildQuadVertices(VertexData* vertices, const Texture& texture, const glm::vec2& position,
+                                  const glm::vec2& scale, const Color& color, float rotation, const glm::vec2& origin,
+                                  const glm::vec4& sourceRect, uint32_t paletteRow,
+                                  const QuadAnimation* animation = nullptr)
+    {
+        if (const std::shared_ptr<Texture>& palette = texture.GetPalette())
+            paletteRow = std::min<uint32_t>(paletteRow, palette->GetHeight() - 1);
+
+        bool flipX = false;
+        glm::vec4 src = sourceRect;
+
+        if (src.z < 0.0f)
+        {
+            src.z *= -1.0f;
+            flipX = true;
+        }
+
+        if (src.w < 0.0f)
+            src.w *= -1.0f;
+
+        glm::vec2 texSize = {(float) texture.GetWidth(), (float) texture.GetHeight()};
+        glm::vec2 srcTexSize = {src.z, src.w};
+        glm::vec2 uvMin = {src.x / texSize.x, src.y / texSize.y};
+        glm::vec2 uvMax = {(src.x + src.z) / texSize.x, (src.y + src.w) / texSize.y};
+
+        auto texCoords = std::to_array<glm::vec2>({
+            {uvMin.x, uvMin.y},
+            {uvMax.x, uvMin.y},
+            {uvMax.x, uvMax.y},
+            {uvMin.x, uvMax.y},
+        });
+
+        if (flipX)
+        {
+            std::swap(texCoords[0], texCoords[1]);
+            std::swap(texCoords[2], texCoords[3]);
+        }
+
+        glm::mat4 transform = {1.0f};
+        transform = glm::translate(transform, glm::vec3(position, 0.0f));
+        transform = glm::translate(transform, glm::vec3(origin, 0.0f));
+        transform = glm::rotate(transform, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+        transform = glm::scale(transform, glm::vec3(scale * srcTexSize, 1.0f));
+        transform = glm::translate(transform, glm::vec3(-origin, 0.0f));
+
+        VertexData quad = {
+            .Color = color,
+            .Params = glm::vec4(0.0f),
+            .TexIndex = 0,
+            .Flags = QuadFlags_None,
+            .PaletteRow = (uint16_t) std::min<uint32_t>(paletteRow, UINT16_MAX),
+        };
+
+        if (animation)
+        {
+            quad.Params = {animation->StartTime, animation->FrameTime, animation->CellSize.x, animation->CellSize.y};
+            quad.Flags = (uint16_t) (QuadFlags_Animated | (animation->Loop ? QuadFlags_Loop : QuadFlags_None));
+            quad.FrameCount = animation->FrameCount;
+            quad.Columns = animation->Columns;
+            quad.FirstCell = animation->FirstCell;
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            glm::vec4 pos = transform * glm::vec4(s_QuadVertexPos[i], 0.0f, 1.0f);
+
+            vertices[i] = quad;
+            vertices[i].Position = {pos.x, pos.y};
+            vertices[i].TexCoords = texCoords[i];
+        }
+    }
+
+    // appends 4 vertices to the batch for the caller to fill, texIndex is the slot of texture
+    static VertexData* AllocateQuad(const std::shared_ptr<Texture>& texture, uint16_t& texIndex)
+    {
+        if (s_Data.QuadVertices.size() > MAX_VERTICES - 4)
+            SendQuadBatch();
+
+        // can flush the batch too
+        texIndex = GetBatchTextureIndex(texture);
+
+        const size_t first = s_Data.QuadVertices.size();
+
+        s_Data.QuadVertices.resize(first + 4);
+        s_Data.QuadIndicesCount += 6;
+
+        return &s_Data.QuadVertices[first];
+    }
+
+    static void SubmitQuad(std::shared_ptr<Texture> texture, const glm::vec2& position, const glm::vec2& scale,
+                           const Color& color, float rotation, const glm::vec2& origin, const glm::vec4& sourceRect,
+                           uint32_t paletteRow, const QuadAnimation* animation = nullptr)
+    {
+        if (!texture)
+            texture = s_Data.QuadTexture;
+
+        if (RenderCapture::IsCapturing())
+        {
+            RenderCapture::RecordQuad((texture != s_Data.QuadTexture) ? texture.get() : nullptr, position, scale, color,
+                                      rotation, origin, sourceRect);
+        }
+
+        uint16_t texIndex = 0;
+        VertexData* vertices = AllocateQuad(texture, texIndex);
+
+        BuildQuadVertices(vertices, *texture, position, scale, color, rotation, origin, sourceRect, paletteRow,
+                          animation);
+
+        for (int i = 0; i < 4; ++i)
+            vertices[i].TexIndex = texIndex;
+    }
+
+    void BuildQuad(CachedQuad& quad, std::shared_ptr<Texture> texture, const glm::vec2& position,
+                   const glm::vec2& scale, const Color& color, float rotation, const glm::vec2& origin,
+                   const glm::vec4& sourceRect, uint32_t paletteRow)
+    {
+        if (!texture)
+            texture = s_Data.QuadTexture;
+
+        BuildQuadVertices(quad.Vertices.data(), *texture, position, scale, color, rotation, origin, sourceRect,
+                          paletteRow);
+
+        quad.Texture = std::move(texture);
+        quad.Position = position;
+        quad.Scale = scale;
+        quad.Color = color;
+        quad.Rotation = rotation;
+        quad.Origin = origin;
+        quad.SourceRect = sourceRect;
+    }
+
+    void BuildQuad(CachedQuad& quad, const glm::vec2& position, const glm::vec2& scale, const Color& color,
+                   float rotation, const glm::vec2& origin)
+    {
+        BuildQuad(quad, s_Data.QuadTexture, position, scale, color, rotation, origin,
+                  {0.0f, 0.0f, s_Data.QuadTexture->GetWidth(), s_Data.QuadTexture->GetHeight()});
+    }
+
+    void DrawQuad(const CachedQuad& quad)
+    {
+        if (!quad.Texture)
+            return;
+
+        if (RenderCapture::IsCapturing())
+        {
+            RenderCapture::RecordQuad((quad.Texture != s_Data.QuadTexture) ? quad.Texture.get() : nullptr,
+                                      quad.Position, quad.Scale, quad.Color, quad.Rotation, quad.Origin,
+                                      quad.SourceRect);
+        }
+
+        uint16_t texIndex = 0;
+        VertexData* vertices = AllocateQuad(quad.Texture, texIndex);
+
+        std::copy(quad.Vertices.begin(), quad.Vertices.end(), vertices);
+
+        for (int i = 0; i < 4; ++i)
+            vertices[i].TexIndex = texIndex;
+    }
+
     void DrawQuad(const glm::vec2& position, const glm::vec2& scale, const Color& color, float rotation,
                   const glm::vec2& origin)
     {
@@ -308,88 +649,286 @@ namespace Nova::Renderer
         if (sprite.FlipX)
             src.z *= -1.0f;
 
-        DrawQuad(sprite.GetTexture(), position, scale, White, rotation, origin, src);
+        DrawQuad(sprite.GetTexture(), position, scale, White, rotation, origin, src, sprite.PaletteRow);
     }
 
-    void DrawQuad(std::shared_ptr<Texture> texture, const glm::vec2& position, const glm::vec2& scale,
-                  const Color& color, float rotation, const glm::vec2& origin, const glm::vec4& sourceRect)
+    void DrawSprite(const SpriteInstance& sprite, const glm::vec2& position, const glm::vec2& scale, float rotation,
+                    const glm::vec2& origin)
     {
-        if (!texture)
-            texture = s_Data.QuadTexture;
+        if (!sprite.Sheet)
+            return;
 
-        if (s_Data.QuadVertices.size() > MAX_VERTICES - 4)
-            SendQuadBatch();
+        glm::vec4 src = sprite.Sheet->GetSourceRect(sprite);
 
-        float texIndex = 0.0f;
-        if (texture != s_Data.QuadTexture)
-        {
-            auto it = std::ranges::find_if(s_Data.QuadTextures, [&](const auto& tex) {
-                return tex->GetID() == texture->GetID();
-            });
+        if (sprite.FlipX)
+            src.z *= -1.0f;
 
-            if (it != std::end(s_Data.QuadTextures))
-                texIndex = static_cast<float>(std::distance(std::begin(s_Data.QuadTextures), it));
-            else
-            {
-                if (s_Data.QuadTextures.size() >= MAX_TEXTURE_SLOTS)
-                    SendQuadBatch();
+        DrawQuad(sprite.Sheet->GetTexture(), position, scale, White, rotation, origin, src, sprite.PaletteRow);
+    }
+
+    // the shader steps through consecutive cells, numbered on 16 bits in the quad vertices
+    static bool IsGPUAnimated(const SpriteSheet& sheet, SpriteClipID id)
+    {
+        if (id >= sheet.GetClipCount())
+            return false;
 
-                s_Data.QuadTextures.emplace_back(texture);
-                texIndex = static_cast<float>(s_Data.QuadTextures.size() - 1);
+        const SpriteClip& clip = sheet.GetClip(id);
+        const uint32_t lastCell = sheet.GetClipCell(id, 0) + clip.FrameCount - 1;
+
+        return clip.Consecutive && clip.FrameCount > 0 && lastCell <= UINT16_MAX &&
+               sheet.GetColumnCount() <= UINT16_MAX;
+    }
+
+    void DrawSprite(const GPUSpriteAnimation& sprite, const glm::vec2& position, const glm::vec2& scale,
+                    float rotation, const glm::vec2& origin)
+    {
+        const SpriteSheet* sheet = sprite.Sheet;
+
+        if (!sheet)
+            return;
+
+        if (!IsGPUAnimated(*sheet, sprite.Clip))
+        {
+            SpriteInstance instance = {
+                .Sheet = sheet,
+                .Clip = sprite.Clip,
+                .PaletteRow = sprite.PaletteRow,
+                .FlipX = sprite.FlipX,
+            };
+
+            // the frame is picked here the same way the shader would
+            if (sprite.Clip < sheet->GetClipCount() && sheet->GetClip(sprite.Clip).FrameCount > 0)
+            {
+                const SpriteClip& clip = sheet->GetClip(sprite.Clip);
+                const float frame = std::floor(std::max(s_Data.Time - sprite.StartTime, 0.0f) / clip.FrameTime);
+
+                instance.Frame = clip.Loop ? (uint32_t) std::fmod(frame, (float) clip.FrameCount)
+                                           : (uint32_t) std::min(frame, (float) clip.FrameCount - 1.0f);
+
+                if (!s_Data.WarnedCPUAnimation)
+                {
+                    Logger::Warning("GPU sprite animation clip {} isn't made of consecutive cells (numbered on 16 "
+                                    "bits), it's animated on the CPU instead",
+                                    sprite.Clip);
+                    s_Data.WarnedCPUAnimation = true;
+                }
             }
+
+            DrawSprite(instance, position, scale, rotation, origin);
+            return;
         }
 
-        bool flipX = false;
-        glm::vec4 src = sourceRect;
+        const SpriteClip& clip = sheet->GetClip(sprite.Clip);
+        const uint32_t firstCell = sheet->GetClipCell(sprite.Clip, 0);
+        std::shared_ptr<Texture> texture = sheet->GetTexture();
 
-        if (src.z < 0.0f)
-        {
+        if (!texture)
+            texture = s_Data.QuadTexture;
+
+        glm::vec4 src = sheet->GetCellRect(firstCell);
+        const glm::vec2 textureSize = {(float) texture->GetWidth(), (float) texture->GetHeight()};
+        const glm::vec2 cellSize = glm::vec2(src.z, src.w) / textureSize;
+
+        if (sprite.FlipX)
             src.z *= -1.0f;
-            flipX = true;
-        }
 
-        if (src.w < 0.0f)
-            src.w *= -1.0f;
+        const QuadAnimation animation = {
+            .StartTime = sprite.StartTime,
+            .FrameTime = clip.FrameTime,
+            .CellSize = cellSize,
+            .FrameCount = (uint16_t) clip.FrameCount,
+            .Columns = (uint16_t) sheet->GetColumnCount(),
+            .FirstCell = (uint16_t) firstCell,
+            .Loop = clip.Loop,
+        };
+
+        SubmitQuad(texture, position, scale, White, rotation, origin, src, sprite.PaletteRow, &animation);
+    }
 
-        glm::vec2 texSize = {(float) texture->GetWidth(), (float) texture->GetHeight()};
-        glm::vec2 srcTexSize = {src.z, src.w};
-        glm::vec2 uvMin = {src.x / texSize.x, src.y / texSize.y};
-        glm::vec2 uvMax = {(src.x + src.z) / texSize.x, (src.y + src.w) / texSize.y};
+    void DrawQuad(std::shared_ptr<Texture> texture, const glm::vec2& position, const glm::vec2& scale,
+                  const Color& color, float rotation, const glm::vec2& origin, const glm::vec4& sourceRect,
+                  uint32_t paletteRow)
+    {
+        SubmitQuad(std::move(texture), position, scale, color, rotation, origin, sourceRect, paletteRow);
+    }
 
-        auto texCoords = std::to_array<glm::vec2>({
-            {uvMin.x, uvMin.y},
-            {uvMax.x, uvMin.y},
-            {uvMax.x, uvMax.y},
-            {uvMin.x, uvMax.y},
-        });
+    void DrawQuad(VirtualTexture& texture, const glm::vec2& position, const glm::vec2& scale, const Color& color)
+    {
+        if (!texture.IsInitialized())
+            return;
 
-        if (flipX)
-        {
-            std::swap(texCoords[0], texCoords[1]);
-            std::swap(texCoords[2], texCoords[3]);
-        }
+        SendQuadBatch();
 
-        glm::mat4 transform = {1.0f};
-        transform = glm::translate(transform, glm::vec3(position, 0.0f));
-        transform = glm::translate(transform, glm::vec3(origin, 0.0f));
-        transform = glm::rotate(transform, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
-        transform = glm::scale(transform, glm::vec3(scale * srcTexSize, 1.0f));
-        transform = glm::translate(transform, glm::vec3(-origin, 0.0f));
+        texture.Draw(s_Data.Projection, position, scale, color);
+
+        CheckOpenGLErrors();
 
-        glm::vec4 normalizedColor = {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f};
+        Metrics::IncrementDrawnObjects(1);
+        Metrics::IncrementDrawCalls();
+    }
+
+    void DrawCircle(const glm::vec2& center, float radius, const Color& color)
+    {
+        DrawRoundedRect(center, {radius * 2.0f, radius * 2.0f}, radius, color);
+    }
+
+    void DrawRing(const glm::vec2& center, float radius, float thickness, const Color& color)
+    {
+        DrawRoundedRect(center, {radius * 2.0f, radius * 2.0f}, radius, color, 0.0f, thickness);
+    }
+
+    void DrawLine(const glm::vec2& start, const glm::vec2& end, float thickness, const Color& color)
+    {
+        glm::vec2 delta = end - start;
+        float angle = glm::degrees(std::atan2(delta.y, delta.x));
+
+        DrawRoundedRect((start + end) * 0.5f, {glm::length(delta), thickness}, 0.0f, color, angle);
+    }
+
+    void DrawRoundedRect(const glm::vec2& position, const glm::vec2& size, float cornerRadius, const Color& color,
+                         float rotation, float outlineThickness)
+    {
+        const glm::vec2 halfSize = glm::abs(size) * 0.5f;
+
+        if (halfSize.x <= 0.0f || halfSize.y <= 0.0f)
+            return;
+
+        RenderCapture::RecordShape(position, size, cornerRadius, color, rotation, outlineThickness);
+
+        if (s_Data.QuadVertices.size() > MAX_VERTICES - 4)
+            SendQuadBatch();
+
+        const glm::vec4 params = {halfSize, std::clamp(cornerRadius, 0.0f, std::min(halfSize.x, halfSize.y)),
+                                  std::max(outlineThickness, 0.0f)};
+
+        // one extra pixel on each side leaves room for the antialiased edge
+        const glm::vec2 extent = (halfSize + 1.0f) * 2.0f;
+        const float sinR = std::sin(glm::radians(rotation));
+        const float cosR = std::cos(glm::radians(rotation));
 
         for (int i = 0; i < 4; ++i)
         {
-            glm::vec4 pos = transform * glm::vec4(s_QuadVertexPos[i], 0.0f, 1.0f);
+            glm::vec2 local = s_QuadVertexPos[i] * extent;
 
+            // the shader gets the position in the shape back from the corner
             s_Data.QuadVertices.emplace_back(VertexData{
-                .Position = glm::vec2{pos.x, pos.y},
-                .TexCoords = texCoords[i],
-                .Color = normalizedColor,
-                .TexIndex = texIndex,
+                .Position = position + glm::vec2{local.x * cosR - local.y * sinR, local.x * sinR + local.y * cosR},
+                .TexCoords = s_QuadVertexPos[i] + 0.5f,
+                .Color = color,
+                .Params = params,
+                .TexIndex = 0, // the default white texture is always in slot 0
+                .Flags = QuadFlags_Shape,
             });
         }
 
         s_Data.QuadIndicesCount += 6;
     }
+
+    void DrawParticles(const ParticleEmitter& emitter)
+    {
+        uint32_t count = emitter.GetParticleCount();
+
+        if (count == 0)
+            return;
+
+        const auto& config = emitter.GetConfig();
+
+        std::shared_ptr<Texture> texture = config.Texture;
+        if (!texture)
+            texture = s_Data.QuadTexture;
+
+        const glm::vec4 startColor = {config.StartColor.r, config.StartColor.g, config.StartColor.b,
+                                      config.StartColor.a};
+        const glm::vec4 endColor = {config.EndColor.r, config.EndColor.g, config.EndColor.b, config.EndColor.a};
+
+        const auto getColor = [&startColor, &endColor](float t) {
+            const glm::vec4 color = startColor + (endColor - startColor) * t + 0.5f;
+            return Color{(uint8_t) color.x, (uint8_t) color.y, (uint8_t) color.z, (uint8_t) color.w};
+        };
+
+        const float* posX = emitter.GetPositionsX().data();
+        const float* posY = emitter.GetPositionsY().data();
+        const float* ages = emitter.GetAges().data();
+        const float* invLifetimes = emitter.GetInvLifetimes().data();
+
+        if (RenderCapture::IsCapturing())
+        {
+            const Texture* captured = (texture != s_Data.QuadTexture) ? texture.get() : nullptr;
+            const glm::vec2 texSize = {(float) texture->GetWidth(), (float) texture->GetHeight()};
+
+            for (uint32_t p = 0; p < count; ++p)
+            {
+                const float t = std::min(ages[p] * invLifetimes[p], 1.0f);
+                const float size = config.StartSize + (config.EndSize - config.StartSize) * t;
+
+                RenderCapture::RecordQuad(captured, {posX[p], posY[p]}, glm::vec2{size, size} / texSize, getColor(t),
+                                          0.0f, {0.0f, 0.0f}, {0.0f, 0.0f, texSize.x, texSize.y});
+            }
+        }
+
+        uint32_t drawn = 0;
+
+        while (drawn < count)
+        {
+            if (s_Data.QuadVertices.size() > MAX_VERTICES - 4)
+                SendQuadBatch();
+
+            const uint16_t texIndex = GetBatchTextureIndex(texture);
+            const size_t firstVertex = s_Data.QuadVertices.size();
+            const uint32_t batchCount =
+                std::min<uint32_t>(count - drawn, (uint32_t) ((MAX_VERTICES - firstVertex) / 4));
+
+            s_Data.QuadVertices.resize(firstVertex + (size_t) batchCount * 4);
+
+            VertexData* vertices = s_Data.QuadVertices.data() + firstVertex;
+            const uint32_t offset = drawn;
+
+            // particles are axis aligned, so there's no need to go through a transform matrix
+            JobSystem::ParallelFor(batchCount, PARTICLE_VERTEX_GRAIN_SIZE, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    const uint32_t p = offset + i;
+                    const float t = std::min(ages[p] * invLifetimes[p], 1.0f);
+                    const float halfSize = 0.5f * (config.StartSize + (config.EndSize - config.StartSize) * t);
+                    const VertexData vertex = {.Color = getColor(t), .Params = glm::vec4(0.0f), .TexIndex = texIndex};
+                    const float x = posX[p];
+                    const float y = posY[p];
+
+                    VertexData* quad = vertices + (size_t) i * 4;
+
+                    quad[0] = vertex;
+                    quad[0].Position = {x - halfSize, y - halfSize};
+                    quad[0].TexCoords = {0.0f, 0.0f};
+                    quad[1] = vertex;
+                    quad[1].Position = {x + halfSize, y - halfSize};
+                    quad[1].TexCoords = {1.0f, 0.0f};
+                    quad[2] = vertex;
+                    quad[2].Position = {x + halfSize, y + halfSize};
+                    quad[2].TexCoords = {1.0f, 1.0f};
+                    quad[3] = vertex;
+                    quad[3].Position = {x - halfSize, y + halfSize};
+                    quad[3].TexCoords = {0.0f, 1.0f};
+                }
+            });
+
+            s_Data.QuadIndicesCount += batchCount * 6;
+            drawn += batchCount;
+        }
+    }
+
+    void DrawParticles(const GPUParticleEmitter& emitter)
+    {
+        if (!emitter.IsInitialized())
+            return;
+
+        // keep the draw order of everything submitted before the emitter
+        SendQuadBatch();
+
+        emitter.Draw(s_Data.Projection, *s_Data.QuadTexture);
+
+        CheckOpenGLErrors();
+
+        Metrics::IncrementDrawnObjects(emitter.GetMaxParticles());
+        Metrics::IncrementDrawCalls();
+    }
 } // namespace Nova::Renderer
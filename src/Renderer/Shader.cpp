@@ -126,6 +126,46 @@ namespace Nova
         return true;
     }
 
+    bool Shader::InitTransformFeedback(const std::string_view& vertexSource,
+                                       std::initializer_list<const char*> varyings)
+    {
+        if (vertexSource.empty() || varyings.size() == 0)
+        {
+            Logger::Warning("To create a transform feedback shader, a vertex source and its varyings must be provided!");
+            return false;
+        }
+
+        m_ID = glCreateProgram();
+
+        uint32_t vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+        glAttachShader(m_ID, vertexShader);
+
+        // must be set before linking
+        glTransformFeedbackVaryings(m_ID, (GLsizei) varyings.size(), varyings.begin(), GL_INTERLEAVED_ATTRIBS);
+
+        glLinkProgram(m_ID);
+        glDeleteShader(vertexShader);
+
+        int success = 0;
+        glGetProgramiv(m_ID, GL_LINK_STATUS, &success);
+
+        if (!success)
+        {
+            int len;
+            glGetProgramiv(m_ID, GL_INFO_LOG_LENGTH, &len);
+
+            std::string infoLog(len, '\0');
+            glGetProgramInfoLog(m_ID, len, nullptr, infoLog.data());
+
+            Logger::Warning("Failed to link transform feedback shader: {}", infoLog);
+            Shutdown();
+            return false;
+        }
+
+        CheckOpenGLErrors();
+        return true;
+    }
+
     void Shader::Shutdown()
     {
         if (m_ID)
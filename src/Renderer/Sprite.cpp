@@ -20,12 +20,14 @@ namespace Nova
         m_CurrentTime = 0.0f;
         m_Loop = loop;
 
-        CalculateCurrentPosition();
+        CalculateCurrentPosition(m_AnimationMap.find(name)->second);
     }
 
     void Sprite::Update(float deltaTime) noexcept
     {
-        if (m_CurrentAnimation.empty() || m_AnimationMap[m_CurrentAnimation].empty())
+        auto it = m_AnimationMap.find(m_CurrentAnimation);
+
+        if (it == m_AnimationMap.end() || it->second.empty())
             return;
 
         m_CurrentTime += deltaTime;
@@ -33,22 +35,27 @@ namespace Nova
         if (m_CurrentTime < m_Config.AnimationTick)
             return;
 
-        m_CurrentTime -= m_Config.AnimationTick;
+        // a long frame, or the time caught up by a throttled sprite, can skip several animation frames
+        uint32_t steps = 1;
+
+        if (m_Config.AnimationTick > 0.0f)
+            steps = (uint32_t) (m_CurrentTime / m_Config.AnimationTick);
 
-        const auto& currentFrames = m_AnimationMap[m_CurrentAnimation];
+        m_CurrentTime -= (float) steps * m_Config.AnimationTick;
+
+        const auto& currentFrames = it->second;
+        const uint32_t frameCount = (uint32_t) currentFrames.size();
 
         if (m_Loop)
-            m_CurrentAnimIndex = (m_CurrentAnimIndex + 1) % currentFrames.size();
-        else if (m_CurrentAnimIndex < currentFrames.size() - 1)
-            ++m_CurrentAnimIndex;
+            m_CurrentAnimIndex = (m_CurrentAnimIndex + steps) % frameCount;
+        else
+            m_CurrentAnimIndex = std::min(m_CurrentAnimIndex + steps, frameCount - 1);
 
-        CalculateCurrentPosition();
+        CalculateCurrentPosition(currentFrames);
     }
 
-    void Sprite::CalculateCurrentPosition() noexcept
+    void Sprite::CalculateCurrentPosition(const std::vector<uint32_t>& currentFrames) noexcept
     {
-        const auto& currentFrames = m_AnimationMap[m_CurrentAnimation];
-
         m_CurrentCol = currentFrames[m_CurrentAnimIndex] % m_Config.NumCols;
         m_CurrentRow = currentFrames[m_CurrentAnimIndex] / m_Config.NumCols;
     }
@@ -0,0 +1,226 @@
+#include "Nova/Renderer/SpriteSheet.hpp"
+#include "Nova/Misc/Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOVA_SPRITES_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Nova
+{
+    // shown by instances without a clip, and by empty sheets
+    static const glm::vec4 s_EmptyRect = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    SpriteSheet::SpriteSheet(const SpriteConfig& config)
+        : m_Texture(config.Texture), m_FrameSize((float) config.FrameWidth, (float) config.FrameHeight),
+          m_FrameTime(config.AnimationTick), m_Columns(std::max(config.NumCols, 1u))
+    {
+        m_CellRects.reserve(config.NumCols * config.NumRows);
+
+        for (uint32_t row = 0; row < config.NumRows; ++row)
+        {
+            for (uint32_t col = 0; col < config.NumCols; ++col)
+            {
+                m_CellRects.emplace_back((float) col * m_FrameSize.x, (float) row * m_FrameSize.y, m_FrameSize.x,
+                                         m_FrameSize.y);
+            }
+        }
+    }
+
+    SpriteClipID SpriteSheet::AddClip(const std::string_view& name, std::span<const uint32_t> frames, bool loop,
+                                      float frameTime)
+    {
+        if (m_ClipIDs.contains(name))
+        {
+            Logger::Warning("Clip {} already exists!", name);
+            return INVALID_SPRITE_CLIP;
+        }
+
+        if (frames.empty())
+        {
+            Logger::Warning("Clip {} has no frames!", name);
+            return INVALID_SPRITE_CLIP;
+        }
+
+        for (auto frame : frames)
+        {
+            if (frame >= m_CellRects.size())
+            {
+                Logger::Warning("Clip {} has frame {} which is out of range", name, frame);
+                return INVALID_SPRITE_CLIP;
+            }
+        }
+
+        const SpriteClipID id = (SpriteClipID) m_Clips.size();
+
+        bool consecutive = true;
+
+        for (size_t i = 1; i < frames.size(); ++i)
+            consecutive = consecutive && (frames[i] == frames[0] + i);
+
+        m_Clips.push_back({
+            .FirstFrame = (uint32_t) m_ClipFrames.size(),
+            .FrameCount = (uint32_t) frames.size(),
+            .FrameTime = std::max((frameTime > 0.0f) ? frameTime : m_FrameTime, 1e-4f),
+            .Loop = loop,
+            .Consecutive = consecutive,
+        });
+
+        m_ClipFrames.insert(m_ClipFrames.end(), frames.begin(), frames.end());
+        m_ClipIDs.emplace(name, id);
+
+        return id;
+    }
+
+    SpriteClipID SpriteSheet::AddClip(const std::string_view& name, uint32_t firstCell, uint32_t frameCount, bool loop,
+                                      float frameTime)
+    {
+        std::vector<uint32_t> frames(frameCount);
+
+        for (uint32_t i = 0; i < frameCount; ++i)
+            frames[i] = firstCell + i;
+
+        return AddClip(name, frames, loop, frameTime);
+    }
+
+    SpriteClipID SpriteSheet::FindClip(const std::string_view& name) const
+    {
+        auto it = m_ClipIDs.find(name);
+        return (it != m_ClipIDs.end()) ? it->second : INVALID_SPRITE_CLIP;
+    }
+
+    void SpriteSheet::Play(SpriteInstance& instance, SpriteClipID clip, bool restart) const noexcept
+    {
+        if (clip >= m_Clips.size() || (instance.Clip == clip && !restart))
+            return;
+
+        instance.Clip = clip;
+        instance.Frame = 0;
+        instance.Timer = 0.0f;
+    }
+
+    void SpriteSheet::Update(SpriteInstance& instance, float deltaTime) const noexcept
+    {
+        if (instance.Clip >= m_Clips.size())
+            return;
+
+        const SpriteClip& clip = m_Clips[instance.Clip];
+
+        instance.Timer += deltaTime;
+
+        if (instance.Timer < clip.FrameTime)
+            return;
+
+        // a long frame can skip several animation frames
+        const uint32_t steps = (uint32_t) (instance.Timer / clip.FrameTime);
+        instance.Timer -= (float) steps * clip.FrameTime;
+
+        if (clip.Loop)
+            instance.Frame = (instance.Frame + steps) % clip.FrameCount;
+        else
+            instance.Frame = std::min(instance.Frame + steps, clip.FrameCount - 1);
+    }
+
+    // instances are gathered into arrays of this many, small enough to stay on the stack
+    static constexpr uint32_t SPRITE_CHUNK_SIZE = 256;
+
+    // whole frame times are moved from the timers, which already include the delta time, to steps
+    static void AdvanceTimers(float* timers, const float* frameTimes, uint32_t* steps, uint32_t count)
+    {
+        uint32_t i = 0;
+
+#ifdef NOVA_SPRITES_SSE
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 frameTime = _mm_load_ps(frameTimes + i);
+            const __m128 timer = _mm_load_ps(timers + i);
+
+            // timers are never negative, so truncating is flooring
+            const __m128i frames = _mm_cvttps_epi32(_mm_div_ps(timer, frameTime));
+
+            _mm_store_ps(timers + i, _mm_sub_ps(timer, _mm_mul_ps(_mm_cvtepi32_ps(frames), frameTime)));
+            _mm_store_si128((__m128i*) (steps + i), frames);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            const float timer = timers[i];
+            const uint32_t frames = (uint32_t) (timer / frameTimes[i]);
+
+            timers[i] = timer - (float) frames * frameTimes[i];
+            steps[i] = frames;
+        }
+    }
+
+    void SpriteSheet::UpdateInstances(SpriteInstance* instances, uint32_t count, float deltaTime) noexcept
+    {
+        AdvanceInstances(instances, nullptr, deltaTime, count);
+    }
+
+    void SpriteSheet::UpdateInstances(SpriteInstance* instances, const float* deltaTimes, uint32_t count) noexcept
+    {
+        AdvanceInstances(instances, deltaTimes, 0.0f, count);
+    }
+
+    void SpriteSheet::AdvanceInstances(SpriteInstance* instances, const float* deltaTimes, float deltaTime,
+                                       uint32_t count) noexcept
+    {
+        alignas(16) float timers[SPRITE_CHUNK_SIZE];
+        alignas(16) float frameTimes[SPRITE_CHUNK_SIZE];
+        alignas(16) uint32_t steps[SPRITE_CHUNK_SIZE];
+
+        for (uint32_t first = 0; first < count; first += SPRITE_CHUNK_SIZE)
+        {
+            SpriteInstance* chunk = instances + first;
+            const uint32_t size = std::min(count - first, SPRITE_CHUNK_SIZE);
+
+            // instances without a clip get an infinite frame time, they never advance and are skipped below
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                const SpriteInstance& instance = chunk[i];
+                const bool playing = instance.Sheet && instance.Clip < instance.Sheet->m_Clips.size();
+
+                timers[i] = instance.Timer + (deltaTimes ? deltaTimes[first + i] : deltaTime);
+                frameTimes[i] = playing ? instance.Sheet->m_Clips[instance.Clip].FrameTime
+                                        : std::numeric_limits<float>::infinity();
+            }
+
+            AdvanceTimers(timers, frameTimes, steps, size);
+
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                SpriteInstance& instance = chunk[i];
+
+                if (std::isinf(frameTimes[i]))
+                    continue;
+
+                instance.Timer = timers[i];
+
+                if (steps[i] == 0)
+                    continue;
+
+                const SpriteClip& clip = instance.Sheet->m_Clips[instance.Clip];
+                const uint32_t frame = instance.Frame + steps[i];
+
+                if (frame < clip.FrameCount)
+                    instance.Frame = frame;
+                else
+                    instance.Frame = clip.Loop ? frame % clip.FrameCount : clip.FrameCount - 1;
+            }
+        }
+    }
+
+    const glm::vec4& SpriteSheet::GetSourceRect(const SpriteInstance& instance) const noexcept
+    {
+        if (instance.Clip >= m_Clips.size())
+            return m_CellRects.empty() ? s_EmptyRect : m_CellRects[0];
+
+        const SpriteClip& clip = m_Clips[instance.Clip];
+        return m_CellRects[m_ClipFrames[clip.FirstFrame + std::min(instance.Frame, clip.FrameCount - 1)]];
+    }
+} // namespace Nova
@@ -1,37 +1,284 @@
 #include "Nova/Renderer/Texture.hpp"
+#include "Nova/Renderer/CookedTexture.hpp"
 #include "Nova/Renderer/GLError.hpp"
+#include "Nova/Renderer/ImageCodecs.hpp"
 #include "Nova/Misc/Assert.hpp"
 #include "Nova/Misc/Logger.hpp"
+#include "Nova/Misc/MappedFile.hpp"
 
 #include <glad/glad.h>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// S3TC is an extension, so glad doesn't define its enums
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+
 namespace Nova
 {
-    Texture::~Texture()
+    static bool IsS3TCSupported()
     {
-        Shutdown();
+        static const bool supported = [] {
+            GLint count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+            for (GLint i = 0; i < count; ++i)
+            {
+                const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+
+                if (name && std::string_view(name) == "GL_EXT_texture_compression_s3tc")
+                    return true;
+            }
+
+            return false;
+        }();
+
+        return supported;
     }
 
-    bool Texture::Init(const std::filesystem::path& path)
+    static void DecodeColorBlock(const uint8_t* block, bool hasPunchThrough, uint8_t out[16][4])
     {
-        if (m_ID)
+        uint16_t c0, c1;
+        uint32_t indices;
+
+        std::memcpy(&c0, block, 2);
+        std::memcpy(&c1, block + 2, 2);
+        std::memcpy(&indices, block + 4, 4);
+
+        uint8_t palette[4][4];
+
+        for (int i = 0; i < 2; ++i)
         {
-            Logger::Warning("Can't set texture twice on the same texture!");
-            return false;
+            uint16_t c = i ? c1 : c0;
+
+            palette[i][0] = (uint8_t) (((c >> 11) & 31) * 255 / 31);
+            palette[i][1] = (uint8_t) (((c >> 5) & 63) * 255 / 63);
+            palette[i][2] = (uint8_t) ((c & 31) * 255 / 31);
+            palette[i][3] = 255;
+        }
+
+        for (int ch = 0; ch < 3; ++ch)
+        {
+            if (c0 > c1 || !hasPunchThrough)
+            {
+                palette[2][ch] = (uint8_t) ((2 * palette[0][ch] + palette[1][ch]) / 3);
+                palette[3][ch] = (uint8_t) ((palette[0][ch] + 2 * palette[1][ch]) / 3);
+            }
+            else
+            {
+                palette[2][ch] = (uint8_t) ((palette[0][ch] + palette[1][ch]) / 2);
+                palette[3][ch] = 0;
+            }
+        }
+
+        palette[2][3] = 255;
+        palette[3][3] = (c0 > c1 || !hasPunchThrough) ? 255 : 0;
+
+        for (int i = 0; i < 16; ++i)
+            std::memcpy(out[i], palette[(indices >> (2 * i)) & 3], 4);
+    }
+
+    static void DecodeAlphaBlock(const uint8_t* block, uint8_t out[16][4])
+    {
+        uint8_t a0 = block[0], a1 = block[1];
+        uint64_t indices = 0;
+
+        for (int i = 0; i < 6; ++i)
+            indices |= (uint64_t) block[2 + i] << (8 * i);
+
+        uint8_t palette[8] = {a0, a1};
+
+        if (a0 > a1)
+        {
+            for (int i = 1; i < 7; ++i)
+                palette[i + 1] = (uint8_t) (((7 - i) * a0 + i * a1) / 7);
+        }
+        else
+        {
+            for (int i = 1; i < 5; ++i)
+                palette[i + 1] = (uint8_t) (((5 - i) * a0 + i * a1) / 5);
+
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        for (int i = 0; i < 16; ++i)
+            out[i][3] = palette[(indices >> (3 * i)) & 7];
+    }
+
+    // fallback for drivers without S3TC, expands BC1/BC3 blocks to RGBA8
+    static void DecodeS3TC(CookedTextureFormat format, const uint8_t* blocks, uint32_t width, uint32_t height,
+                           std::vector<uint8_t>& pixels)
+    {
+        const uint32_t blockBytes = (format == CookedTextureFormat::BC1) ? 8 : 16;
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+
+        pixels.resize((size_t) width * height * 4);
+
+        for (uint32_t by = 0; by < blocksY; ++by)
+        {
+            for (uint32_t bx = 0; bx < blocksX; ++bx)
+            {
+                const uint8_t* block = blocks + ((size_t) by * blocksX + bx) * blockBytes;
+                uint8_t texels[16][4];
+
+                if (format == CookedTextureFormat::BC1)
+                    DecodeColorBlock(block, true, texels);
+                else
+                {
+                    DecodeColorBlock(block + 8, false, texels);
+                    DecodeAlphaBlock(block, texels);
+                }
+
+                for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y)
+                {
+                    for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x)
+                    {
+                        size_t offset = (((size_t) by * 4 + y) * width + bx * 4 + x) * 4;
+                        std::memcpy(&pixels[offset], texels[y * 4 + x], 4);
+                    }
+                }
+            }
+        }
+    }
+
+    // single and dual channel textures are grayscale and grayscale + alpha, like stb_image returns them
+    static void SetChannelSwizzle(int channels)
+    {
+        if (channels == 1)
+        {
+            const GLint swizzle[] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
         }
+        else if (channels == 2)
+        {
+            const GLint swizzle[] = {GL_RED, GL_RED, GL_RED, GL_GREEN};
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        }
+    }
+
+    // rows are padded like cooked ones, so every upload works with the default unpack alignment
+    static void AllocateDecodedPixels(TextureData& data, uint32_t width, uint32_t height, uint32_t channels)
+    {
+        data.Width = width;
+        data.Height = height;
+        data.Format = (channels == 1)   ? CookedTextureFormat::R8
+                      : (channels == 2) ? CookedTextureFormat::RG8
+                                        : CookedTextureFormat::RGBA8;
+        data.Flags = CookedTextureFlags_None;
+        data.Source = {};
+        data.Pixels.resize(GetCookedRowPitch(data.Format, width) * height);
+        data.Mips = {{width, height, 0, data.Pixels.size()}};
+    }
+
+    Texture::~Texture()
+    {
+        Shutdown();
+    }
 
+    bool TextureData::Decode(const std::filesystem::path& path)
+    {
         if (!std::filesystem::is_regular_file(path))
         {
             Logger::Warning("Path {} either does not exist or is not a regular file!", path.string());
             return false;
         }
 
+        if (!File.Open(path))
+            return false;
+
+        if (!Decode(File.GetSpan(), path))
+            return false;
+
+        // decoded images don't need the file anymore
+        if (Source.empty())
+            File.Close();
+
+        return true;
+    }
+
+    bool TextureData::Decode(std::span<const uint8_t> bytes, const std::filesystem::path& path)
+    {
         std::string pathString = path.string();
 
-        uint8_t* data = stbi_load(pathString.c_str(), &m_Width, &m_Height, &m_Channels, 0);
+        if (path.extension() == ".ntex")
+        {
+            CookedTextureHeader header;
+
+            if (bytes.size() < sizeof(header))
+            {
+                Logger::Warning("Cooked texture {} is truncated!", pathString);
+                return false;
+            }
+
+            std::memcpy(&header, bytes.data(), sizeof(header));
+
+            if (header.Magic != COOKED_TEXTURE_MAGIC || header.Version != COOKED_TEXTURE_VERSION)
+            {
+                Logger::Warning("{} is not a valid cooked texture!", pathString);
+                return false;
+            }
+
+            if (header.Width == 0 || header.Height == 0 || header.MipCount == 0 ||
+                header.MipCount > COOKED_TEXTURE_MAX_MIPS || header.Format > CookedTextureFormat::BC5 ||
+                bytes.size() < sizeof(header) + header.MipCount * sizeof(CookedTextureMip))
+            {
+                Logger::Warning("Cooked texture {} has an invalid header!", pathString);
+                return false;
+            }
+
+            Mips.resize(header.MipCount);
+            std::memcpy(Mips.data(), bytes.data() + sizeof(header), header.MipCount * sizeof(CookedTextureMip));
+
+            for (uint32_t level = 0; level < header.MipCount; ++level)
+            {
+                const CookedTextureMip& mip = Mips[level];
+
+                if (mip.Size != GetCookedMipSize(header.Format, mip.Width, mip.Height) ||
+                    mip.Offset > bytes.size() || mip.Size > bytes.size() - mip.Offset)
+                {
+                    Logger::Warning("Cooked texture {} has an invalid mip {}!", pathString, level);
+                    return false;
+                }
+            }
+
+            Width = header.Width;
+            Height = header.Height;
+            Format = header.Format;
+            Flags = header.Flags;
+            Source = bytes;
+
+            return true;
+        }
+
+        ImageCodecs::ImageInfo info;
+
+        if (ImageCodecs::GetInfo(bytes, info))
+        {
+            AllocateDecodedPixels(*this, info.Width, info.Height, info.Channels);
+
+            if (!ImageCodecs::Decode(bytes, info, Pixels.data(), GetCookedRowPitch(Format, Width)))
+            {
+                Logger::Warning("Failed to load texture: {}", pathString);
+                return false;
+            }
+
+            return true;
+        }
+
+        // Channels are left as they are in the file, expanding RGB and padding rows is done in one pass that is
+        // split over the job system for big images. The inflate itself can't be split, zlib streams have no
+        // restart points.
+        int width, height, channels;
+        uint8_t* data = stbi_load_from_memory(bytes.data(), (int) bytes.size(), &width, &height, &channels, 0);
 
         if (!data)
         {
@@ -39,37 +286,516 @@ namespace Nova
             return false;
         }
 
-        GLenum format;
+        // there's no point in keeping 3 channels on the GPU
+        const uint32_t storedChannels = (channels == 3) ? 4 : channels;
 
-        switch (m_Channels)
+        AllocateDecodedPixels(*this, width, height, storedChannels);
+        ImageCodecs::ConvertRows(data, (size_t) width * channels, channels, Pixels.data(),
+                                 GetCookedRowPitch(Format, Width), storedChannels, Width, Height);
+
+        stbi_image_free(data);
+
+        return true;
+    }
+
+    const uint8_t* TextureData::GetMipData(uint32_t level) const
+    {
+        return (Source.empty() ? Pixels.data() : Source.data()) + Mips[level].Offset;
+    }
+
+    TextureData TextureData::DecompressS3TC() const
+    {
+        TextureData result;
+        result.Width = Width;
+        result.Height = Height;
+        result.Format = CookedTextureFormat::RGBA8;
+        result.Flags = Flags;
+
+        std::vector<uint8_t> decoded;
+
+        for (uint32_t level = 0; level < Mips.size(); ++level)
         {
-        case 4:
-            format = GL_RGBA;
-            break;
-        case 3:
-            format = GL_RGB;
-            break;
-        default:
-            Logger::Warning("Texture {} is in an unsupported format!", pathString);
-            m_Width = m_Height = m_Channels = -1;
-            stbi_image_free(data);
+            const CookedTextureMip& mip = Mips[level];
+            DecodeS3TC(Format, GetMipData(level), mip.Width, mip.Height, decoded);
+
+            result.Mips.push_back({mip.Width, mip.Height, result.Pixels.size(), decoded.size()});
+            result.Pixels.insert(std::end(result.Pixels), std::begin(decoded), std::end(decoded));
+        }
+
+        return result;
+    }
+
+    bool TextureData::Palettize(std::vector<Color>& palette)
+    {
+        if (Format != CookedTextureFormat::RGBA8 || (Flags & CookedTextureFlags_Premultiplied))
+        {
+            Logger::Warning("Only straight alpha RGBA8 textures can be palettized!");
             return false;
         }
 
-        Init(format, data);
-        stbi_image_free(data);
+        std::vector<Color> colors = palette;
+        std::unordered_map<uint32_t, uint8_t> lookup;
+
+        for (size_t i = colors.size(); i-- > 0;)
+            lookup[std::bit_cast<uint32_t>(colors[i])] = (uint8_t) i;
+
+        std::vector<uint8_t> indices;
+        std::vector<CookedTextureMip> mips;
+
+        for (uint32_t level = 0; level < Mips.size(); ++level)
+        {
+            const CookedTextureMip& mip = Mips[level];
+            const uint8_t* src = GetMipData(level);
+            const size_t srcPitch = GetCookedRowPitch(CookedTextureFormat::RGBA8, mip.Width);
+            const size_t pitch = GetCookedRowPitch(CookedTextureFormat::R8, mip.Width);
+
+            mips.push_back({mip.Width, mip.Height, indices.size(), pitch * mip.Height});
+            indices.resize(indices.size() + pitch * mip.Height);
+
+            uint8_t* dst = indices.data() + mips.back().Offset;
+
+            for (uint32_t y = 0; y < mip.Height; ++y)
+            {
+                for (uint32_t x = 0; x < mip.Width; ++x)
+                {
+                    uint32_t key;
+                    std::memcpy(&key, src + y * srcPitch + x * 4, 4);
+
+                    auto [it, inserted] = lookup.try_emplace(key, (uint8_t) colors.size());
+
+                    if (inserted)
+                    {
+                        if (colors.size() == PALETTE_SIZE)
+                        {
+                            Logger::Warning("Texture has more than {} colors, it can't be palettized!", PALETTE_SIZE);
+                            return false;
+                        }
+
+                        colors.push_back(std::bit_cast<Color>(key));
+                    }
+
+                    dst[y * pitch + x] = it->second;
+                }
+            }
+        }
+
+        Format = CookedTextureFormat::R8;
+        Pixels = std::move(indices);
+        Mips = std::move(mips);
+        Source = {};
+        File.Close();
+
+        palette = std::move(colors);
 
         return true;
     }
 
+    bool Texture::Init(const std::filesystem::path& path)
+    {
+        if (m_ID)
+        {
+            Logger::Warning("Can't set texture twice on the same texture!");
+            return false;
+        }
+
+        TextureData data;
+
+        if (!data.Decode(path))
+            return false;
+
+        return Init(data);
+    }
+
     bool Texture::Init(uint32_t width, uint32_t height, const Color* data)
     {
         NOVA_ASSERT(data, "Cannot initialize texture with null data!");
 
+        if (m_ID)
+        {
+            Logger::Warning("Can't set texture twice on the same texture!");
+            return false;
+        }
+
         m_Width = width;
         m_Height = height;
+        m_Channels = 4;
+        m_Format = CookedTextureFormat::RGBA8;
+        m_MipCount = 1;
+        m_Premultiplied = false;
+
+        glGenTextures(1, &m_ID);
+        glBindTexture(GL_TEXTURE_2D, m_ID);
 
-        return Init(GL_RGBA, data);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        CheckOpenGLErrors();
+
+        return true;
+    }
+
+    bool Texture::Init(const TextureData& data)
+    {
+        if (!data.Mips.empty() && !IsFormatSupported(data.Format))
+        {
+            Logger::Warning("S3TC is not supported by the driver, decoding texture on the CPU");
+            return Init(data.DecompressS3TC());
+        }
+
+        if (!InitStorage(data))
+            return false;
+
+        Bind(0);
+
+        for (uint32_t level = 0; level < m_MipCount; ++level)
+        {
+            const uint32_t rows = IsCompressedFormat(m_Format) ? (data.Mips[level].Height + 3) / 4
+                                                               : data.Mips[level].Height;
+            UploadRows(level, 0, rows, data.GetMipData(level));
+        }
+
+        Unbind();
+
+        CheckOpenGLErrors();
+
+        return true;
+    }
+
+    bool Texture::InitStorage(const TextureData& data)
+    {
+        if (m_ID)
+        {
+            Logger::Warning("Can't set texture twice on the same texture!");
+            return false;
+        }
+
+        if (data.Mips.empty())
+        {
+            Logger::Warning("Cannot initialize texture with no data!");
+            return false;
+        }
+
+        NOVA_ASSERT(IsFormatSupported(data.Format), "Texture format is not supported by the driver!");
+
+        m_Width = (int) data.Width;
+        m_Height = (int) data.Height;
+        m_Channels = (int) GetFormatChannels(data.Format);
+        m_Format = data.Format;
+        m_MipCount = (uint32_t) data.Mips.size();
+        m_Premultiplied = data.Flags & CookedTextureFlags_Premultiplied;
+
+        glGenTextures(1, &m_ID);
+        glBindTexture(GL_TEXTURE_2D, m_ID);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint) m_MipCount - 1);
+
+        for (uint32_t level = 0; level < m_MipCount; ++level)
+        {
+            const CookedTextureMip& mip = data.Mips[level];
+            const GLsizei size = (GLsizei) mip.Size;
+
+            switch (m_Format)
+            {
+            case CookedTextureFormat::R8:
+                glTexImage2D(GL_TEXTURE_2D, level, GL_R8, mip.Width, mip.Height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+                break;
+            case CookedTextureFormat::RG8:
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RG8, mip.Width, mip.Height, 0, GL_RG, GL_UNSIGNED_BYTE, nullptr);
+                break;
+            case CookedTextureFormat::RGBA8:
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, mip.Width, mip.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                             nullptr);
+                break;
+            case CookedTextureFormat::BC4:
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RED_RGTC1, mip.Width, mip.Height, 0, size,
+                                       nullptr);
+                break;
+            case CookedTextureFormat::BC5:
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RG_RGTC2, mip.Width, mip.Height, 0, size,
+                                       nullptr);
+                break;
+            case CookedTextureFormat::BC1:
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, mip.Width, mip.Height,
+                                       0, size, nullptr);
+                break;
+            case CookedTextureFormat::BC3:
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, mip.Width, mip.Height,
+                                       0, size, nullptr);
+                break;
+            }
+        }
+
+        SetChannelSwizzle(m_Channels);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        SetFilter((data.Flags & CookedTextureFlags_Nearest) ? TextureFilter::Nearest : TextureFilter::Linear);
+
+        return true;
+    }
+
+    static GLenum GetUncompressedFormat(CookedTextureFormat format)
+    {
+        return (format == CookedTextureFormat::R8)    ? GL_RED
+               : (format == CookedTextureFormat::RG8) ? GL_RG
+                                                      : GL_RGBA;
+    }
+
+    static bool IsRectInside(const glm::uvec4& rect, int width, int height)
+    {
+        return rect.x <= (uint32_t) width && rect.z <= (uint32_t) width - rect.x && rect.y <= (uint32_t) height &&
+               rect.w <= (uint32_t) height - rect.y;
+    }
+
+    void Texture::UploadRows(uint32_t level, uint32_t firstRow, uint32_t rowCount, const void* pixels)
+    {
+        NOVA_ASSERT(level < m_MipCount, "Mip level out of range!");
+
+        const uint32_t width = std::max(1, m_Width >> level);
+        const uint32_t height = std::max(1, m_Height >> level);
+
+        glBindTexture(GL_TEXTURE_2D, m_ID);
+
+        if (!IsCompressedFormat(m_Format))
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, firstRow, width, rowCount, GetUncompressedFormat(m_Format),
+                            GL_UNSIGNED_BYTE, pixels);
+            return;
+        }
+
+        // block rows, the last one may cover less than 4 texel rows
+        const uint32_t y = firstRow * 4;
+        const uint32_t rows = std::min(rowCount * 4, height - y);
+        const GLsizei size = (GLsizei) (GetCookedRowPitch(m_Format, width) * rowCount);
+
+        GLenum format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+
+        switch (m_Format)
+        {
+        case CookedTextureFormat::BC3:
+            format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            break;
+        case CookedTextureFormat::BC4:
+            format = GL_COMPRESSED_RED_RGTC1;
+            break;
+        case CookedTextureFormat::BC5:
+            format = GL_COMPRESSED_RG_RGTC2;
+            break;
+        default:
+            break;
+        }
+
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, y, width, rows, format, size, pixels);
+    }
+
+    void Texture::UploadRegion(const glm::uvec4& rect, const void* pixels, uint32_t rowLength)
+    {
+        NOVA_ASSERT(!IsCompressedFormat(m_Format), "Regions of compressed textures can't be uploaded!");
+
+        glBindTexture(GL_TEXTURE_2D, m_ID);
+
+        // rows are tightly packed, unlike whole mips which are padded to 4 bytes
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint) rowLength);
+
+        glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x, rect.y, rect.z, rect.w, GetUncompressedFormat(m_Format),
+                        GL_UNSIGNED_BYTE, pixels);
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+
+    void Texture::GenerateMips()
+    {
+        if (m_MipCount <= 1)
+            return;
+
+        glBindTexture(GL_TEXTURE_2D, m_ID);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    void Texture::Update(const glm::uvec4& rect, const void* pixels)
+    {
+        if (!m_ID || IsCompressedFormat(m_Format))
+        {
+            Logger::Warning("Only uncompressed textures can be updated!");
+            return;
+        }
+
+        if (!IsRectInside(rect, m_Width, m_Height))
+        {
+            Logger::Warning("Texture update rect is out of bounds!");
+            return;
+        }
+
+        if (rect.z == 0 || rect.w == 0)
+            return;
+
+        // queued writes would land on top of the new pixels
+        if (m_QueuedWrites > 0)
+        {
+            Write(rect, pixels);
+            return;
+        }
+
+        // keep the CPU copy in sync, or the next flush would bring back the old pixels
+        if (!m_WriteBuffer.empty())
+        {
+            const size_t pitch = (size_t) rect.z * m_Channels;
+
+            for (uint32_t row = 0; row < rect.w; ++row)
+            {
+                std::memcpy(&m_WriteBuffer[(((size_t) rect.y + row) * m_Width + rect.x) * m_Channels],
+                            (const uint8_t*) pixels + row * pitch, pitch);
+            }
+        }
+
+        UploadRegion(rect, pixels);
+        GenerateMips();
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        CheckOpenGLErrors();
+    }
+
+    void Texture::Write(const glm::uvec4& rect, const void* pixels)
+    {
+        if (!m_ID || IsCompressedFormat(m_Format))
+        {
+            Logger::Warning("Only uncompressed textures can be written to!");
+            return;
+        }
+
+        if (!IsRectInside(rect, m_Width, m_Height))
+        {
+            Logger::Warning("Texture write rect is out of bounds!");
+            return;
+        }
+
+        if (rect.z == 0 || rect.w == 0)
+            return;
+
+        if (m_WriteBuffer.empty())
+        {
+            m_WriteBuffer.resize((size_t) m_Width * m_Height * m_Channels);
+
+            glBindTexture(GL_TEXTURE_2D, m_ID);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glGetTexImage(GL_TEXTURE_2D, 0, GetUncompressedFormat(m_Format), GL_UNSIGNED_BYTE, m_WriteBuffer.data());
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+
+        const size_t pitch = (size_t) rect.z * m_Channels;
+
+        for (uint32_t row = 0; row < rect.w; ++row)
+        {
+            std::memcpy(&m_WriteBuffer[(((size_t) rect.y + row) * m_Width + rect.x) * m_Channels],
+                        (const uint8_t*) pixels + row * pitch, pitch);
+        }
+
+        if (!HasPendingWrites())
+        {
+            m_DirtyRect = rect;
+            return;
+        }
+
+        const uint32_t minX = std::min(m_DirtyRect.x, rect.x);
+        const uint32_t minY = std::min(m_DirtyRect.y, rect.y);
+        const uint32_t maxX = std::max(m_DirtyRect.x + m_DirtyRect.z, rect.x + rect.z);
+        const uint32_t maxY = std::max(m_DirtyRect.y + m_DirtyRect.w, rect.y + rect.w);
+
+        m_DirtyRect = {minX, minY, maxX - minX, maxY - minY};
+    }
+
+    void Texture::FlushWrites()
+    {
+        if (!HasPendingWrites() || m_QueuedWrites > 0)
+            return;
+
+        const uint8_t* pixels = &m_WriteBuffer[((size_t) m_DirtyRect.y * m_Width + m_DirtyRect.x) * m_Channels];
+
+        // straight from the CPU copy, its rows are a whole texture row apart
+        UploadRegion(m_DirtyRect, pixels, m_Width);
+        GenerateMips();
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        m_DirtyRect = {0, 0, 0, 0};
+
+        CheckOpenGLErrors();
+    }
+
+    glm::uvec4 Texture::TakeWrites(std::vector<uint8_t>& pixels)
+    {
+        const glm::uvec4 rect = m_DirtyRect;
+        const size_t pitch = (size_t) rect.z * m_Channels;
+
+        pixels.resize(pitch * rect.w);
+
+        for (uint32_t row = 0; row < rect.w; ++row)
+        {
+            std::memcpy(pixels.data() + row * pitch,
+                        &m_WriteBuffer[(((size_t) rect.y + row) * m_Width + rect.x) * m_Channels], pitch);
+        }
+
+        m_DirtyRect = {0, 0, 0, 0};
+        ++m_QueuedWrites;
+
+        return rect;
+    }
+
+    void Texture::EndQueuedWrites()
+    {
+        if (m_QueuedWrites > 0)
+            --m_QueuedWrites;
+    }
+
+    uint64_t Texture::GetMemorySize() const
+    {
+        uint64_t size = 0;
+
+        for (uint32_t level = 0; level < m_MipCount; ++level)
+            size += GetCookedMipSize(m_Format, std::max(1, m_Width >> level), std::max(1, m_Height >> level));
+
+        return size;
+    }
+
+    bool Texture::IsFormatSupported(CookedTextureFormat format)
+    {
+        if (format == CookedTextureFormat::BC1 || format == CookedTextureFormat::BC3)
+            return IsS3TCSupported();
+
+        return true;
+    }
+
+    void Texture::SetPalette(std::shared_ptr<Texture> palette)
+    {
+        if (palette && m_Format != CookedTextureFormat::R8)
+        {
+            Logger::Warning("Only R8 textures can be indexed!");
+            return;
+        }
+
+        if (palette &&
+            (palette->m_Format != CookedTextureFormat::RGBA8 || (uint32_t) palette->GetWidth() != PALETTE_SIZE))
+        {
+            Logger::Warning("Palettes have to be {} wide RGBA8 textures!", PALETTE_SIZE);
+            return;
+        }
+
+        m_Palette = std::move(palette);
+
+        if (m_Palette)
+            SetFilter(TextureFilter::Nearest);
     }
 
     void Texture::SetFilter(TextureFilter filter)
@@ -84,7 +810,8 @@ namespace Nova
             m_Filter = filter;
             break;
         case TextureFilter::Linear:
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                            (m_MipCount > 1) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             m_Filter = filter;
             break;
@@ -113,29 +840,10 @@ namespace Nova
             glDeleteTextures(1, &m_ID);
             m_ID = 0;
         }
-    }
-
-    bool Texture::Init(int format, const void* data)
-    {
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-        glGenTextures(1, &m_ID);
-        glBindTexture(GL_TEXTURE_2D, m_ID);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        GLenum internalFormat = (format == GL_RGBA) ? GL_RGBA8 : GL_RGB8;
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Width, m_Height, 0, format, GL_UNSIGNED_BYTE, data);
-
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-
-        CheckOpenGLErrors();
-
-        return true;
+        m_Palette.reset();
+        m_WriteBuffer = {};
+        m_DirtyRect = {0, 0, 0, 0};
+        m_QueuedWrites = 0;
     }
 } // namespace Nova
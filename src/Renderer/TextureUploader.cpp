@@ -0,0 +1,332 @@
+#include "Nova/Renderer/TextureUploader.hpp"
+#include "Nova/Renderer/GLError.hpp"
+#include "Nova/Misc/Logger.hpp"
+
+#include <glad/glad.h>
+#include <glm/vec4.hpp>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace Nova::TextureUploader
+{
+    struct StagingBuffer
+    {
+        uint32_t ID = 0;
+        GLsync Fence = nullptr;
+    };
+
+    struct PendingUpload
+    {
+        std::shared_ptr<Texture> Target;
+        std::shared_ptr<const TextureData> Data;
+        UploadCallback OnDone;
+        uint32_t Level = 0;
+        uint32_t Row = 0;
+    };
+
+    // bounding rect of the writes to a texture, with its pixels as tightly packed rows
+    struct PendingWrite
+    {
+        std::shared_ptr<Texture> Target;
+        glm::uvec4 Rect;
+        std::vector<uint8_t> Pixels;
+        UploadCallback OnDone;
+        uint32_t Row = 0;
+    };
+
+    struct TextureUploaderData
+    {
+        bool Initialized = false;
+        uint32_t FrameBudget = DEFAULT_FRAME_BUDGET;
+        uint32_t StagingBufferSize = DEFAULT_STAGING_BUFFER_SIZE;
+        uint32_t NextBuffer = 0;
+        std::vector<StagingBuffer> StagingBuffers;
+        std::deque<PendingUpload> Uploads;
+        std::deque<PendingWrite> Writes;
+    };
+
+    static TextureUploaderData s_Data;
+
+    // rows of a mip as UploadRows counts them
+    static uint32_t GetUploadRowCount(const TextureData& data, uint32_t level)
+    {
+        const uint32_t height = data.Mips[level].Height;
+        return IsCompressedFormat(data.Format) ? (height + 3) / 4 : height;
+    }
+
+    // true when the GPU is done with the buffer, without waiting for it
+    static bool TryAcquire(StagingBuffer& buffer)
+    {
+        if (!buffer.Fence)
+            return true;
+
+        if (glClientWaitSync(buffer.Fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            return false;
+
+        glDeleteSync(buffer.Fence);
+        buffer.Fence = nullptr;
+
+        return true;
+    }
+
+    // Copies bytes of pixels into the next staging buffer and calls upload with the offset to hand to GL, or with
+    // pixels themselves when they don't fit or the buffer can't be mapped. False if every buffer is still in use.
+    template<typename UploadFn>
+    static bool Stage(const uint8_t* pixels, uint64_t bytes, UploadFn&& upload)
+    {
+        if (bytes > s_Data.StagingBufferSize)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            upload(pixels);
+            return true;
+        }
+
+        StagingBuffer& buffer = s_Data.StagingBuffers[s_Data.NextBuffer];
+
+        if (!TryAcquire(buffer))
+            return false;
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.ID);
+
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+        if (!mapped)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            upload(pixels);
+            return true;
+        }
+
+        std::memcpy(mapped, pixels, bytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        upload(nullptr);
+
+        buffer.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        s_Data.NextBuffer = (s_Data.NextBuffer + 1) % s_Data.StagingBuffers.size();
+
+        return true;
+    }
+
+    // uploads row bands of the pending writes, returns the budget left
+    static uint64_t UpdateWrites(uint64_t budget)
+    {
+        while (budget > 0 && !s_Data.Writes.empty())
+        {
+            PendingWrite& write = s_Data.Writes.front();
+
+            const uint64_t pitch = write.Pixels.size() / write.Rect.w;
+            const uint64_t bandBytes = std::min<uint64_t>(budget, s_Data.StagingBufferSize);
+            const uint32_t rows =
+                std::min<uint32_t>(write.Rect.w - write.Row, std::max<uint64_t>(1, bandBytes / pitch));
+            const uint64_t bytes = rows * pitch;
+            const glm::uvec4 band = {write.Rect.x, write.Rect.y + write.Row, write.Rect.z, rows};
+
+            const bool staged = Stage(write.Pixels.data() + write.Row * pitch, bytes, [&](const void* pixels) {
+                write.Target->UploadRegion(band, pixels);
+            });
+
+            if (!staged)
+                break;
+
+            budget -= std::min(budget, bytes);
+            write.Row += rows;
+
+            if (write.Row < write.Rect.w)
+                continue;
+
+            write.Target->GenerateMips();
+            write.Target->EndQueuedWrites();
+
+            UploadCallback onDone = std::move(write.OnDone);
+            s_Data.Writes.pop_front();
+
+            if (onDone)
+                onDone(true);
+        }
+
+        return budget;
+    }
+
+    void Init(uint32_t frameBudget, uint32_t stagingBufferSize, uint32_t stagingBufferCount)
+    {
+        if (s_Data.Initialized)
+            return;
+
+        Logger::Info("Initializing texture uploader ({} staging buffers of {} KiB)...", stagingBufferCount,
+                     stagingBufferSize / 1024);
+
+        s_Data.FrameBudget = frameBudget;
+        s_Data.StagingBufferSize = stagingBufferSize;
+        s_Data.NextBuffer = 0;
+        s_Data.StagingBuffers.resize(std::max(1u, stagingBufferCount));
+
+        for (StagingBuffer& buffer : s_Data.StagingBuffers)
+        {
+            glGenBuffers(1, &buffer.ID);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.ID);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, stagingBufferSize, nullptr, GL_STREAM_DRAW);
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        CheckOpenGLErrors();
+
+        s_Data.Initialized = true;
+    }
+
+    void Shutdown()
+    {
+        if (!s_Data.Initialized)
+            return;
+
+        s_Data.Uploads.clear();
+
+        for (PendingWrite& write : s_Data.Writes)
+            write.Target->EndQueuedWrites();
+
+        s_Data.Writes.clear();
+
+        for (StagingBuffer& buffer : s_Data.StagingBuffers)
+        {
+            if (buffer.Fence)
+                glDeleteSync(buffer.Fence);
+
+            glDeleteBuffers(1, &buffer.ID);
+        }
+
+        s_Data.StagingBuffers.clear();
+        s_Data.Initialized = false;
+    }
+
+    void SetFrameBudget(uint32_t bytes)
+    {
+        s_Data.FrameBudget = bytes;
+    }
+
+    uint32_t GetFrameBudget()
+    {
+        return s_Data.FrameBudget;
+    }
+
+    void Enqueue(std::shared_ptr<Texture> texture, std::shared_ptr<const TextureData> data, UploadCallback onDone)
+    {
+        if (!Texture::IsFormatSupported(data->Format))
+        {
+            Logger::Warning("S3TC is not supported by the driver, decoding texture on the CPU");
+            data = std::make_shared<TextureData>(data->DecompressS3TC());
+        }
+
+        if (!texture->InitStorage(*data))
+        {
+            if (onDone)
+                onDone(false);
+
+            return;
+        }
+
+        if (!s_Data.Initialized)
+        {
+            for (uint32_t level = 0; level < data->Mips.size(); ++level)
+                texture->UploadRows(level, 0, GetUploadRowCount(*data, level), data->GetMipData(level));
+
+            texture->Unbind();
+
+            if (onDone)
+                onDone(true);
+
+            return;
+        }
+
+        s_Data.Uploads.push_back({std::move(texture), std::move(data), std::move(onDone)});
+    }
+
+    void EnqueueWrites(std::shared_ptr<Texture> texture, UploadCallback onDone)
+    {
+        if (!texture->HasPendingWrites())
+        {
+            if (onDone)
+                onDone(true);
+
+            return;
+        }
+
+        if (!s_Data.Initialized)
+        {
+            texture->FlushWrites();
+
+            if (onDone)
+                onDone(true);
+
+            return;
+        }
+
+        PendingWrite write = {std::move(texture), {}, {}, std::move(onDone)};
+        write.Rect = write.Target->TakeWrites(write.Pixels);
+
+        s_Data.Writes.push_back(std::move(write));
+    }
+
+    void Update()
+    {
+        if (s_Data.Uploads.empty() && s_Data.Writes.empty())
+            return;
+
+        // writes are usually small and already on screen, they go first
+        uint64_t budget = UpdateWrites(s_Data.FrameBudget);
+
+        while (budget > 0 && !s_Data.Uploads.empty())
+        {
+            PendingUpload& upload = s_Data.Uploads.front();
+
+            const TextureData& data = *upload.Data;
+            const uint64_t pitch = GetCookedRowPitch(data.Format, data.Mips[upload.Level].Width);
+            const uint32_t rowCount = GetUploadRowCount(data, upload.Level);
+
+            // at least one row per band, even if it goes a bit over the budget
+            const uint64_t bandBytes = std::min<uint64_t>(budget, s_Data.StagingBufferSize);
+            const uint32_t rows = std::min<uint32_t>(rowCount - upload.Row, std::max<uint64_t>(1, bandBytes / pitch));
+            const uint64_t bytes = rows * pitch;
+            const uint8_t* pixels = data.GetMipData(upload.Level) + upload.Row * pitch;
+
+            const bool staged = Stage(pixels, bytes, [&](const void* source) {
+                upload.Target->UploadRows(upload.Level, upload.Row, rows, source);
+            });
+
+            // the GPU is still reading every staging buffer, try again next frame
+            if (!staged)
+                break;
+
+            budget -= std::min(budget, bytes);
+            upload.Row += rows;
+
+            if (upload.Row < rowCount)
+                continue;
+
+            upload.Row = 0;
+
+            if (++upload.Level < data.Mips.size())
+                continue;
+
+            UploadCallback onDone = std::move(upload.OnDone);
+            s_Data.Uploads.pop_front();
+
+            if (onDone)
+                onDone(true);
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        CheckOpenGLErrors();
+    }
+
+    uint32_t GetPendingUploadCount()
+    {
+        return (uint32_t) s_Data.Uploads.size();
+    }
+} // namespace Nova::TextureUploader
@@ -21,6 +21,9 @@ namespace Nova
         case ShaderDataType::Int3:      return 3;
         case ShaderDataType::Int4:      return 4;
         case ShaderDataType::Bool:      return 1;
+        case ShaderDataType::UByte4:    return 4;
+        case ShaderDataType::UShort2:   return 2;
+        case ShaderDataType::UShort4:   return 4;
         }
         // clang-format on
 
@@ -43,6 +46,9 @@ namespace Nova
         case ShaderDataType::Int3:      return 4 * 3;
         case ShaderDataType::Int4:      return 4 * 4;
         case ShaderDataType::Bool:      return 1;
+        case ShaderDataType::UByte4:    return 4;
+        case ShaderDataType::UShort2:   return 2 * 2;
+        case ShaderDataType::UShort4:   return 2 * 4;
         }
         // clang-format on
 
@@ -65,6 +71,9 @@ namespace Nova
         case ShaderDataType::Int3:      return GL_INT;
         case ShaderDataType::Int4:      return GL_INT;
         case ShaderDataType::Bool:      return GL_BOOL;
+        case ShaderDataType::UByte4:    return GL_UNSIGNED_BYTE;
+        case ShaderDataType::UShort2:   return GL_UNSIGNED_SHORT;
+        case ShaderDataType::UShort4:   return GL_UNSIGNED_SHORT;
         }
         // clang-format on
 
@@ -167,6 +176,21 @@ namespace Nova
                 glVertexAttribIPointer(index, count, type, stride, (const void*) offset);
                 offset += typeSize;
                 break;
+            case ShaderDataType::UByte4:
+            case ShaderDataType::UShort2:
+            case ShaderDataType::UShort4:
+                glEnableVertexAttribArray(index);
+
+                if (element.Normalized)
+                {
+                    glVertexAttribPointer(index, count, GetGLType(element.Type), GL_TRUE, stride,
+                                          (const void*) offset);
+                }
+                else
+                    glVertexAttribIPointer(index, count, GetGLType(element.Type), stride, (const void*) offset);
+
+                offset += typeSize;
+                break;
             case ShaderDataType::Mat3:
             case ShaderDataType::Mat4:
                 cols = count;
@@ -0,0 +1,522 @@
+#include "Nova/Renderer/VirtualTexture.hpp"
+#include "Nova/Renderer/GLError.hpp"
+
+#include "Nova/Core/JobSystem.hpp"
+#include "Nova/Misc/Logger.hpp"
+#include "Nova/Misc/MappedFile.hpp"
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include <glm/common.hpp>
+#include <glm/matrix.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace Nova
+{
+    // shared with the load jobs, which can outlive the texture
+    struct VirtualTextureStreamState
+    {
+        MappedFile File;
+        uint32_t TileSize = 0;
+        uint32_t LevelCount = 0;
+
+        std::mutex Mutex;
+        std::vector<std::pair<uint32_t, std::vector<uint8_t>>> Loaded;
+    };
+
+    static constexpr const char* s_VertexShaderSource =
+        "#version 330 core\n"
+        "layout (location = 0) in vec2 aCorner;\n"
+        "out vec2 TexCoords;\n"
+        "uniform mat4 uProjection;\n"
+        "uniform vec4 uRect;\n"
+        "void main()\n"
+        "{\n"
+        "    TexCoords = aCorner;\n"
+        "    gl_Position = uProjection * vec4(uRect.xy + aCorner * uRect.zw, 0.0, 1.0);\n"
+        "}\n";
+
+    // the indirection texel of the level 0 tile under the fragment holds the cache slot and the level of the
+    // finest resident tile covering it, the position inside that tile is the same at every level
+    static constexpr const char* s_FragmentShaderSource =
+        "#version 330 core\n"
+        "in vec2 TexCoords;\n"
+        "out vec4 FragColor;\n"
+        "uniform sampler2D uCache;\n"
+        "uniform sampler2D uIndirection;\n"
+        "uniform vec2 uSize;\n"
+        "uniform vec2 uCacheSize;\n"
+        "uniform float uTileSize;\n"
+        "uniform float uBorder;\n"
+        "uniform vec4 uColor;\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 position = clamp(TexCoords * uSize, vec2(0.0), uSize - 0.001);\n"
+        "    vec4 entry = floor(texelFetch(uIndirection, ivec2(position / uTileSize), 0) * 255.0 + 0.5);\n"
+        "    vec2 levelPosition = position / exp2(entry.b);\n"
+        "    vec2 local = levelPosition - floor(levelPosition / uTileSize) * uTileSize;\n"
+        "    vec2 cache = entry.rg * (uTileSize + 2.0 * uBorder) + uBorder + local;\n"
+        "    vec4 color = uColor * texture(uCache, cache / uCacheSize);\n"
+        "    if (color.a == 0.0) discard;\n"
+        "    FragColor = color;\n"
+        "}\n";
+
+    // triangle strip over the unit square
+    static constexpr float s_Corners[] = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f};
+
+    static std::vector<uint8_t> ReadTile(const VirtualTextureStreamState& stream, uint32_t tile)
+    {
+        const uint32_t size = GetTiledTextureTileBytes(stream.TileSize);
+        const uint8_t* source =
+            stream.File.GetData() + GetTiledTextureTileOffset(stream.LevelCount, stream.TileSize, tile);
+
+        // touching the mapping is what reads the tile from disk
+        return std::vector<uint8_t>(source, source + size);
+    }
+
+    VirtualTexture::~VirtualTexture()
+    {
+        Shutdown();
+    }
+
+    bool VirtualTexture::Init(const std::filesystem::path& path, const VirtualTextureConfig& config)
+    {
+        Shutdown();
+
+        const std::string pathString = path.string();
+        auto stream = std::make_shared<VirtualTextureStreamState>();
+
+        if (!stream->File.Open(path))
+        {
+            Logger::Warning("Failed to open virtual texture {}!", pathString);
+            return false;
+        }
+
+        std::span<const uint8_t> bytes = stream->File.GetSpan();
+        TiledTextureHeader header;
+
+        if (bytes.size() < sizeof(header))
+        {
+            Logger::Warning("{} is not a valid tiled texture!", pathString);
+            return false;
+        }
+
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        if (header.Magic != TILED_TEXTURE_MAGIC || header.Version != TILED_TEXTURE_VERSION)
+        {
+            Logger::Warning("{} is not a valid tiled texture!", pathString);
+            return false;
+        }
+
+        if (header.Width == 0 || header.Height == 0 || header.TileSize == 0 || header.LevelCount == 0 ||
+            header.LevelCount > TILED_TEXTURE_MAX_LEVELS ||
+            bytes.size() < sizeof(header) + header.LevelCount * sizeof(TiledTextureLevel))
+        {
+            Logger::Warning("Tiled texture {} has an invalid header!", pathString);
+            return false;
+        }
+
+        std::vector<TiledTextureLevel> levels(header.LevelCount);
+        std::memcpy(levels.data(), bytes.data() + sizeof(header), header.LevelCount * sizeof(TiledTextureLevel));
+
+        uint32_t tileCount = 0;
+
+        for (uint32_t level = 0; level < header.LevelCount; ++level)
+        {
+            const TiledTextureLevel& info = levels[level];
+
+            if (info.FirstTile != tileCount || info.TilesX != (info.Width + header.TileSize - 1) / header.TileSize ||
+                info.TilesY != (info.Height + header.TileSize - 1) / header.TileSize ||
+                info.Width != ((header.Width - 1) >> level) + 1 || info.Height != ((header.Height - 1) >> level) + 1)
+            {
+                Logger::Warning("Tiled texture {} has an invalid level {}!", pathString, level);
+                return false;
+            }
+
+            tileCount += info.TilesX * info.TilesY;
+        }
+
+        if (levels.back().TilesX != 1 || levels.back().TilesY != 1 ||
+            bytes.size() < GetTiledTextureTileOffset(header.LevelCount, header.TileSize, tileCount))
+        {
+            Logger::Warning("Tiled texture {} is truncated!", pathString);
+            return false;
+        }
+
+        GLint maxTextureSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+
+        const uint32_t slotSize = header.TileSize + 2 * TILED_TEXTURE_BORDER;
+        const uint32_t cacheTiles = std::min({config.CacheTiles, (uint32_t) maxTextureSize / slotSize, 256u});
+
+        if (cacheTiles == 0 || levels[0].TilesX > (uint32_t) maxTextureSize ||
+            levels[0].TilesY > (uint32_t) maxTextureSize)
+        {
+            Logger::Warning("Tiled texture {} doesn't fit in a tile cache!", pathString);
+            return false;
+        }
+
+        if (!m_Shader.Init(s_VertexShaderSource, s_FragmentShaderSource))
+        {
+            Logger::Warning("Failed to create the virtual texture shader!");
+            return false;
+        }
+
+        stream->TileSize = header.TileSize;
+        stream->LevelCount = header.LevelCount;
+
+        m_Config = config;
+        m_Width = header.Width;
+        m_Height = header.Height;
+        m_TileSize = header.TileSize;
+        m_Levels = std::move(levels);
+        m_Stream = std::move(stream);
+        m_Tiles.assign(tileCount, {});
+        m_Slots.assign(cacheTiles * cacheTiles, {});
+        m_CacheTiles = cacheTiles;
+        m_ResidentTiles = 0;
+        m_PendingLoads = 0;
+        m_Frame = 0;
+        m_Level = 0;
+        m_RequestedLevel = UINT32_MAX;
+        m_VisibleRects.clear();
+        m_Indirection.assign(m_Levels[0].TilesX * m_Levels[0].TilesY * 4, 0);
+
+        glGenTextures(1, &m_CacheTexture);
+        glBindTexture(GL_TEXTURE_2D, m_CacheTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, cacheTiles * slotSize, cacheTiles * slotSize, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, nullptr);
+
+        glGenTextures(1, &m_IndirectionTexture);
+        glBindTexture(GL_TEXTURE_2D, m_IndirectionTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Levels[0].TilesX, m_Levels[0].TilesY, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glGenBuffers(1, &m_CornerBuffer);
+        glGenVertexArrays(1, &m_VertexArray);
+
+        glBindVertexArray(m_VertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, m_CornerBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(s_Corners), s_Corners, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_Shader.Bind();
+        m_Shader.SetUniformInt("uCache", 0);
+        m_Shader.SetUniformInt("uIndirection", 1);
+        m_Shader.SetUniformFloat2("uSize", GetSize());
+        m_Shader.SetUniformFloat2("uCacheSize", glm::vec2((float) (cacheTiles * slotSize)));
+        m_Shader.SetUniformFloat("uTileSize", (float) m_TileSize);
+        m_Shader.SetUniformFloat("uBorder", (float) TILED_TEXTURE_BORDER);
+        m_Shader.Unbind();
+
+        // the single tile of the coarsest level is always resident, so every texel has something to show
+        const uint32_t coarsest = m_Levels.back().FirstTile;
+        UploadTile(coarsest, 0, ReadTile(*m_Stream, coarsest).data());
+
+        Update();
+
+        CheckOpenGLErrors();
+        return true;
+    }
+
+    void VirtualTexture::Shutdown()
+    {
+        if (!IsInitialized())
+            return;
+
+        glDeleteTextures(1, &m_CacheTexture);
+        glDeleteTextures(1, &m_IndirectionTexture);
+        glDeleteVertexArrays(1, &m_VertexArray);
+        glDeleteBuffers(1, &m_CornerBuffer);
+
+        m_CacheTexture = 0;
+        m_IndirectionTexture = 0;
+        m_VertexArray = 0;
+        m_CornerBuffer = 0;
+
+        // jobs still running keep their own reference to the stream
+        m_Stream.reset();
+        m_Levels.clear();
+        m_Tiles.clear();
+        m_Slots.clear();
+        m_Indirection.clear();
+        m_VisibleRects.clear();
+
+        m_Shader.Shutdown();
+    }
+
+    void VirtualTexture::Update()
+    {
+        if (!IsInitialized())
+            return;
+
+        ++m_Frame;
+
+        if (m_RequestedLevel != UINT32_MAX && m_RequestedLevel != m_Level)
+        {
+            m_Level = m_RequestedLevel;
+
+            for (uint32_t y = 0; y < m_Levels[0].TilesY; ++y)
+                for (uint32_t x = 0; x < m_Levels[0].TilesX; ++x)
+                    RefreshEntry(x, y);
+        }
+
+        for (const glm::vec4& rect : m_VisibleRects)
+            RequestTiles(rect);
+
+        m_VisibleRects.clear();
+        m_RequestedLevel = UINT32_MAX;
+
+        std::vector<std::pair<uint32_t, std::vector<uint8_t>>> loaded;
+
+        {
+            std::lock_guard lock(m_Stream->Mutex);
+
+            const size_t count = std::min<size_t>(m_Stream->Loaded.size(), m_Config.UploadsPerFrame);
+            auto end = m_Stream->Loaded.begin() + count;
+
+            loaded.assign(std::make_move_iterator(m_Stream->Loaded.begin()), std::make_move_iterator(end));
+            m_Stream->Loaded.erase(m_Stream->Loaded.begin(), end);
+        }
+
+        for (auto& [tile, pixels] : loaded)
+        {
+            m_Tiles[tile].Pending = false;
+            --m_PendingLoads;
+
+            // when every slot is in use this frame the tile is dropped, it'll be requested again
+            const int32_t slot = FindFreeSlot();
+
+            if (slot < 0)
+                continue;
+
+            EvictSlot(slot);
+            UploadTile(tile, slot, pixels.data());
+        }
+
+        if (m_IndirectionDirty)
+        {
+            glBindTexture(GL_TEXTURE_2D, m_IndirectionTexture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Levels[0].TilesX, m_Levels[0].TilesY, GL_RGBA,
+                            GL_UNSIGNED_BYTE, m_Indirection.data());
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            m_IndirectionDirty = false;
+        }
+
+        CheckOpenGLErrors();
+    }
+
+    void VirtualTexture::Draw(const glm::mat4& projection, const glm::vec2& position, const glm::vec2& scale,
+                              const Color& color)
+    {
+        if (!IsInitialized())
+            return;
+
+        const glm::vec2 size = GetSize() * scale;
+
+        // the part of the quad inside the view, in level 0 texels
+        const glm::mat4 inverse = glm::inverse(projection);
+        const glm::vec4 a = inverse * glm::vec4(-1.0f, -1.0f, 0.0f, 1.0f);
+        const glm::vec4 b = inverse * glm::vec4(1.0f, 1.0f, 0.0f, 1.0f);
+        const glm::vec2 viewMin = {std::min(a.x, b.x), std::min(a.y, b.y)};
+        const glm::vec2 viewMax = {std::max(a.x, b.x), std::max(a.y, b.y)};
+
+        const glm::vec2 quadMin = glm::min(position, position + size);
+        const glm::vec2 quadMax = glm::max(position, position + size);
+        const glm::vec2 visibleMin = glm::max(viewMin, quadMin);
+        const glm::vec2 visibleMax = glm::min(viewMax, quadMax);
+
+        if (visibleMin.x >= visibleMax.x || visibleMin.y >= visibleMax.y)
+            return;
+
+        const glm::vec2 texelMin = (visibleMin - position) / scale;
+        const glm::vec2 texelMax = (visibleMax - position) / scale;
+        m_VisibleRects.emplace_back(glm::min(texelMin, texelMax), glm::max(texelMin, texelMax));
+
+        // one level per halving of the on screen size
+        const float texelsPerPixel = 1.0f / std::max(std::min(std::abs(scale.x), std::abs(scale.y)), 1e-6f);
+        const uint32_t level = (uint32_t) std::clamp(std::floor(std::log2(texelsPerPixel)), 0.0f,
+                                                     (float) (m_Levels.size() - 1));
+        m_RequestedLevel = std::min(m_RequestedLevel, level);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_CacheTexture);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, m_IndirectionTexture);
+
+        m_Shader.Bind();
+        m_Shader.SetUniformMat4("uProjection", projection);
+        m_Shader.SetUniformFloat4("uRect", {position, size});
+        m_Shader.SetUniformFloat4("uColor", glm::vec4(color.r, color.g, color.b, color.a) / 255.0f);
+
+        glBindVertexArray(m_VertexArray);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glBindVertexArray(0);
+
+        m_Shader.Unbind();
+
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    void VirtualTexture::RequestTiles(const glm::vec4& rect)
+    {
+        const TiledTextureLevel& level = m_Levels[m_Level];
+        const float tileSize = (float) (m_TileSize << m_Level);
+
+        const uint32_t minX = (uint32_t) std::max(rect.x / tileSize, 0.0f);
+        const uint32_t minY = (uint32_t) std::max(rect.y / tileSize, 0.0f);
+        const uint32_t maxX = std::min((uint32_t) std::max(std::ceil(rect.z / tileSize), 0.0f), level.TilesX);
+        const uint32_t maxY = std::min((uint32_t) std::max(std::ceil(rect.w / tileSize), 0.0f), level.TilesY);
+
+        for (uint32_t y = minY; y < maxY; ++y)
+        {
+            for (uint32_t x = minX; x < maxX; ++x)
+            {
+                const uint32_t tile = level.FirstTile + y * level.TilesX + x;
+                TileState& state = m_Tiles[tile];
+
+                if (state.Slot >= 0)
+                {
+                    m_Slots[state.Slot].LastUsed = m_Frame;
+                    continue;
+                }
+
+                if (state.Pending || m_PendingLoads >= m_Config.MaxPendingLoads)
+                    continue;
+
+                state.Pending = true;
+                ++m_PendingLoads;
+
+                JobSystem::Submit([stream = m_Stream, tile]() {
+                    std::vector<uint8_t> pixels = ReadTile(*stream, tile);
+
+                    std::lock_guard lock(stream->Mutex);
+                    stream->Loaded.emplace_back(tile, std::move(pixels));
+                });
+            }
+        }
+    }
+
+    void VirtualTexture::UploadTile(uint32_t tile, int32_t slot, const uint8_t* pixels)
+    {
+        const uint32_t slotSize = m_TileSize + 2 * TILED_TEXTURE_BORDER;
+
+        glBindTexture(GL_TEXTURE_2D, m_CacheTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % m_CacheTiles) * slotSize, (slot / m_CacheTiles) * slotSize, slotSize,
+                        slotSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        m_Slots[slot] = {tile, m_Frame};
+        m_Tiles[tile].Slot = slot;
+        ++m_ResidentTiles;
+
+        RefreshFootprint(tile);
+    }
+
+    int32_t VirtualTexture::FindFreeSlot() const
+    {
+        const uint32_t coarsest = m_Levels.back().FirstTile;
+        int32_t best = -1;
+
+        for (int32_t slot = 0; slot < (int32_t) m_Slots.size(); ++slot)
+        {
+            const CacheSlot& candidate = m_Slots[slot];
+
+            if (candidate.Tile == UINT32_MAX)
+                return slot;
+
+            if (candidate.Tile == coarsest || candidate.LastUsed >= m_Frame)
+                continue;
+
+            if (best < 0 || candidate.LastUsed < m_Slots[best].LastUsed)
+                best = slot;
+        }
+
+        return best;
+    }
+
+    void VirtualTexture::EvictSlot(int32_t slot)
+    {
+        const uint32_t tile = m_Slots[slot].Tile;
+
+        if (tile == UINT32_MAX)
+            return;
+
+        m_Slots[slot] = {};
+        m_Tiles[tile].Slot = -1;
+        --m_ResidentTiles;
+
+        RefreshFootprint(tile);
+    }
+
+    uint32_t VirtualTexture::GetTileLevel(uint32_t tile) const
+    {
+        uint32_t level = 0;
+
+        while (level + 1 < m_Levels.size() && m_Levels[level + 1].FirstTile <= tile)
+            ++level;
+
+        return level;
+    }
+
+    void VirtualTexture::RefreshFootprint(uint32_t tile)
+    {
+        const uint32_t level = GetTileLevel(tile);
+
+        // tiles finer than the current level are never picked
+        if (level < m_Level)
+            return;
+
+        const TiledTextureLevel& info = m_Levels[level];
+        const uint32_t index = tile - info.FirstTile;
+        const uint32_t tileX = index % info.TilesX;
+        const uint32_t tileY = index / info.TilesX;
+
+        const uint32_t maxX = std::min((tileX + 1) << level, m_Levels[0].TilesX);
+        const uint32_t maxY = std::min((tileY + 1) << level, m_Levels[0].TilesY);
+
+        for (uint32_t y = tileY << level; y < maxY; ++y)
+            for (uint32_t x = tileX << level; x < maxX; ++x)
+                RefreshEntry(x, y);
+    }
+
+    void VirtualTexture::RefreshEntry(uint32_t x, uint32_t y)
+    {
+        for (uint32_t level = m_Level; level < m_Levels.size(); ++level)
+        {
+            const TiledTextureLevel& info = m_Levels[level];
+            const int32_t slot = m_Tiles[info.FirstTile + (y >> level) * info.TilesX + (x >> level)].Slot;
+
+            if (slot < 0)
+                continue;
+
+            uint8_t* entry = &m_Indirection[(y * m_Levels[0].TilesX + x) * 4];
+            entry[0] = (uint8_t) (slot % m_CacheTiles);
+            entry[1] = (uint8_t) (slot / m_CacheTiles);
+            entry[2] = (uint8_t) level;
+            entry[3] = 255;
+
+            m_IndirectionDirty = true;
+            return;
+        }
+    }
+} // namespace Nova
@@ -1,15 +1,40 @@
 #include "Nova/Scene/Scene.hpp"
 #include "Nova/ECS/Entity.hpp"
+#include "Nova/ECS/Components.hpp"
 #include "Nova/Core/App.hpp"
 #include "Nova/Misc/Metrics.hpp"
 
 namespace Nova
 {
+    static void InvalidateRenderCache(entt::registry& registry, entt::entity entity)
+    {
+        if (auto* cache = registry.try_get<RenderCacheComponent>(entity))
+            cache->Dirty = true;
+    }
+
+    template<typename Component>
+    static void ConnectRenderCache(entt::registry& registry)
+    {
+        registry.on_construct<Component>().template connect<&InvalidateRenderCache>();
+        registry.on_update<Component>().template connect<&InvalidateRenderCache>();
+    }
+
     Scene::Scene()
         : m_Window(App::Get().GetWindow()), m_SceneManager(App::Get().GetSceneManager()),
-          m_AssetManager(App::Get().GetAssetManager()), m_SpriteSystem(this),
+          m_AssetManager(App::Get().GetAssetManager()), m_SpriteSystem(this), m_ParticleSystem(this),
+          m_TransformSystem(this), m_SpatialSystem(this), m_PhysicsSystem(this),
           m_RendererSystem(std::make_unique<RendererSystem>(this))
     {
+        m_Scheduler.Add(&m_SpriteSystem);
+        m_Scheduler.Add(&m_ParticleSystem);
+
+        ConnectRenderCache<QuadTransform>(m_Registry);
+        ConnectRenderCache<ColorComponent>(m_Registry);
+        ConnectRenderCache<TextureComponent>(m_Registry);
+
+        m_TransformSystem.Connect();
+        m_SpatialSystem.Connect();
+        m_PhysicsSystem.Connect();
     }
 
     Entity Scene::CreateEntity()
@@ -55,9 +80,11 @@ namespace Nova
 
     void Scene::UpdateSystems(float deltaTime)
     {
-        m_SpriteSystem.Update(deltaTime);
+        m_Scheduler.Run(m_Registry, deltaTime);
 
-        for (const auto& system : m_Systems)
-            system->Update(deltaTime);
+        // after the systems that move the entities, before they're drawn
+        m_PhysicsSystem.Update(deltaTime);
+        m_TransformSystem.Update(deltaTime);
+        m_SpatialSystem.Update(deltaTime);
     }
 } // namespace Nova
@@ -0,0 +1,318 @@
+/*
+    nova_assetstress
+
+    Hammers the lock-free AssetManager lookups (FindTexture, FindShader) from several threads while the main thread
+    keeps changing the tables under them: sync and async loads, loads of missing files (which release their slot for
+    the next load to reuse), cancelled loads and evictions from a small texture budget, with an Update every
+    iteration. Lookups of the assets loaded up front must always return them, lookups of the others may miss but must
+    never return a different asset. Exits with 1 on any wrong result.
+
+    Usage: nova_assetstress [--threads count] [--seconds time] [--workers count]
+
+    --threads count     threads doing lookups (4 by default)
+    --seconds time      how long to run (5 by default)
+    --workers count     job system workers for the async loads (one per core by default)
+
+    Built with -fsanitize=thread (e.g. cmake -DCMAKE_CXX_FLAGS="-fsanitize=thread -g" and the same linker flags), it
+    also catches the snapshots being freed while a lookup still reads them.
+*/
+
+#include <Nova/Asset/AssetManager.hpp>
+#include <Nova/Core/JobSystem.hpp>
+#include <Nova/Core/Window.hpp>
+#include <Nova/Misc/Logger.hpp>
+#include <Nova/Renderer/ImageCodecs.hpp>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <fmt/core.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// loaded up front, looked up by the threads and never released
+static constexpr uint32_t STABLE_TEXTURES = 16;
+static constexpr uint32_t STABLE_SHADERS = 4;
+
+// files cycled through by the churn, their width tells them apart
+static constexpr uint32_t CHURN_FILES = 8;
+
+// fits a few churn textures, so Update keeps evicting
+static constexpr uint64_t TEXTURE_BUDGET = 64 << 10;
+
+static constexpr std::string_view FRAGMENT_SOURCE = "#version 330 core\n"
+                                                    "out vec4 color;\n"
+                                                    "void main() { color = vec4(1.0); }\n";
+
+struct Failures
+{
+    std::atomic<uint64_t> Lookups = 0;
+    std::atomic<uint64_t> Missing = 0;    // stable asset not found
+    std::atomic<uint64_t> Mismatched = 0; // found a different asset
+};
+
+static uint32_t GetChurnWidth(uint32_t file)
+{
+    return 8 + file * 4;
+}
+
+// distinct pixels for every file, so the manager doesn't share them as duplicates
+static bool WriteTexture(const fs::path& path, uint32_t width, uint32_t seed)
+{
+    std::vector<uint8_t> pixels((size_t) width * width * 4);
+
+    for (size_t i = 0; i < pixels.size(); ++i)
+        pixels[i] = (uint8_t) (i * 31 + seed * 97);
+
+    const std::vector<uint8_t> qoi = Nova::ImageCodecs::EncodeQOI(pixels.data(), width, width, 4);
+
+    std::ofstream file(path, std::ios::binary);
+    file.write((const char*) qoi.data(), (std::streamsize) qoi.size());
+
+    return file.good();
+}
+
+static std::string GetChurnName(uint64_t iteration)
+{
+    return fmt::format("churn_{}", iteration);
+}
+
+static void RunLookups(const Nova::AssetManager& assets, const std::vector<Nova::TextureAsset>& textures,
+                       const std::vector<Nova::ShaderAsset>& shaders, const std::atomic<uint64_t>& churnCount,
+                       const std::atomic<bool>& running, Failures& failures, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    uint64_t lookups = 0;
+
+    while (running.load(std::memory_order_relaxed))
+    {
+        const uint32_t i = random() % STABLE_TEXTURES;
+        const std::string name = fmt::format("stable_{}", i);
+
+        for (const Nova::TextureAsset& found : {assets.FindTexture(name), assets.FindTexture(Nova::AssetID(name))})
+        {
+            if (!found)
+                failures.Missing.fetch_add(1);
+            else if (found.Get() != textures[i].Get() || found->GetWidth() != textures[i]->GetWidth())
+                failures.Mismatched.fetch_add(1);
+        }
+
+        const uint32_t j = random() % STABLE_SHADERS;
+        const std::string shaderName = fmt::format("shader_{}", j);
+
+        for (const Nova::ShaderAsset& found :
+             {assets.FindShader(shaderName), assets.FindShader(Nova::AssetID(shaderName))})
+        {
+            if (!found)
+                failures.Missing.fetch_add(1);
+            else if (found.Get() != shaders[j].Get())
+                failures.Mismatched.fetch_add(1);
+        }
+
+        // churn assets come and go, but a hit has to be the file the name was loaded from
+        if (const uint64_t count = churnCount.load(std::memory_order_relaxed); count > 0)
+        {
+            const uint64_t iteration = random() % count;
+            const Nova::TextureAsset found = assets.FindTexture(GetChurnName(iteration));
+
+            if (found && (uint32_t) found->GetWidth() != GetChurnWidth(iteration % CHURN_FILES))
+                failures.Mismatched.fetch_add(1);
+        }
+
+        lookups += 5;
+    }
+
+    failures.Lookups.fetch_add(lookups);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t threads = 4;
+    float seconds = 5.0f;
+    int workers = -1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "--threads" && i + 1 < argc)
+            threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seconds" && i + 1 < argc)
+            seconds = std::max(0.1f, (float) std::atof(argv[++i]));
+        else if (arg == "--workers" && i + 1 < argc)
+            workers = std::max(1, std::atoi(argv[++i]));
+        else
+        {
+            fmt::print("Usage: {} [--threads count] [--seconds time] [--workers count]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // every load and eviction logs otherwise
+    Nova::Logger::SetMinimumLogLevel(Nova::Logger::Level::Error);
+
+    const fs::path directory = fs::temp_directory_path() / "nova_assetstress";
+    fs::create_directories(directory);
+
+    bool written = true;
+
+    for (uint32_t i = 0; i < STABLE_TEXTURES; ++i)
+        written &= WriteTexture(directory / fmt::format("stable_{}.qoi", i), 16, i);
+
+    for (uint32_t i = 0; i < CHURN_FILES; ++i)
+        written &= WriteTexture(directory / fmt::format("churn_{}.qoi", i), GetChurnWidth(i), STABLE_TEXTURES + i);
+
+    for (uint32_t i = 0; i < STABLE_SHADERS; ++i)
+    {
+        // a comment keeps the contents apart
+        std::ofstream file(directory / fmt::format("shader_{}.frag", i));
+        file << FRAGMENT_SOURCE << "// " << i << "\n";
+        written &= file.good();
+    }
+
+    if (!written)
+    {
+        fmt::print("Failed to write the test assets to {}\n", directory.string());
+        return 1;
+    }
+
+    if (!glfwInit())
+    {
+        fmt::print("Failed to initialize GLFW\n");
+        return 1;
+    }
+
+    Nova::Window window;
+    window.Init({.Flags = Nova::WindowFlags_None, .Width = 320, .Height = 240, .Title = "nova_assetstress"});
+
+    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress))
+    {
+        fmt::print("Failed to initialize GLAD\n");
+        return 1;
+    }
+
+    Nova::JobSystem::Init(workers < 0 ? 0 : workers);
+
+    int exitCode = 0;
+
+    {
+        Nova::AssetManager assets;
+        assets.SetMemoryBudget(Nova::AssetType::Texture, TEXTURE_BUDGET);
+
+        // kept here, so they're never evicted
+        std::vector<Nova::TextureAsset> textures;
+        std::vector<Nova::ShaderAsset> shaders;
+
+        for (uint32_t i = 0; i < STABLE_TEXTURES; ++i)
+        {
+            const std::string name = fmt::format("stable_{}", i);
+            assets.LoadTexture(name, directory / (name + ".qoi"));
+            textures.push_back(assets.GetTexture(name));
+        }
+
+        for (uint32_t i = 0; i < STABLE_SHADERS; ++i)
+        {
+            const std::string name = fmt::format("shader_{}", i);
+            assets.LoadShader(name, directory / (name + ".frag"));
+            shaders.push_back(assets.GetShader(name));
+        }
+
+        const auto isLoaded = [](const auto& handle) {
+            return (bool) handle;
+        };
+
+        const bool loaded = std::all_of(std::begin(textures), std::end(textures), isLoaded) &&
+                            std::all_of(std::begin(shaders), std::end(shaders), isLoaded);
+
+        if (!loaded)
+        {
+            fmt::print("Failed to load the test assets\n");
+            exitCode = 1;
+        }
+        else
+        {
+            Failures failures;
+            std::atomic<uint64_t> churnCount = 0;
+            std::atomic<bool> running = true;
+            std::vector<std::thread> readers;
+
+            for (uint32_t i = 0; i < threads; ++i)
+            {
+                readers.emplace_back(RunLookups, std::cref(assets), std::cref(textures), std::cref(shaders),
+                                     std::cref(churnCount), std::cref(running), std::ref(failures), i + 1);
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            const auto duration = std::chrono::duration<float>(seconds);
+            uint64_t iteration = 0;
+
+            while (std::chrono::steady_clock::now() - start < duration)
+            {
+                const std::string name = GetChurnName(iteration);
+                const fs::path path = directory / fmt::format("churn_{}.qoi", iteration % CHURN_FILES);
+
+                switch (iteration % 5)
+                {
+                case 0:
+                    assets.LoadTexture(name, path);
+                    break;
+                case 1:
+                case 2:
+                    assets.LoadTextureAsync(name, path);
+                    break;
+                case 3:
+                    // cancelled before or after decoding, either way the slot is released
+                    assets.LoadTextureAsync(name, path).Cancel();
+                    break;
+                default:
+                    // fails to read, released right away
+                    assets.LoadTexture(name, directory / "missing.qoi");
+                    assets.LoadTextureAsync(name + "_async", directory / "missing.qoi");
+                    break;
+                }
+
+                churnCount.store(++iteration, std::memory_order_relaxed);
+
+                assets.Update();
+                glfwPollEvents();
+            }
+
+            running.store(false);
+
+            for (std::thread& reader : readers)
+                reader.join();
+
+            // the loads still in flight
+            while (assets.GetPendingLoadCount() > 0)
+                assets.Update();
+
+            fmt::print("main thread iterations: {}\n", iteration);
+            fmt::print("lookups:                {}\n", failures.Lookups.load());
+            fmt::print("missing stable assets:  {}\n", failures.Missing.load());
+            fmt::print("mismatched assets:      {}\n", failures.Mismatched.load());
+
+            if (failures.Missing > 0 || failures.Mismatched > 0)
+                exitCode = 1;
+        }
+
+        assets.Shutdown();
+    }
+
+    Nova::JobSystem::Shutdown();
+    window.Shutdown();
+    glfwTerminate();
+
+    fs::remove_all(directory);
+
+    return exitCode;
+}
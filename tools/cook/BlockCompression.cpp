@@ -0,0 +1,237 @@
+#include "BlockCompression.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace NovaCook
+{
+    static uint16_t PackRGB565(const float color[3])
+    {
+        auto quantize = [](float value, int max) {
+            return (uint16_t) std::clamp((int) (value * max / 255.0f + 0.5f), 0, max);
+        };
+
+        return (uint16_t) ((quantize(color[0], 31) << 11) | (quantize(color[1], 63) << 5) | quantize(color[2], 31));
+    }
+
+    static void UnpackRGB565(uint16_t c, int out[3])
+    {
+        out[0] = ((c >> 11) & 31) * 255 / 31;
+        out[1] = ((c >> 5) & 63) * 255 / 63;
+        out[2] = (c & 31) * 255 / 31;
+    }
+
+    void EncodeBC1Block(const uint8_t texels[16][4], uint8_t* out)
+    {
+        // pick the endpoints as the texels that project furthest along the bounding box diagonal
+        int minColor[3] = {255, 255, 255};
+        int maxColor[3] = {0, 0, 0};
+
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int ch = 0; ch < 3; ++ch)
+            {
+                minColor[ch] = std::min(minColor[ch], (int) texels[i][ch]);
+                maxColor[ch] = std::max(maxColor[ch], (int) texels[i][ch]);
+            }
+        }
+
+        int axis[3] = {maxColor[0] - minColor[0], maxColor[1] - minColor[1], maxColor[2] - minColor[2]};
+        int minDot = INT32_MAX, maxDot = INT32_MIN;
+        int minIndex = 0, maxIndex = 0;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            int dot = texels[i][0] * axis[0] + texels[i][1] * axis[1] + texels[i][2] * axis[2];
+
+            if (dot < minDot)
+            {
+                minDot = dot;
+                minIndex = i;
+            }
+
+            if (dot > maxDot)
+            {
+                maxDot = dot;
+                maxIndex = i;
+            }
+        }
+
+        const float end0[3] = {(float) texels[maxIndex][0], (float) texels[maxIndex][1], (float) texels[maxIndex][2]};
+        const float end1[3] = {(float) texels[minIndex][0], (float) texels[minIndex][1], (float) texels[minIndex][2]};
+
+        uint16_t c0 = PackRGB565(end0);
+        uint16_t c1 = PackRGB565(end1);
+
+        // four color mode needs c0 > c1
+        if (c0 < c1)
+            std::swap(c0, c1);
+
+        uint32_t indices = 0;
+
+        if (c0 != c1)
+        {
+            int palette[4][3];
+            UnpackRGB565(c0, palette[0]);
+            UnpackRGB565(c1, palette[1]);
+
+            for (int ch = 0; ch < 3; ++ch)
+            {
+                palette[2][ch] = (2 * palette[0][ch] + palette[1][ch]) / 3;
+                palette[3][ch] = (palette[0][ch] + 2 * palette[1][ch]) / 3;
+            }
+
+            for (int i = 0; i < 16; ++i)
+            {
+                int best = 0, bestError = INT32_MAX;
+
+                for (int p = 0; p < 4; ++p)
+                {
+                    int dr = texels[i][0] - palette[p][0];
+                    int dg = texels[i][1] - palette[p][1];
+                    int db = texels[i][2] - palette[p][2];
+                    int error = dr * dr + dg * dg + db * db;
+
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+
+                indices |= (uint32_t) best << (2 * i);
+            }
+        }
+
+        std::memcpy(out, &c0, 2);
+        std::memcpy(out + 2, &c1, 2);
+        std::memcpy(out + 4, &indices, 4);
+    }
+
+    void EncodeBC4Block(const uint8_t values[16], uint8_t* out)
+    {
+        uint8_t minValue = 255, maxValue = 0;
+
+        for (int i = 0; i < 16; ++i)
+        {
+            minValue = std::min(minValue, values[i]);
+            maxValue = std::max(maxValue, values[i]);
+        }
+
+        // eight value mode (a0 > a1), when the block is flat every index points at a0
+        uint8_t palette[8] = {maxValue, minValue};
+
+        for (int i = 1; i < 7; ++i)
+            palette[i + 1] = (uint8_t) (((7 - i) * maxValue + i * minValue) / 7);
+
+        uint64_t indices = 0;
+
+        if (maxValue != minValue)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                int best = 0, bestError = INT32_MAX;
+
+                for (int p = 0; p < 8; ++p)
+                {
+                    int error = std::abs((int) values[i] - (int) palette[p]);
+
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+
+                indices |= (uint64_t) best << (3 * i);
+            }
+        }
+
+        out[0] = maxValue;
+        out[1] = minValue;
+
+        for (int i = 0; i < 6; ++i)
+            out[2 + i] = (uint8_t) (indices >> (8 * i));
+    }
+
+    void EncodeBC3Block(const uint8_t texels[16][4], uint8_t* out)
+    {
+        uint8_t alpha[16];
+
+        for (int i = 0; i < 16; ++i)
+            alpha[i] = texels[i][3];
+
+        EncodeBC4Block(alpha, out);
+        EncodeBC1Block(texels, out + 8);
+    }
+
+    void CompressImage(Nova::CookedTextureFormat format, const uint8_t* pixels, uint32_t width, uint32_t height,
+                       uint32_t channels, std::vector<uint8_t>& out)
+    {
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+
+        out.resize(Nova::GetCookedMipSize(format, width, height));
+
+        uint8_t* block = out.data();
+
+        for (uint32_t by = 0; by < blocksY; ++by)
+        {
+            for (uint32_t bx = 0; bx < blocksX; ++bx)
+            {
+                uint8_t texels[16][4] = {};
+
+                for (uint32_t y = 0; y < 4; ++y)
+                {
+                    for (uint32_t x = 0; x < 4; ++x)
+                    {
+                        uint32_t px = std::min(bx * 4 + x, width - 1);
+                        uint32_t py = std::min(by * 4 + y, height - 1);
+
+                        std::memcpy(texels[y * 4 + x], pixels + ((size_t) py * width + px) * channels, channels);
+                    }
+                }
+
+                switch (format)
+                {
+                case Nova::CookedTextureFormat::BC1:
+                    EncodeBC1Block(texels, block);
+                    block += 8;
+                    break;
+                case Nova::CookedTextureFormat::BC3:
+                    EncodeBC3Block(texels, block);
+                    block += 16;
+                    break;
+                case Nova::CookedTextureFormat::BC4: {
+                    uint8_t values[16];
+
+                    for (int i = 0; i < 16; ++i)
+                        values[i] = texels[i][0];
+
+                    EncodeBC4Block(values, block);
+                    block += 8;
+                    break;
+                }
+                case Nova::CookedTextureFormat::BC5: {
+                    uint8_t red[16], green[16];
+
+                    for (int i = 0; i < 16; ++i)
+                    {
+                        red[i] = texels[i][0];
+                        green[i] = texels[i][1];
+                    }
+
+                    EncodeBC4Block(red, block);
+                    EncodeBC4Block(green, block + 8);
+                    block += 16;
+                    break;
+                }
+                default:
+                    return;
+                }
+            }
+        }
+    }
+} // namespace NovaCook
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Nova/Renderer/CookedTexture.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace NovaCook
+{
+    // Fast range-fit encoders, quality is close to the usual "fast" modes of offline compressors.
+    void EncodeBC1Block(const uint8_t texels[16][4], uint8_t* out);
+    void EncodeBC3Block(const uint8_t texels[16][4], uint8_t* out);
+    void EncodeBC4Block(const uint8_t values[16], uint8_t* out);
+
+    // Compresses a tightly packed image with 1 (BC4), 2 (BC5) or 4 (BC1/BC3) channels into 4x4 blocks,
+    // edge blocks repeat the last row/column.
+    void CompressImage(Nova::CookedTextureFormat format, const uint8_t* pixels, uint32_t width, uint32_t height,
+                       uint32_t channels, std::vector<uint8_t>& out);
+} // namespace NovaCook
@@ -0,0 +1,298 @@
+/*
+    nova_cook
+
+    Cooks every image of a directory (recursively) into a .ntex file next to it (see Nova/Renderer/CookedTexture.hpp),
+    so textures are uploaded straight from a file mapping at load time instead of being decoded.
+    Cooked files that are newer than their source are skipped.
+
+    Usage: nova_cook [directory] [--premultiply] [--compress] [--no-mips] [--nearest] [--force]
+
+    --premultiply   store color premultiplied by alpha (mips are filtered after premultiplying)
+    --compress      store BC1/BC3 (color), BC4 (grayscale) or BC5 (grayscale + alpha) blocks
+    --no-mips       only store the full resolution image
+    --nearest       mark the texture for nearest filtering
+    --force         cook even if the cooked file is up to date
+*/
+
+#include "BlockCompression.hpp"
+
+#include <Nova/Renderer/CookedTexture.hpp>
+
+#include <fmt/core.h>
+#include <stb_image.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct CookOptions
+{
+    bool Premultiply = false;
+    bool Compress = false;
+    bool Mips = true;
+    bool Nearest = false;
+    bool Force = false;
+};
+
+struct Image
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    std::vector<uint8_t> Pixels; // tightly packed
+};
+
+static bool IsImage(const fs::path& path)
+{
+    auto ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) {
+        return (char) std::tolower((unsigned char) c);
+    });
+
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".tga";
+}
+
+// 2x2 box filter, odd sizes repeat the last row/column
+static Image Downsample(const Image& src, uint32_t channels)
+{
+    Image dst;
+    dst.Width = std::max(1u, src.Width / 2);
+    dst.Height = std::max(1u, src.Height / 2);
+    dst.Pixels.resize((size_t) dst.Width * dst.Height * channels);
+
+    for (uint32_t y = 0; y < dst.Height; ++y)
+    {
+        for (uint32_t x = 0; x < dst.Width; ++x)
+        {
+            uint32_t x0 = std::min(x * 2, src.Width - 1), x1 = std::min(x * 2 + 1, src.Width - 1);
+            uint32_t y0 = std::min(y * 2, src.Height - 1), y1 = std::min(y * 2 + 1, src.Height - 1);
+
+            for (uint32_t ch = 0; ch < channels; ++ch)
+            {
+                auto at = [&](uint32_t sx, uint32_t sy) {
+                    return (uint32_t) src.Pixels[((size_t) sy * src.Width + sx) * channels + ch];
+                };
+
+                uint32_t sum = at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1);
+                dst.Pixels[((size_t) y * dst.Width + x) * channels + ch] = (uint8_t) ((sum + 2) / 4);
+            }
+        }
+    }
+
+    return dst;
+}
+
+// copies rows into 4 byte aligned rows, so they can be uploaded with the default unpack alignment
+static std::vector<uint8_t> PadRows(const Image& image, Nova::CookedTextureFormat format, uint32_t channels)
+{
+    const size_t rowBytes = (size_t) image.Width * channels;
+    const size_t pitch = Nova::GetCookedRowPitch(format, image.Width);
+
+    std::vector<uint8_t> out(pitch * image.Height, 0);
+
+    for (uint32_t y = 0; y < image.Height; ++y)
+        std::memcpy(out.data() + y * pitch, image.Pixels.data() + y * rowBytes, rowBytes);
+
+    return out;
+}
+
+static bool Cook(const fs::path& source, const fs::path& destination, const CookOptions& options)
+{
+    int width, height, channels;
+    uint8_t* data = stbi_load(source.string().c_str(), &width, &height, &channels, 0);
+
+    if (!data)
+    {
+        fmt::print("  failed to decode {}: {}\n", source.string(), stbi_failure_reason());
+        return false;
+    }
+
+    // there's no 3 channel format on the GPU side worth keeping, expand to RGBA
+    const uint32_t storedChannels = (channels == 3) ? 4 : (uint32_t) channels;
+
+    Image level;
+    level.Width = (uint32_t) width;
+    level.Height = (uint32_t) height;
+    level.Pixels.resize((size_t) width * height * storedChannels);
+
+    for (size_t i = 0; i < (size_t) width * height; ++i)
+    {
+        std::memcpy(&level.Pixels[i * storedChannels], &data[i * channels], channels);
+
+        if (channels == 3)
+            level.Pixels[i * 4 + 3] = 255;
+    }
+
+    stbi_image_free(data);
+
+    const bool hasAlpha = storedChannels == 2 || storedChannels == 4;
+    bool opaque = true;
+
+    if (hasAlpha)
+    {
+        for (size_t i = storedChannels - 1; i < level.Pixels.size(); i += storedChannels)
+            opaque = opaque && level.Pixels[i] == 255;
+    }
+
+    const bool premultiply = options.Premultiply && hasAlpha && !opaque;
+
+    if (premultiply)
+    {
+        for (size_t i = 0; i < level.Pixels.size(); i += storedChannels)
+        {
+            const uint32_t alpha = level.Pixels[i + storedChannels - 1];
+
+            for (uint32_t ch = 0; ch < storedChannels - 1; ++ch)
+                level.Pixels[i + ch] = (uint8_t) ((level.Pixels[i + ch] * alpha + 127) / 255);
+        }
+    }
+
+    Nova::CookedTextureFormat format;
+
+    switch (storedChannels)
+    {
+    case 1:
+        format = options.Compress ? Nova::CookedTextureFormat::BC4 : Nova::CookedTextureFormat::R8;
+        break;
+    case 2:
+        format = options.Compress ? Nova::CookedTextureFormat::BC5 : Nova::CookedTextureFormat::RG8;
+        break;
+    default:
+        if (options.Compress)
+            format = opaque ? Nova::CookedTextureFormat::BC1 : Nova::CookedTextureFormat::BC3;
+        else
+            format = Nova::CookedTextureFormat::RGBA8;
+    }
+
+    const uint32_t mipCount = options.Mips ? Nova::GetFullMipCount(level.Width, level.Height) : 1;
+
+    Nova::CookedTextureHeader header = {
+        .Magic = Nova::COOKED_TEXTURE_MAGIC,
+        .Version = Nova::COOKED_TEXTURE_VERSION,
+        .Width = level.Width,
+        .Height = level.Height,
+        .Format = format,
+        .Flags = Nova::CookedTextureFlags_None,
+        .MipCount = (uint16_t) mipCount,
+    };
+
+    if (premultiply)
+        header.Flags |= Nova::CookedTextureFlags_Premultiplied;
+
+    if (options.Nearest)
+        header.Flags |= Nova::CookedTextureFlags_Nearest;
+
+    std::vector<Nova::CookedTextureMip> mips(mipCount);
+    std::vector<std::vector<uint8_t>> mipData(mipCount);
+
+    // mip data starts 16 byte aligned, right after the mip table
+    uint64_t offset = sizeof(header) + mipCount * sizeof(Nova::CookedTextureMip);
+
+    for (uint32_t i = 0; i < mipCount; ++i)
+    {
+        if (i > 0)
+            level = Downsample(level, storedChannels);
+
+        if (Nova::IsCompressedFormat(format))
+            NovaCook::CompressImage(format, level.Pixels.data(), level.Width, level.Height, storedChannels, mipData[i]);
+        else
+            mipData[i] = PadRows(level, format, storedChannels);
+
+        offset = (offset + 15) & ~uint64_t(15);
+        mips[i] = {level.Width, level.Height, offset, mipData[i].size()};
+        offset += mipData[i].size();
+    }
+
+    std::ofstream out(destination, std::ios::binary | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        fmt::print("  failed to open {} for writing\n", destination.string());
+        return false;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(mips.data()), mips.size() * sizeof(Nova::CookedTextureMip));
+
+    for (uint32_t i = 0; i < mipCount; ++i)
+    {
+        static constexpr char padding[16] = {};
+
+        out.write(padding, (std::streamsize) (mips[i].Offset - (uint64_t) out.tellp()));
+        out.write(reinterpret_cast<const char*>(mipData[i].data()), mipData[i].size());
+    }
+
+    static constexpr const char* formatNames[] = {"R8", "RG8", "RGBA8", "BC1", "BC3", "BC4", "BC5"};
+
+    fmt::print("  {} -> {} ({}x{} {}, {} mips{}, {} KiB)\n", source.string(), destination.filename().string(),
+               header.Width, header.Height, formatNames[(int) format], mipCount,
+               premultiply ? ", premultiplied" : "", offset / 1024);
+
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    fs::path directory = "assets";
+    CookOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "--premultiply")
+            options.Premultiply = true;
+        else if (arg == "--compress")
+            options.Compress = true;
+        else if (arg == "--no-mips")
+            options.Mips = false;
+        else if (arg == "--nearest")
+            options.Nearest = true;
+        else if (arg == "--force")
+            options.Force = true;
+        else if (arg.starts_with("--"))
+        {
+            fmt::print("Usage: {} [directory] [--premultiply] [--compress] [--no-mips] [--nearest] [--force]\n",
+                       argv[0]);
+            return 1;
+        }
+        else
+            directory = arg;
+    }
+
+    if (!fs::is_directory(directory))
+    {
+        fmt::print("{} is not a directory\n", directory.string());
+        return 1;
+    }
+
+    uint32_t cooked = 0, skipped = 0, failed = 0;
+
+    for (const auto& entry : fs::recursive_directory_iterator(directory))
+    {
+        if (!entry.is_regular_file() || !IsImage(entry.path()))
+            continue;
+
+        fs::path destination = fs::path(entry.path()).replace_extension(".ntex");
+
+        if (!options.Force && fs::exists(destination) &&
+            fs::last_write_time(destination) >= fs::last_write_time(entry.path()))
+        {
+            ++skipped;
+            continue;
+        }
+
+        if (Cook(entry.path(), destination, options))
+            ++cooked;
+        else
+            ++failed;
+    }
+
+    fmt::print("Cooked {} textures ({} up to date, {} failed)\n", cooked, skipped, failed);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+/*
+    nova_imagebench
+
+    Times image decoding on every image of a directory (recursively): plain stb_image, the engine loader
+    (TextureData::Decode, which converts big images on the job system and handles QOI/TGA/PNM itself) and the
+    engine loader on the same image re-encoded as QOI in memory.
+
+    Usage: nova_imagebench [directory] [--iterations count] [--workers count]
+
+    --iterations count  decodes per image and loader, the average is reported (5 by default)
+    --workers count     job system workers, 0 runs everything on the main thread (one per core by default)
+*/
+
+#include <Nova/Core/JobSystem.hpp>
+#include <Nova/Renderer/ImageCodecs.hpp>
+#include <Nova/Renderer/Texture.hpp>
+
+#include <fmt/core.h>
+#include <stb_image.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct LoaderStats
+{
+    double Milliseconds = 0.0;
+    uint64_t Pixels = 0;
+};
+
+static bool IsImage(const fs::path& path)
+{
+    auto ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) {
+        return (char) std::tolower((unsigned char) c);
+    });
+
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".tga" || ext == ".qoi" ||
+           ext == ".ppm" || ext == ".pgm";
+}
+
+static bool ReadFile(const fs::path& path, std::vector<uint8_t>& data)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+        return false;
+
+    data.resize(fs::file_size(path));
+    return (bool) file.read((char*) data.data(), data.size());
+}
+
+// average milliseconds of decode over iterations, negative if it failed
+template<typename Fn>
+static double Time(uint32_t iterations, Fn&& decode)
+{
+    double total = 0.0;
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        if (!decode())
+            return -1.0;
+
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return total / iterations;
+}
+
+static void Record(LoaderStats& stats, double ms, uint64_t pixels)
+{
+    if (ms < 0.0)
+        return;
+
+    stats.Milliseconds += ms;
+    stats.Pixels += pixels;
+}
+
+static std::string FormatTime(double ms)
+{
+    return (ms < 0.0) ? "-" : fmt::format("{:.2f}", ms);
+}
+
+static void PrintThroughput(std::string_view loader, const LoaderStats& stats)
+{
+    if (stats.Milliseconds <= 0.0)
+        return;
+
+    fmt::print("{:<12} {:>10.2f} ms {:>10.1f} MPixel/s\n", loader, stats.Milliseconds,
+               stats.Pixels / (stats.Milliseconds * 1000.0));
+}
+
+int main(int argc, char** argv)
+{
+    fs::path directory = "assets";
+    uint32_t iterations = 5;
+    int workers = -1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "--iterations" && i + 1 < argc)
+            iterations = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--workers" && i + 1 < argc)
+            workers = std::max(0, std::atoi(argv[++i]));
+        else if (arg.starts_with("-"))
+        {
+            fmt::print("Usage: {} [directory] [--iterations count] [--workers count]\n", argv[0]);
+            return 1;
+        }
+        else
+            directory = arg;
+    }
+
+    if (!fs::is_directory(directory))
+    {
+        fmt::print("{} is not a directory\n", directory.string());
+        return 1;
+    }
+
+    if (workers != 0)
+        Nova::JobSystem::Init(workers < 0 ? 0 : workers);
+
+    fmt::print("{:<40} {:>11} {:>10} {:>10} {:>10}\n", "image", "size", "stb ms", "nova ms", "qoi ms");
+
+    LoaderStats stbStats, novaStats, qoiStats;
+
+    for (const auto& entry : fs::recursive_directory_iterator(directory))
+    {
+        const fs::path& path = entry.path();
+
+        if (!entry.is_regular_file() || !IsImage(path))
+            continue;
+
+        std::vector<uint8_t> bytes;
+
+        if (!ReadFile(path, bytes))
+        {
+            fmt::print("  failed to read {}\n", path.string());
+            continue;
+        }
+
+        const double stbMs = Time(iterations, [&] {
+            int width, height, channels;
+            uint8_t* pixels =
+                stbi_load_from_memory(bytes.data(), (int) bytes.size(), &width, &height, &channels, 0);
+
+            stbi_image_free(pixels);
+            return pixels != nullptr;
+        });
+
+        // the same pixels re-encoded as QOI, grayscale images have no QOI equivalent
+        std::vector<uint8_t> qoi;
+        int width, height, channels;
+
+        if (uint8_t* pixels = stbi_load_from_memory(bytes.data(), (int) bytes.size(), &width, &height, &channels, 0))
+        {
+            if (channels >= 3)
+                qoi = Nova::ImageCodecs::EncodeQOI(pixels, width, height, channels);
+
+            stbi_image_free(pixels);
+        }
+
+        Nova::TextureData data;
+
+        const double novaMs = Time(iterations, [&] {
+            return data.Decode(bytes, path);
+        });
+
+        const double qoiMs = qoi.empty() ? -1.0 : Time(iterations, [&] {
+            return data.Decode(qoi, fs::path(path).replace_extension(".qoi"));
+        });
+
+        const uint64_t pixels = (uint64_t) data.Width * data.Height;
+
+        Record(stbStats, stbMs, pixels);
+        Record(novaStats, novaMs, pixels);
+        Record(qoiStats, qoiMs, pixels);
+
+        fmt::print("{:<40} {:>5}x{:<5} {:>10} {:>10} {:>10}\n", path.lexically_relative(directory).generic_string(),
+                   data.Width, data.Height, FormatTime(stbMs), FormatTime(novaMs), FormatTime(qoiMs));
+    }
+
+    fmt::print("\n");
+    PrintThroughput("stb_image", stbStats);
+    PrintThroughput("nova", novaStats);
+    PrintThroughput("nova (qoi)", qoiStats);
+
+    Nova::JobSystem::Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+/*
+    nova_pak
+
+    Packs every file of an asset directory (recursively) into a single .novapak archive (see Nova/Asset/AssetPak.hpp),
+    which AssetManager::LoadFromDirectory reads instead of the directory when it sits next to it.
+    Source images with a cooked .ntex sibling are left out, like the directory loader does.
+
+    Usage: nova_pak [directory] [-o output] [--compress]
+
+    -o output       archive to write, <directory>.novapak by default
+    --compress      LZ4 compress the entries that shrink by at least 10%, the others stay zero-copy
+*/
+
+#include <Nova/Asset/AssetPak.hpp>
+#include <Nova/Misc/Hash.hpp>
+#include <Nova/Misc/LZ4.hpp>
+
+#include <fmt/core.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct PakFile
+{
+    std::string Name;
+    std::vector<uint8_t> Data; // as stored
+    Nova::AssetPakEntry Entry = {};
+};
+
+static bool IsImage(const fs::path& path)
+{
+    auto ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) {
+        return (char) std::tolower((unsigned char) c);
+    });
+
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".tga";
+}
+
+static bool ReadFile(const fs::path& path, std::vector<uint8_t>& data)
+{
+    std::ifstream in(path, std::ios::binary);
+
+    if (!in.is_open())
+        return false;
+
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    fs::path directory = "assets";
+    fs::path output;
+    bool compress = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "--compress")
+            compress = true;
+        else if (arg == "-o" && i + 1 < argc)
+            output = argv[++i];
+        else if (arg.starts_with("-"))
+        {
+            fmt::print("Usage: {} [directory] [-o output] [--compress]\n", argv[0]);
+            return 1;
+        }
+        else
+            directory = arg;
+    }
+
+    directory = directory.lexically_normal();
+
+    if (!directory.has_filename())
+        directory = directory.parent_path();
+
+    if (!fs::is_directory(directory))
+    {
+        fmt::print("{} is not a directory\n", directory.string());
+        return 1;
+    }
+
+    if (output.empty())
+        output = fs::path(directory.string() + ".novapak");
+
+    std::vector<PakFile> files;
+    uint64_t totalSize = 0;
+
+    for (const auto& entry : fs::recursive_directory_iterator(directory))
+    {
+        const fs::path& path = entry.path();
+
+        if (!entry.is_regular_file() || path.extension() == ".novapak")
+            continue;
+
+        if (IsImage(path) && fs::exists(fs::path(path).replace_extension(".ntex")))
+            continue;
+
+        PakFile file;
+        file.Name = path.lexically_relative(directory).generic_string();
+
+        if (!ReadFile(path, file.Data))
+        {
+            fmt::print("  failed to read {}\n", path.string());
+            return 1;
+        }
+
+        file.Entry.NameHash = Nova::HashFNV1a(std::string_view(file.Name));
+        file.Entry.Size = file.Data.size();
+        file.Entry.Compression = Nova::AssetPakCompression::None;
+
+        if (compress && !file.Data.empty())
+        {
+            std::vector<uint8_t> compressed(Nova::LZ4::GetMaxCompressedSize(file.Data.size()));
+            compressed.resize(Nova::LZ4::Compress(file.Data, compressed));
+
+            if (compressed.size() * 10 <= file.Data.size() * 9)
+            {
+                file.Data = std::move(compressed);
+                file.Entry.Compression = Nova::AssetPakCompression::LZ4;
+            }
+        }
+
+        file.Entry.StoredSize = file.Data.size();
+        totalSize += file.Entry.Size;
+
+        files.push_back(std::move(file));
+    }
+
+    std::sort(files.begin(), files.end(), [](const PakFile& a, const PakFile& b) {
+        return a.Entry.NameHash < b.Entry.NameHash;
+    });
+
+    for (size_t i = 1; i < files.size(); ++i)
+    {
+        if (files[i].Entry.NameHash == files[i - 1].Entry.NameHash)
+        {
+            fmt::print("{} and {} have the same name hash, rename one of them\n", files[i - 1].Name, files[i].Name);
+            return 1;
+        }
+    }
+
+    std::string names;
+
+    for (PakFile& file : files)
+    {
+        file.Entry.NameOffset = (uint32_t) names.size();
+        file.Entry.NameLength = (uint16_t) file.Name.size();
+        names += file.Name;
+    }
+
+    Nova::AssetPakHeader header = {
+        .Magic = Nova::ASSET_PAK_MAGIC,
+        .Version = Nova::ASSET_PAK_VERSION,
+        .EntryCount = (uint32_t) files.size(),
+        .NamesSize = (uint32_t) names.size(),
+    };
+
+    // entry data starts 16 byte aligned, so cooked textures keep the alignment of their mips
+    uint64_t offset = sizeof(header) + files.size() * sizeof(Nova::AssetPakEntry) + names.size();
+
+    for (PakFile& file : files)
+    {
+        offset = (offset + 15) & ~uint64_t(15);
+        file.Entry.Offset = offset;
+        offset += file.Data.size();
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        fmt::print("failed to open {} for writing\n", output.string());
+        return 1;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const PakFile& file : files)
+        out.write(reinterpret_cast<const char*>(&file.Entry), sizeof(file.Entry));
+
+    out.write(names.data(), (std::streamsize) names.size());
+
+    for (const PakFile& file : files)
+    {
+        static constexpr char padding[16] = {};
+
+        out.write(padding, (std::streamsize) (file.Entry.Offset - (uint64_t) out.tellp()));
+        out.write(reinterpret_cast<const char*>(file.Data.data()), (std::streamsize) file.Data.size());
+
+        fmt::print("  {} ({} KiB{})\n", file.Name, file.Entry.Size / 1024,
+                   file.Entry.Compression == Nova::AssetPakCompression::LZ4 ? ", lz4" : "");
+    }
+
+    fmt::print("Packed {} files into {} ({} KiB -> {} KiB)\n", files.size(), output.string(), totalSize / 1024,
+               offset / 1024);
+
+    return 0;
+}
@@ -0,0 +1,342 @@
+/*
+    nova_physicsbench
+
+    Simulates stacks of boxes, a pyramid and a rain of circles and triangles on a static ground with the PhysicsWorld
+    and times the steps, once on the main thread and once on the job system. Checks that the stacks and the pyramid
+    stand where they were built, that everything falls asleep, that both runs end with exactly the same transforms,
+    and that destroying a body wakes what rested on it and hands its ID to the next body created. Exits with 1 on any
+    failed check.
+
+    Usage: nova_physicsbench [--stacks count] [--height boxes] [--frames count] [--workers count]
+
+    --stacks count      stacks of boxes (20 by default)
+    --height boxes      boxes per stack, also the rows of the pyramid (10 by default)
+    --frames count      frames of 1/60 s simulated, long enough for everything to fall asleep (600 by default)
+    --workers count     job system workers of the second run (one per core by default)
+*/
+
+#include <Nova/Core/JobSystem.hpp>
+#include <Nova/Physics/PhysicsWorld.hpp>
+
+#include <fmt/core.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+static constexpr float GROUND_TOP = 600.0f;
+static constexpr float BOX_HALF_SIZE = 16.0f;
+static constexpr float BRICK_HALF_SIZE = 10.0f;
+
+// some settling, on top of the LinearSlop every body rests into the one below
+static constexpr float POSITION_TOLERANCE = 1.0f;
+static constexpr float ANGLE_TOLERANCE = 0.01f;
+
+struct Timer
+{
+    std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+    double Elapsed() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+    }
+};
+
+struct Playground
+{
+    Nova::PhysicsWorld World;
+    std::vector<Nova::PhysicsBodyID> Stacks; // bottom to top, one stack after the other
+    std::vector<Nova::PhysicsBodyID> Pyramid; // top row last
+    std::vector<Nova::PhysicsBodyID> Rain;
+};
+
+struct RunResult
+{
+    std::vector<Nova::PhysicsTransform> Transforms;
+    double StepTime = 0.0;
+    uint32_t Steps = 0;
+    uint32_t Failures = 0;
+};
+
+static float GetStackX(uint32_t stack)
+{
+    return stack * 100.0f;
+}
+
+// small gaps between the boxes, so they start apart and have to settle onto each other
+static void Build(Playground& scene, uint32_t stacks, uint32_t height)
+{
+    Nova::PhysicsWorld& world = scene.World;
+    const float width = GetStackX(stacks) + height * 50.0f + stacks * 50.0f + 1000.0f;
+
+    world.CreateBody({
+        .Type = Nova::PhysicsBodyType::Static,
+        .Shape = Nova::PhysicsShape::MakeBox({width, 20.0f}),
+        .Transform = {{width * 0.5f - 200.0f, GROUND_TOP + 20.0f}, 0.0f},
+    });
+
+    for (uint32_t stack = 0; stack < stacks; ++stack)
+    {
+        for (uint32_t i = 0; i < height; ++i)
+        {
+            const float y = GROUND_TOP - BOX_HALF_SIZE - i * (BOX_HALF_SIZE * 2.0f + 0.5f);
+
+            scene.Stacks.push_back(world.CreateBody({
+                .Shape = Nova::PhysicsShape::MakeBox({BOX_HALF_SIZE, BOX_HALF_SIZE}),
+                .Transform = {{GetStackX(stack), y}, 0.0f},
+            }));
+        }
+    }
+
+    const float pyramidX = GetStackX(stacks) + height * 25.0f;
+
+    for (uint32_t row = 0; row < height; ++row)
+    {
+        const uint32_t count = height - row;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const glm::vec2 position = {pyramidX + (i - (count - 1) * 0.5f) * (BRICK_HALF_SIZE * 2.0f + 1.0f),
+                                        GROUND_TOP - BRICK_HALF_SIZE - row * (BRICK_HALF_SIZE * 2.0f + 0.5f)};
+
+            scene.Pyramid.push_back(world.CreateBody({
+                .Shape = Nova::PhysicsShape::MakeBox({BRICK_HALF_SIZE, BRICK_HALF_SIZE}),
+                .Transform = {position, 0.0f},
+            }));
+        }
+    }
+
+    // past the pyramid, falling from different heights into a pit, so nothing rolls into the rest
+    const glm::vec2 triangle[] = {{0.0f, 0.0f}, {30.0f, 0.0f}, {15.0f, -25.0f}};
+    const float rainX = pyramidX + height * 25.0f + 100.0f;
+    const float rainWidth = stacks * 2 * 25.0f + 30.0f;
+
+    for (float wallX : {rainX - 30.0f, rainX + rainWidth + 30.0f})
+    {
+        world.CreateBody({
+            .Type = Nova::PhysicsBodyType::Static,
+            .Shape = Nova::PhysicsShape::MakeBox({10.0f, 100.0f}),
+            .Transform = {{wallX, GROUND_TOP - 100.0f}, 0.0f},
+        });
+    }
+
+    for (uint32_t i = 0; i < stacks * 2; ++i)
+    {
+        scene.Rain.push_back(world.CreateBody({
+            .Shape = Nova::PhysicsShape::MakeCircle(8.0f),
+            .Transform = {{rainX + i * 17.0f, 100.0f - (i % 5) * 40.0f}, 0.0f},
+            .Restitution = 0.3f,
+        }));
+
+        scene.Rain.push_back(world.CreateBody({
+            .Shape = Nova::PhysicsShape::MakePolygon(triangle),
+            .Transform = {{rainX + i * 25.0f, (i % 7) * -30.0f}, 0.3f * i},
+        }));
+    }
+}
+
+static uint32_t CheckStanding(const Playground& scene, uint32_t stacks, uint32_t height)
+{
+    const float slop = scene.World.GetConfig().LinearSlop;
+    uint32_t failures = 0;
+
+    for (uint32_t stack = 0; stack < stacks; ++stack)
+    {
+        for (uint32_t i = 0; i < height; ++i)
+        {
+            const Nova::PhysicsTransform transform = scene.World.GetTransform(scene.Stacks[stack * height + i]);
+            const glm::vec2 expected = {GetStackX(stack), GROUND_TOP - BOX_HALF_SIZE - i * BOX_HALF_SIZE * 2.0f};
+            const float tolerance = POSITION_TOLERANCE + (i + 1) * slop;
+
+            if (std::abs(transform.Position.x - expected.x) > tolerance ||
+                std::abs(transform.Position.y - expected.y) > tolerance ||
+                std::abs(transform.Angle) > ANGLE_TOLERANCE)
+            {
+                fmt::print("box {} of stack {} is at ({:.2f}, {:.2f}) turned by {:.4f}, ({:.2f}, {:.2f}) expected\n", i,
+                           stack, transform.Position.x, transform.Position.y, transform.Angle, expected.x, expected.y);
+                ++failures;
+            }
+        }
+    }
+
+    // only the height of the top brick, the rows spread a little as they settle
+    const Nova::PhysicsTransform top = scene.World.GetTransform(scene.Pyramid.back());
+    const float expectedTop = GROUND_TOP - BRICK_HALF_SIZE - (height - 1) * BRICK_HALF_SIZE * 2.0f;
+
+    if (std::abs(top.Position.y - expectedTop) > POSITION_TOLERANCE + height * slop ||
+        std::abs(top.Angle) > ANGLE_TOLERANCE)
+    {
+        fmt::print("top of the pyramid is at y {:.2f} turned by {:.4f}, {:.2f} expected\n", top.Position.y, top.Angle,
+                   expectedTop);
+        ++failures;
+    }
+
+    for (Nova::PhysicsBodyID body : scene.Rain)
+    {
+        if (scene.World.GetTransform(body).Position.y > GROUND_TOP)
+        {
+            fmt::print("body {} fell through the ground\n", body);
+            ++failures;
+        }
+    }
+
+    return failures;
+}
+
+static RunResult Run(uint32_t stacks, uint32_t height, uint32_t frames)
+{
+    RunResult result;
+    Playground scene;
+    Build(scene, stacks, height);
+
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        Timer timer;
+        result.Steps += scene.World.Update(1.0f / 60.0f);
+        result.StepTime += timer.Elapsed();
+    }
+
+    const Nova::PhysicsStats stats = scene.World.GetStats();
+    fmt::print("{} bodies, {} awake, {} contacts, {} islands after {} frames\n", stats.Bodies, stats.AwakeBodies,
+               stats.Contacts, stats.Islands, frames);
+
+    result.Failures += CheckStanding(scene, stacks, height);
+
+    if (stats.AwakeBodies > 0)
+    {
+        fmt::print("{} bodies still awake\n", stats.AwakeBodies);
+        ++result.Failures;
+    }
+
+    // pulling the bottom box out of the first stack drops the rest of it by one box
+    const Nova::PhysicsBodyID removed = scene.Stacks[0];
+    scene.World.DestroyBody(removed);
+    scene.World.Update(1.0f / 60.0f);
+
+    if (height > 1 && !scene.World.IsAwake(scene.Stacks[1]))
+    {
+        fmt::print("the box on a destroyed one didn't wake up\n");
+        ++result.Failures;
+    }
+
+    for (uint32_t frame = 0; frame < 120; ++frame)
+        scene.World.Update(1.0f / 60.0f);
+
+    if (height > 1)
+    {
+        const float y = scene.World.GetTransform(scene.Stacks[1]).Position.y;
+        const float expected = GROUND_TOP - BOX_HALF_SIZE;
+
+        if (std::abs(y - expected) > POSITION_TOLERANCE + scene.World.GetConfig().LinearSlop)
+        {
+            fmt::print("box on the destroyed one fell to y {:.2f}, {:.2f} expected\n", y, expected);
+            ++result.Failures;
+        }
+    }
+
+    // the freed ID goes to the next body, which starts out clean
+    const glm::vec2 dropPosition = {GetStackX(0), GROUND_TOP - 300.0f};
+    const Nova::PhysicsBodyID reused = scene.World.CreateBody({
+        .Shape = Nova::PhysicsShape::MakeCircle(8.0f),
+        .Transform = {dropPosition, 0.0f},
+    });
+
+    if (reused != removed)
+    {
+        fmt::print("body {} was created after destroying {}, the ID wasn't reused\n", reused, removed);
+        ++result.Failures;
+    }
+
+    const Nova::PhysicsTransform start = scene.World.GetTransform(reused);
+
+    if (start.Position != dropPosition || scene.World.GetLinearVelocity(reused) != glm::vec2(0.0f) ||
+        !scene.World.IsAwake(reused) || scene.World.GetType(reused) != Nova::PhysicsBodyType::Dynamic)
+    {
+        fmt::print("body {} kept some state of the destroyed one\n", reused);
+        ++result.Failures;
+    }
+
+    scene.World.Update(1.0f / 60.0f);
+
+    if (!(scene.World.GetTransform(reused).Position.y > dropPosition.y))
+    {
+        fmt::print("reused body {} doesn't fall\n", reused);
+        ++result.Failures;
+    }
+
+    // the ground, the walls and everything else Build made, with the reused ID in place of the destroyed box
+    const uint32_t bodyCount = (uint32_t) (3 + scene.Stacks.size() + scene.Pyramid.size() + scene.Rain.size());
+
+    for (Nova::PhysicsBodyID body = 0; body < bodyCount; ++body)
+        result.Transforms.push_back(scene.World.GetTransform(body));
+
+    return result;
+}
+
+static bool IsSame(const Nova::PhysicsTransform& lhs, const Nova::PhysicsTransform& rhs)
+{
+    return lhs.Position == rhs.Position && lhs.Angle == rhs.Angle;
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t stacks = 20;
+    uint32_t height = 10;
+    uint32_t frames = 600;
+    int workers = -1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "--stacks" && i + 1 < argc)
+            stacks = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--height" && i + 1 < argc)
+            height = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--frames" && i + 1 < argc)
+            frames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--workers" && i + 1 < argc)
+            workers = std::max(0, std::atoi(argv[++i]));
+        else
+        {
+            fmt::print("Usage: {} [--stacks count] [--height boxes] [--frames count] [--workers count]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    fmt::print("{} stacks of {} boxes, {} frames\n\n", stacks, height, frames);
+
+    // without workers the islands are solved on the main thread
+    fmt::print("main thread:\n");
+    const RunResult serial = Run(stacks, height, frames);
+
+    if (workers != 0)
+        Nova::JobSystem::Init(workers < 0 ? 0 : workers);
+
+    fmt::print("\n{} workers:\n", Nova::JobSystem::GetWorkerCount());
+    const RunResult parallel = Run(stacks, height, frames);
+
+    uint32_t failures = serial.Failures + parallel.Failures;
+
+    const bool same = serial.Transforms.size() == parallel.Transforms.size() &&
+                      std::equal(serial.Transforms.begin(), serial.Transforms.end(), parallel.Transforms.begin(),
+                                 IsSame);
+
+    if (!same)
+    {
+        fmt::print("\nthe runs on the main thread and on the workers ended differently\n");
+        ++failures;
+    }
+
+    fmt::print("\n{:<16} {:>8.3f} ms per step\n", "Main thread", serial.StepTime / std::max(serial.Steps, 1u));
+    fmt::print("{:<16} {:>8.3f} ms per step\n", "Job system", parallel.StepTime / std::max(parallel.Steps, 1u));
+
+    if (failures > 0)
+        fmt::print("\n{} checks failed\n", failures);
+
+    Nova::JobSystem::Shutdown();
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+/*
+    nova_replay
+
+    Plays back a render capture (see Nova/Renderer/RenderCapture.hpp) as fast as possible and reports
+    frame times, draw calls and the vertex data sent to the GPU, so renderer changes can be compared on real
+    workloads.
+
+    Usage: nova_replay <capture file> [loops]
+*/
+
+#include <Nova/Core/Window.hpp>
+#include <Nova/Renderer/Renderer.hpp>
+#include <Nova/Renderer/RenderCapture.hpp>
+#include <Nova/Misc/Logger.hpp>
+#include <Nova/Misc/Metrics.hpp>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fmt::print("Usage: {} <capture file> [loops]\n", argv[0]);
+        return 1;
+    }
+
+    int loops = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 1;
+
+    if (!glfwInit())
+    {
+        Nova::Logger::Error("Failed to initialize GLFW");
+        return 1;
+    }
+
+    Nova::Window window;
+    window.Init({.Flags = Nova::WindowFlags_None, .Width = 1280, .Height = 720, .Title = "nova_replay"});
+
+    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress))
+    {
+        Nova::Logger::Error("Failed to initialize GLAD");
+        return 1;
+    }
+
+    glfwSwapInterval(0);
+
+    Nova::Renderer::Init(window.GetWidth(), window.GetHeight());
+
+    int exitCode = 0;
+
+    {
+        Nova::RenderReplay replay;
+
+        if (replay.Load(argv[1]))
+        {
+            if (replay.GetWidth() > 0 && replay.GetHeight() > 0)
+                Nova::Renderer::UpdateProjection(replay.GetWidth(), replay.GetHeight());
+
+            std::vector<double> frameTimes;
+            uint64_t drawCalls = 0;
+            uint64_t drawnObjects = 0;
+            uint64_t vertexBytes = 0;
+
+            frameTimes.reserve((size_t) replay.GetFrameCount() * loops);
+
+            for (int loop = 0; loop < loops && !window.ShouldClose(); ++loop)
+            {
+                for (uint32_t i = 0; i < replay.GetFrameCount() && !window.ShouldClose(); ++i)
+                {
+                    Nova::Metrics::NewFrame();
+
+                    auto start = std::chrono::steady_clock::now();
+
+                    Nova::Renderer::BeginFrame();
+                    replay.PlayFrame(i);
+                    Nova::Renderer::EndFrame();
+                    glFinish();
+
+                    auto end = std::chrono::steady_clock::now();
+
+                    frameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+                    drawCalls += Nova::Metrics::GetDrawCalls();
+                    drawnObjects += Nova::Metrics::GetDrawnObjects();
+                    vertexBytes += Nova::Metrics::GetVertexBytes();
+
+                    window.SwapBuffers();
+                    glfwPollEvents();
+                }
+            }
+
+            if (!frameTimes.empty())
+            {
+                std::vector<double> sorted = frameTimes;
+                std::sort(std::begin(sorted), std::end(sorted));
+
+                double total = 0.0;
+                for (double time : frameTimes)
+                    total += time;
+
+                size_t count = frameTimes.size();
+
+                fmt::print("frames:          {}\n", count);
+                fmt::print("frame time avg:  {:.3f} ms\n", total / count);
+                fmt::print("frame time min:  {:.3f} ms\n", sorted.front());
+                fmt::print("frame time p50:  {:.3f} ms\n", sorted[count / 2]);
+                fmt::print("frame time p99:  {:.3f} ms\n", sorted[std::min(count - 1, count * 99 / 100)]);
+                fmt::print("frame time max:  {:.3f} ms\n", sorted.back());
+                fmt::print("draw calls avg:  {:.1f}\n", (double) drawCalls / count);
+                fmt::print("quads avg:       {:.1f}\n", (double) drawnObjects / count);
+                fmt::print("vertex data avg: {:.1f} KiB\n", (double) vertexBytes / count / 1024.0);
+            }
+        }
+        else
+            exitCode = 1;
+    }
+
+    Nova::Renderer::Shutdown();
+    window.Shutdown();
+    glfwTerminate();
+
+    return exitCode;
+}
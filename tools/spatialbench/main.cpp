@@ -0,0 +1,389 @@
+/*
+    nova_spatialbench
+
+    Moves many boxes around a square world and times the SpatialHash over the frames: moving every box in the index,
+    box, circle and ray queries, and finding the overlapping pairs. The pairs are also found with a sort and sweep over
+    every box, which is the reference the results are checked against, and a linear scan checks a few box and circle
+    queries and raycasts (the closest hit and its distance).
+
+    Usage: nova_spatialbench [--count boxes] [--frames count] [--cell size] [--queries count] [--workers count]
+
+    --count boxes       moving boxes, from 8 to 24 units wide (100000 by default)
+    --frames count      frames per run, the averages are reported (100 by default)
+    --cell size         cell size of the hash (64 by default)
+    --queries count     box, circle and ray queries of each kind per frame (1000 by default)
+    --workers count     job system workers, 0 runs everything on the main thread (one per core by default)
+*/
+
+#include <Nova/Core/JobSystem.hpp>
+#include <Nova/Physics/SpatialHash.hpp>
+
+#include <fmt/core.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <vector>
+
+struct Box
+{
+    glm::vec2 Min;
+    glm::vec2 Size;
+    glm::vec2 Velocity;
+};
+
+struct Timer
+{
+    std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+    double Elapsed() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+    }
+};
+
+static bool Overlaps(const Box& a, const Box& b)
+{
+    return a.Min.x <= b.Min.x + b.Size.x && b.Min.x <= a.Min.x + a.Size.x && a.Min.y <= b.Min.y + b.Size.y &&
+           b.Min.y <= a.Min.y + a.Size.y;
+}
+
+static bool OverlapsCircle(const Box& box, const glm::vec2& center, float radius)
+{
+    const float dx = center.x - std::clamp(center.x, box.Min.x, box.Min.x + box.Size.x);
+    const float dy = center.y - std::clamp(center.y, box.Min.y, box.Min.y + box.Size.y);
+
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+// distance along the normalized direction to where the ray enters the box (0 from inside), infinity on a miss
+static float RayDistance(const Box& box, const glm::vec2& origin, const glm::vec2& direction)
+{
+    float enter = 0.0f;
+    float leave = std::numeric_limits<float>::infinity();
+
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        const float min = box.Min[axis];
+        const float max = box.Min[axis] + box.Size[axis];
+
+        if (direction[axis] == 0.0f)
+        {
+            if (origin[axis] < min || origin[axis] > max)
+                return std::numeric_limits<float>::infinity();
+
+            continue;
+        }
+
+        const float t0 = (min - origin[axis]) / direction[axis];
+        const float t1 = (max - origin[axis]) / direction[axis];
+        enter = std::max(enter, std::min(t0, t1));
+        leave = std::min(leave, std::max(t0, t1));
+    }
+
+    return enter <= leave ? enter : std::numeric_limits<float>::infinity();
+}
+
+// pairs as (lower, higher) index, sorted, so different methods can be compared
+static void Normalize(std::vector<Nova::SpatialPair>& pairs)
+{
+    for (Nova::SpatialPair& pair : pairs)
+    {
+        if (pair.A > pair.B)
+            std::swap(pair.A, pair.B);
+    }
+
+    std::sort(pairs.begin(), pairs.end(), [](const Nova::SpatialPair& lhs, const Nova::SpatialPair& rhs) {
+        return (lhs.A != rhs.A) ? lhs.A < rhs.A : lhs.B < rhs.B;
+    });
+}
+
+static void SortAndSweep(const std::vector<Box>& boxes, std::vector<uint32_t>& order,
+                         std::vector<Nova::SpatialPair>& pairs)
+{
+    std::sort(order.begin(), order.end(), [&boxes](uint32_t lhs, uint32_t rhs) {
+        return boxes[lhs].Min.x < boxes[rhs].Min.x;
+    });
+
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const Box& a = boxes[order[i]];
+        const float maxX = a.Min.x + a.Size.x;
+
+        for (size_t j = i + 1; j < order.size() && boxes[order[j]].Min.x <= maxX; ++j)
+        {
+            if (Overlaps(a, boxes[order[j]]))
+                pairs.push_back({order[i], order[j]});
+        }
+    }
+}
+
+static void PrintResult(std::string_view name, double ms, double count, std::string_view unit)
+{
+    fmt::print("{:<24} {:>8.3f} ms {:>10.2f} M{}/s\n", name, ms, count / (ms * 1000.0), unit);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t count = 100000;
+    uint32_t frames = 100;
+    float cellSize = 64.0f;
+    uint32_t queries = 1000;
+    int workers = -1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "--count" && i + 1 < argc)
+            count = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--frames" && i + 1 < argc)
+            frames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--cell" && i + 1 < argc)
+            cellSize = std::max(1.0f, (float) std::atof(argv[++i]));
+        else if (arg == "--queries" && i + 1 < argc)
+            queries = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--workers" && i + 1 < argc)
+            workers = std::max(0, std::atoi(argv[++i]));
+        else
+        {
+            fmt::print("Usage: {} [--count boxes] [--frames count] [--cell size] [--queries count] "
+                       "[--workers count]\n",
+                       argv[0]);
+            return 1;
+        }
+    }
+
+    if (workers != 0)
+        Nova::JobSystem::Init(workers < 0 ? 0 : workers);
+
+    // about one box per 40x40 units
+    const float worldSize = std::sqrt((float) count) * 40.0f;
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(0.0f, worldSize);
+    std::uniform_real_distribution<float> size(8.0f, 24.0f);
+    std::uniform_real_distribution<float> velocity(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    std::vector<Box> boxes(count);
+    std::vector<Nova::SpatialProxy> proxies(count);
+
+    Nova::SpatialHash hash(cellSize);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        boxes[i].Min = {position(random), position(random)};
+        boxes[i].Size = {size(random), size(random)};
+        boxes[i].Velocity = {velocity(random), velocity(random)};
+        proxies[i] = hash.Insert(boxes[i].Min, boxes[i].Min + boxes[i].Size, i);
+    }
+
+    std::vector<uint32_t> order(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+        order[i] = i;
+
+    double moveTime = 0.0;
+    double boxTime = 0.0;
+    double circleTime = 0.0;
+    double rayTime = 0.0;
+    double pairTime = 0.0;
+    double sweepTime = 0.0;
+    uint64_t pairCount = 0;
+    uint32_t mismatches = 0;
+
+    std::vector<uint32_t> result;
+    std::vector<Nova::SpatialPair> pairs;
+    std::vector<Nova::SpatialPair> reference;
+
+    fmt::print("{} boxes in a {:.0f}x{:.0f} world, cell size {}, {} frames, {} workers\n\n", count, worldSize,
+               worldSize, cellSize, frames, Nova::JobSystem::GetWorkerCount());
+
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        Timer moveTimer;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Box& box = boxes[i];
+            box.Min += box.Velocity;
+
+            // bounce off the edges of the world
+            for (int axis = 0; axis < 2; ++axis)
+            {
+                if (box.Min[axis] < 0.0f || box.Min[axis] + box.Size[axis] > worldSize)
+                    box.Velocity[axis] = -box.Velocity[axis];
+            }
+
+            hash.Move(proxies[i], box.Min, box.Min + box.Size);
+        }
+
+        moveTime += moveTimer.Elapsed();
+
+        // seeded by frame, so every run makes the same queries
+        std::mt19937 queryRandom(frame);
+        uint64_t found = 0;
+
+        Timer boxTimer;
+
+        for (uint32_t i = 0; i < queries; ++i)
+        {
+            const glm::vec2 min = {position(queryRandom), position(queryRandom)};
+            result.clear();
+            hash.QueryAABB(min, min + 128.0f, result);
+            found += result.size();
+        }
+
+        boxTime += boxTimer.Elapsed();
+
+        Timer circleTimer;
+
+        for (uint32_t i = 0; i < queries; ++i)
+        {
+            result.clear();
+            hash.QueryCircle({position(queryRandom), position(queryRandom)}, 64.0f, result);
+            found += result.size();
+        }
+
+        circleTime += circleTimer.Elapsed();
+
+        Timer rayTimer;
+
+        for (uint32_t i = 0; i < queries; ++i)
+        {
+            const float direction = angle(queryRandom);
+            Nova::SpatialRaycastHit hit;
+
+            if (hash.Raycast({position(queryRandom), position(queryRandom)},
+                             {std::cos(direction), std::sin(direction)}, 512.0f, hit))
+                ++found;
+        }
+
+        rayTime += rayTimer.Elapsed();
+
+        Timer pairTimer;
+        pairs.clear();
+        hash.FindPairs(pairs);
+        pairTime += pairTimer.Elapsed();
+        pairCount += pairs.size();
+
+        Timer sweepTimer;
+        reference.clear();
+        SortAndSweep(boxes, order, reference);
+        sweepTime += sweepTimer.Elapsed();
+
+        // keeps the queries from being optimized away
+        if (found == UINT64_MAX)
+            fmt::print("{}\n", found);
+
+        // checking is slower than all of the above, only some frames
+        if (frame % 25 != 0 && frame != frames - 1)
+            continue;
+
+        Normalize(pairs);
+        Normalize(reference);
+
+        const bool samePairs = pairs.size() == reference.size() &&
+                               std::equal(pairs.begin(), pairs.end(), reference.begin(),
+                                          [](const Nova::SpatialPair& lhs, const Nova::SpatialPair& rhs) {
+                                              return lhs.A == rhs.A && lhs.B == rhs.B;
+                                          });
+
+        if (!samePairs)
+        {
+            fmt::print("frame {}: {} pairs, {} expected\n", frame, pairs.size(), reference.size());
+            ++mismatches;
+        }
+
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            const Box query = {{position(queryRandom), position(queryRandom)}, {200.0f, 200.0f}, {}};
+
+            result.clear();
+            hash.QueryAABB(query.Min, query.Min + query.Size, result);
+
+            uint32_t expected = 0;
+
+            for (const Box& box : boxes)
+                expected += Overlaps(box, query) ? 1 : 0;
+
+            if (result.size() != expected)
+            {
+                fmt::print("frame {}: box query found {} boxes, {} expected\n", frame, result.size(), expected);
+                ++mismatches;
+            }
+        }
+
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            const glm::vec2 center = {position(queryRandom), position(queryRandom)};
+
+            result.clear();
+            hash.QueryCircle(center, 100.0f, result);
+
+            uint32_t expected = 0;
+
+            for (const Box& box : boxes)
+                expected += OverlapsCircle(box, center, 100.0f) ? 1 : 0;
+
+            if (result.size() != expected)
+            {
+                fmt::print("frame {}: circle query found {} boxes, {} expected\n", frame, result.size(), expected);
+                ++mismatches;
+            }
+        }
+
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            const glm::vec2 origin = {position(queryRandom), position(queryRandom)};
+            const float direction = angle(queryRandom);
+
+            // axis aligned rays too, they skip the slab division on one axis
+            glm::vec2 normal = {std::cos(direction), std::sin(direction)};
+
+            if (i % 4 == 0)
+                normal = (i % 8 == 0) ? glm::vec2(1.0f, 0.0f) : glm::vec2(0.0f, -1.0f);
+
+            float expected = std::numeric_limits<float>::infinity();
+
+            for (const Box& box : boxes)
+                expected = std::min(expected, RayDistance(box, origin, normal));
+
+            Nova::SpatialRaycastHit hit;
+            const bool found = hash.Raycast(origin, normal, 512.0f, hit);
+            const bool expectedFound = expected <= 512.0f;
+
+            // ties can report either box, but the reported one has to be at the closest distance
+            const bool sameHit = found && expectedFound && hit.UserData < count &&
+                                 std::abs(hit.Distance - expected) <= 1e-3f &&
+                                 std::abs(RayDistance(boxes[hit.UserData], origin, normal) - expected) <= 1e-3f;
+
+            if (found != expectedFound || (found && !sameHit))
+            {
+                fmt::print("frame {}: ray hit at {}, {} expected\n", frame, found ? hit.Distance : -1.0f,
+                           expectedFound ? expected : -1.0f);
+                ++mismatches;
+            }
+        }
+    }
+
+    fmt::print("{:.1f} pairs per frame, {} cells\n\n", (double) pairCount / frames, hash.GetCellCount());
+
+    PrintResult("Move", moveTime / frames, count, "boxes");
+    PrintResult("QueryAABB (128x128)", boxTime / frames, queries, "queries");
+    PrintResult("QueryCircle (r = 64)", circleTime / frames, queries, "queries");
+    PrintResult("Raycast (512)", rayTime / frames, queries, "rays");
+    PrintResult("FindPairs", pairTime / frames, count, "boxes");
+    PrintResult("Sort and sweep", sweepTime / frames, count, "boxes");
+
+    if (mismatches > 0)
+        fmt::print("\n{} checks didn't match the reference\n", mismatches);
+
+    Nova::JobSystem::Shutdown();
+
+    return mismatches > 0 ? 1 : 0;
+}
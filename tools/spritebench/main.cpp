@@ -0,0 +1,147 @@
+/*
+    nova_spritebench
+
+    Times the animation update of many sprites: Sprite (the per entity SpriteComponent), SpriteSheet::Update called
+    on each SpriteInstance, and the SpriteSheet::UpdateInstances batch kernel on the calling thread and split across
+    the job system like SpriteSystem does. Timers start staggered so frames advance every update.
+
+    Usage: nova_spritebench [--count sprites] [--frames count] [--workers count]
+
+    --count sprites     animated sprites (100000 by default)
+    --frames count      updates per run, the average is reported (200 by default)
+    --workers count     job system workers, 0 runs everything on the main thread (one per core by default)
+*/
+
+#include <Nova/Core/JobSystem.hpp>
+#include <Nova/Renderer/Sprite.hpp>
+#include <Nova/Renderer/SpriteSheet.hpp>
+
+#include <fmt/core.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+static constexpr float FRAME_TIME = 1.0f / 60.0f;
+
+// average milliseconds of update over frames
+template<typename Fn>
+static double Time(uint32_t frames, Fn&& update)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < frames; ++i)
+        update(FRAME_TIME);
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+static void PrintResult(std::string_view name, double ms, uint32_t count)
+{
+    fmt::print("{:<28} {:>8.3f} ms {:>10.1f} Msprites/s\n", name, ms, count / (ms * 1000.0));
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t count = 100000;
+    uint32_t frames = 200;
+    int workers = -1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "--count" && i + 1 < argc)
+            count = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--frames" && i + 1 < argc)
+            frames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--workers" && i + 1 < argc)
+            workers = std::max(0, std::atoi(argv[++i]));
+        else
+        {
+            fmt::print("Usage: {} [--count sprites] [--frames count] [--workers count]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (workers != 0)
+        Nova::JobSystem::Init(workers < 0 ? 0 : workers);
+
+    const Nova::SpriteConfig config = {
+        .FrameWidth = 32,
+        .FrameHeight = 32,
+        .NumCols = 8,
+        .NumRows = 4,
+        .AnimationTick = 0.1f,
+    };
+
+    static constexpr std::array<uint32_t, 8> walk = {0, 1, 2, 3, 4, 5, 6, 7};
+    static constexpr std::array<uint32_t, 4> idle = {8, 9, 10, 11};
+
+    // SpriteComponent
+    std::vector<Nova::Sprite> sprites(count, Nova::Sprite(config));
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sprites[i].AddAnimation("walk", walk);
+        sprites[i].AddAnimation("idle", idle);
+        sprites[i].PlayAnimation((i % 2) ? "walk" : "idle");
+    }
+
+    // SpriteInstance
+    Nova::SpriteSheet sheet(config);
+    const Nova::SpriteClipID clips[] = {sheet.AddClip("idle", idle), sheet.AddClip("walk", walk)};
+
+    std::vector<Nova::SpriteInstance> instances(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        instances[i].Sheet = &sheet;
+        sheet.Play(instances[i], clips[i % 2]);
+        instances[i].Timer = 0.1f * (float) (i % 64) / 64.0f;
+    }
+
+    std::vector<Nova::SpriteInstance> scalar = instances;
+    std::vector<Nova::SpriteInstance> batched = instances;
+    std::vector<Nova::SpriteInstance> parallel = instances;
+
+    fmt::print("{} sprites, {} frames, {} workers\n\n", count, frames, Nova::JobSystem::GetWorkerCount());
+
+    PrintResult("Sprite::Update", Time(frames, [&](float dt) {
+        for (Nova::Sprite& sprite : sprites)
+            sprite.Update(dt);
+    }), count);
+
+    PrintResult("SpriteSheet::Update", Time(frames, [&](float dt) {
+        for (Nova::SpriteInstance& instance : scalar)
+            instance.Sheet->Update(instance, dt);
+    }), count);
+
+    PrintResult("UpdateInstances", Time(frames, [&](float dt) {
+        Nova::SpriteSheet::UpdateInstances(batched.data(), count, dt);
+    }), count);
+
+    PrintResult("UpdateInstances (parallel)", Time(frames, [&](float dt) {
+        Nova::JobSystem::ParallelFor(count, 8192, [&](uint32_t begin, uint32_t end) {
+            Nova::SpriteSheet::UpdateInstances(parallel.data() + begin, end - begin, dt);
+        });
+    }), count);
+
+    // every path has to land on the same frames
+    uint32_t mismatches = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (batched[i].Frame != scalar[i].Frame || parallel[i].Frame != scalar[i].Frame)
+            ++mismatches;
+    }
+
+    if (mismatches > 0)
+        fmt::print("\n{} sprites ended on a different frame than SpriteSheet::Update\n", mismatches);
+
+    Nova::JobSystem::Shutdown();
+
+    return mismatches > 0 ? 1 : 0;
+}
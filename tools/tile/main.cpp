@@ -0,0 +1,206 @@
+/*
+    nova_tile
+
+    Cuts an image into a .nvt tiled texture (see Nova/Renderer/TiledTexture.hpp) for Nova::VirtualTexture, with
+    a chain of halved levels down to one that fits in a single tile. The image can be larger than GL_MAX_TEXTURE_SIZE,
+    it only has to fit in memory while it's being cut.
+
+    Usage: nova_tile image [-o output] [--tile-size size]
+
+    -o output           where to write the tiled texture (the image with a .nvt extension by default)
+    --tile-size size    side of a tile in texels, without the border (128 by default)
+*/
+
+#include <Nova/Renderer/TiledTexture.hpp>
+
+#include <fmt/core.h>
+#include <stb_image.h>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct Image
+{
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    std::vector<uint8_t> Pixels; // RGBA8
+};
+
+// 2x2 box filter, the last row and column of odd sizes are averaged with themselves
+static Image Downsample(const Image& source)
+{
+    Image result;
+    result.Width = (source.Width + 1) / 2;
+    result.Height = (source.Height + 1) / 2;
+    result.Pixels.resize((size_t) result.Width * result.Height * 4);
+
+    for (uint32_t y = 0; y < result.Height; ++y)
+    {
+        const uint32_t y0 = std::min(y * 2, source.Height - 1);
+        const uint32_t y1 = std::min(y * 2 + 1, source.Height - 1);
+
+        for (uint32_t x = 0; x < result.Width; ++x)
+        {
+            const uint32_t x0 = std::min(x * 2, source.Width - 1);
+            const uint32_t x1 = std::min(x * 2 + 1, source.Width - 1);
+
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                const auto texel = [&](uint32_t tx, uint32_t ty) {
+                    return (uint32_t) source.Pixels[((size_t) ty * source.Width + tx) * 4 + c];
+                };
+
+                result.Pixels[((size_t) y * result.Width + x) * 4 + c] =
+                    (uint8_t) ((texel(x0, y0) + texel(x1, y0) + texel(x0, y1) + texel(x1, y1) + 2) / 4);
+            }
+        }
+    }
+
+    return result;
+}
+
+// the tile at (tileX, tileY) with its border, texels outside the image are clamped to the edge
+static void CopyTile(const Image& image, uint32_t tileSize, uint32_t tileX, uint32_t tileY, uint8_t* tile)
+{
+    const int32_t border = (int32_t) Nova::TILED_TEXTURE_BORDER;
+    const int32_t side = (int32_t) tileSize + 2 * border;
+
+    for (int32_t y = 0; y < side; ++y)
+    {
+        const int32_t sourceY = std::clamp((int32_t) (tileY * tileSize) + y - border, 0, (int32_t) image.Height - 1);
+
+        for (int32_t x = 0; x < side; ++x)
+        {
+            const int32_t sourceX =
+                std::clamp((int32_t) (tileX * tileSize) + x - border, 0, (int32_t) image.Width - 1);
+
+            const uint8_t* texel = &image.Pixels[((size_t) sourceY * image.Width + sourceX) * 4];
+            std::copy(texel, texel + 4, tile + ((size_t) y * side + x) * 4);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    fs::path input;
+    fs::path output;
+    uint32_t tileSize = 128;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+
+        if (arg == "-o" && i + 1 < argc)
+            output = argv[++i];
+        else if (arg == "--tile-size" && i + 1 < argc)
+            tileSize = (uint32_t) std::max(1, std::atoi(argv[++i]));
+        else if (arg.starts_with("-") || !input.empty())
+        {
+            fmt::print("Usage: {} image [-o output] [--tile-size size]\n", argv[0]);
+            return 1;
+        }
+        else
+            input = arg;
+    }
+
+    if (input.empty())
+    {
+        fmt::print("Usage: {} image [-o output] [--tile-size size]\n", argv[0]);
+        return 1;
+    }
+
+    if (output.empty())
+        output = fs::path(input).replace_extension(".nvt");
+
+    int width, height, channels;
+    uint8_t* pixels = stbi_load(input.string().c_str(), &width, &height, &channels, 4);
+
+    if (!pixels)
+    {
+        fmt::print("Failed to load {}: {}\n", input.string(), stbi_failure_reason());
+        return 1;
+    }
+
+    std::vector<Image> images(1);
+    images[0].Width = (uint32_t) width;
+    images[0].Height = (uint32_t) height;
+    images[0].Pixels.assign(pixels, pixels + (size_t) width * height * 4);
+    stbi_image_free(pixels);
+
+    while (images.back().Width > tileSize || images.back().Height > tileSize)
+    {
+        if (images.size() == Nova::TILED_TEXTURE_MAX_LEVELS)
+        {
+            fmt::print("{} needs more than {} levels, use a larger tile size\n", input.string(),
+                       Nova::TILED_TEXTURE_MAX_LEVELS);
+            return 1;
+        }
+
+        images.push_back(Downsample(images.back()));
+    }
+
+    std::vector<Nova::TiledTextureLevel> levels(images.size());
+    uint32_t tileCount = 0;
+
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        Nova::TiledTextureLevel& level = levels[i];
+        level.Width = images[i].Width;
+        level.Height = images[i].Height;
+        level.TilesX = (level.Width + tileSize - 1) / tileSize;
+        level.TilesY = (level.Height + tileSize - 1) / tileSize;
+        level.FirstTile = tileCount;
+
+        tileCount += level.TilesX * level.TilesY;
+    }
+
+    Nova::TiledTextureHeader header = {
+        .Magic = Nova::TILED_TEXTURE_MAGIC,
+        .Version = Nova::TILED_TEXTURE_VERSION,
+        .Width = (uint32_t) width,
+        .Height = (uint32_t) height,
+        .TileSize = tileSize,
+        .LevelCount = (uint32_t) levels.size(),
+    };
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+
+    if (!out.is_open())
+    {
+        fmt::print("Failed to open {} for writing\n", output.string());
+        return 1;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(levels.data()), levels.size() * sizeof(Nova::TiledTextureLevel));
+
+    std::vector<uint8_t> tile(Nova::GetTiledTextureTileBytes(tileSize));
+
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        for (uint32_t y = 0; y < levels[i].TilesY; ++y)
+        {
+            for (uint32_t x = 0; x < levels[i].TilesX; ++x)
+            {
+                CopyTile(images[i], tileSize, x, y, tile.data());
+                out.write(reinterpret_cast<const char*>(tile.data()), tile.size());
+            }
+        }
+    }
+
+    if (!out)
+    {
+        fmt::print("Failed to write {}\n", output.string());
+        return 1;
+    }
+
+    fmt::print("{} -> {} ({}x{}, {} levels, {} tiles of {}x{})\n", input.string(), output.string(), width, height,
+               levels.size(), tileCount, tileSize, tileSize);
+
+    return 0;
+}